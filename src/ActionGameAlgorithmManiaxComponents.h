@@ -6,58 +6,260 @@ I can't read Japanese well enough to know what kind of licensing they might have
 
 #pragma once
 
-unsigned short AGAM_MODULE_ID = 2;
+#include "FixedPoint.h"
+
+const unsigned short AGAM_MODULE_ID = 2;
 
 enum EAgamCompId : unsigned short {
     AGAM_COMP_ID_INVALID = 0,
     AGAM_COMP_ID_JUMP_MAN,
     AGAM_COMP_ID_LEVER_DASH_MAN,
+    AGAM_COMP_ID_BODY,
+};
+
+// Animation names the controllers switch between, hashed once at startup.
+namespace AgamAnim {
+    const AnimName s_jump("jump");
+    const AnimName s_jumpCrest("jump-crest");
+    const AnimName s_fall("fall");
+    const AnimName s_skid("skid");
+    const AnimName s_run("run");
+    const AnimName s_walk("walk");
+    const AnimName s_idle("idle");
+    const AnimName s_stand("stand");
+}
+
+
+//==============================================================================
+// Fixed-point position and velocity for the controllers below.  With a body
+// attached they run deterministically: each Update is exactly one
+// 1/s_tickRate step whatever dt says, motion math is all Fixed16, and the
+// Transform only receives a float copy for rendering and tile queries.
+//
+// That guarantee only covers runs without a bound level.  Tile collision
+// (LevelCollision::ProbeGround and MoveAndSlide) answers in float and is
+// quantized back, so with a level runs repeat bit-exactly on the same build
+// only; different compilers or FPU settings may diverge.  Drive the objects with a FixedStepRunner at
+// s_tickRate so sprite animation (and with it the frame size) is stepped by
+// the same dt each time.
+class GocAgamBody : public GameObjectComponent {
+public:
+    static const GlobalTypeId s_typeId   = AGAM_MODULE_ID << 16 | AGAM_COMP_ID_BODY;
+    static const unsigned     s_reads    = COMPONENT_DATA_AGAM_BODY;
+    static const unsigned     s_writes   = COMPONENT_DATA_AGAM_BODY;
+    static const unsigned     s_tickRate = 60;
+
+private: // Data
+    Fixed16 m_posX;
+    Fixed16 m_posY;
+    Fixed16 m_velX;
+    Fixed16 m_velY;
+    bool    m_initialized;
+
+public:
+    GocAgamBody () :
+        GameObjectComponent(s_typeId),
+        m_initialized(false)
+    {}
+
+    // Commands
+    // Quantizes the Transform's position and velocity into the body.  Done
+    // automatically the first time a controller steps.
+    void ResetFromTransform () {
+        const Transform & transform = m_owner->GetTransform();
+        m_posX        = Fixed16::FromFloat(transform.GetPosition().x);
+        m_posY        = Fixed16::FromFloat(transform.GetPosition().y);
+        m_velX        = Fixed16::FromFloat(transform.GetVelocity().x);
+        m_velY        = Fixed16::FromFloat(transform.GetVelocity().y);
+        m_initialized = true;
+        PublishToTransform();
+    }
+
+    void EnsureInitialized () {
+        if (!m_initialized)
+            ResetFromTransform();
+    }
+
+    void PublishToTransform () {
+        Transform & transform = m_owner->GetTransform();
+        transform.SetPosition(Vec3(m_posX.ToFloat(), m_posY.ToFloat(), transform.GetPosition().z));
+        transform.SetVelocity(m_velX.ToFloat(), m_velY.ToFloat());
+    }
+
+    void SetPosition (Fixed16 x, Fixed16 y) { m_posX = x; m_posY = y; }
+    void SetVelocity (Fixed16 x, Fixed16 y) { m_velX = x; m_velY = y; }
+
+    // Queries
+    Fixed16 GetPosX () const { return m_posX; }
+    Fixed16 GetPosY () const { return m_posY; }
+    Fixed16 GetVelX () const { return m_velX; }
+    Fixed16 GetVelY () const { return m_velY; }
+
+public: // GameObjectComponent
+    unsigned GetStateSize () const override { return 4 * sizeof(std::int64_t) + 1; }
+
+    void SaveState (void * state) const override {
+        const std::int64_t raw[] = { m_posX.GetRaw(), m_posY.GetRaw(), m_velX.GetRaw(), m_velY.GetRaw() };
+        memcpy(state, raw, sizeof(raw));
+        static_cast<unsigned char *>(state)[sizeof(raw)] = m_initialized;
+    }
+
+    void LoadState (const void * state) override {
+        std::int64_t raw[4];
+        memcpy(raw, state, sizeof(raw));
+        m_posX        = Fixed16::FromRaw(raw[0]);
+        m_posY        = Fixed16::FromRaw(raw[1]);
+        m_velX        = Fixed16::FromRaw(raw[2]);
+        m_velY        = Fixed16::FromRaw(raw[3]);
+        m_initialized = static_cast<const unsigned char *>(state)[sizeof(raw)] != 0;
+    }
+
+public:
+    // FNV-1a over the raw state; runs diverged iff their hashes differ.
+    unsigned GetStateHash () const {
+        const std::int64_t state[] = { m_posX.GetRaw(), m_posY.GetRaw(), m_velX.GetRaw(), m_velY.GetRaw() };
+
+        unsigned hash = 2166136261u;
+        for (unsigned i = 0; i < arrsize(state); ++i) {
+            for (unsigned shift = 0; shift < 64; shift += 8) {
+                hash ^= unsigned(std::uint64_t(state[i]) >> shift) & 0xff;
+                hash *= 16777619u;
+            }
+        }
+        return hash;
+    }
 };
 
 
 //==============================================================================
 // Based on ActionGame Algorithm Maniax "Jump" chapter.
 class GocJumpMan : public GameObjectComponent {
+public:
+    static const GlobalTypeId s_typeId = AGAM_MODULE_ID << 16 | AGAM_COMP_ID_JUMP_MAN;
+    static const unsigned     s_reads  =
+        COMPONENT_DATA_INPUT |
+        COMPONENT_DATA_TRANSFORM_SHAPE |
+        COMPONENT_DATA_LEVEL |
+        COMPONENT_DATA_AGAM_BODY;
+    static const unsigned     s_writes =
+        COMPONENT_DATA_TRANSFORM_POSITION |
+        COMPONENT_DATA_TRANSFORM_VELOCITY |
+        COMPONENT_DATA_SPRITE |
+        COMPONENT_DATA_JUMP_STATE |
+        COMPONENT_DATA_AGAM_BODY;
+
 private: // Data
-    float m_jumpSpeed;
-    bool  m_canJump;
-    bool  m_jumping;
+    float         m_jumpSpeed;
+    float         m_groundProbeDistance; // Ground this close below the feet is stood on
+    bool          m_canJump;
+    bool          m_jumping;
+    GocGamepad *  m_gamepad;
+    GocSprite *   m_spriteComp;
+    GocAgamBody * m_bodyComp;
+
+private: // Helpers
+    // Starts a jump if one was asked for and picks the airborne animation.
+    // Returns true if a jump started.
+    bool UpdateJump (bool falling, bool nearCrest) {
+        if (m_canJump) {
+            if (m_gamepad->AreButtonsPressed(GamepadState::BUTTON_A)) {
+                m_canJump = false;
+                m_jumping = true;
+                m_spriteComp->TrySetAnim(AgamAnim::s_jump, 0);
+                return true;
+            }
+        }
+        else if (falling && !IsJumping()) {
+            m_spriteComp->TrySetAnim(AgamAnim::s_fall, 0);
+        }
+        else if (nearCrest && IsJumping()) {
+            m_spriteComp->TrySetAnim(AgamAnim::s_jumpCrest, 0);
+        }
+        return false;
+    }
+
+    void Land () {
+        m_canJump = true;
+        m_jumping = false;
+        //m_spriteComp->TrySetAnim(L"land", 0);
+    }
 
+    void UpdateFixed () {
+        GocAgamBody & body = *m_bodyComp;
+        body.EnsureInitialized();
+
+        Fixed16       posY = body.GetPosY();
+        Fixed16       velY = body.GetVelY();
+        const Fixed16 zero;
+
+        if (UpdateJump(velY < zero, velY < Fixed16::FromRatio(1, 2)))
+            velY = Fixed16::FromFloat(m_jumpSpeed);
+
+        const LevelCollision * collision = LevelCollision::GetActive();
+        if (collision) {
+            float groundDistance;
+            if (velY <= zero && collision->ProbeGround(m_spriteComp->GetWorldRect(), m_groundProbeDistance, &groundDistance)) {
+                posY -= Fixed16::FromFloat(groundDistance);
+                velY  = zero;
+                Land();
+            }
+            else {
+                m_canJump = false;
+            }
+        }
+        else {
+            const Fixed16 floor = Fixed16::FromInt(int(m_spriteComp->GetCurrentFrame()->height));
+            if (posY <= floor) {
+                posY = floor;
+                if (velY <= zero) {
+                    velY = zero;
+                    Land();
+                }
+            }
+        }
+
+        body.SetPosition(body.GetPosX(), posY);
+        body.SetVelocity(body.GetVelX(), velY);
+        body.PublishToTransform();
+    }
+
+public: // GameObjectComponent
     void Update (float dt) {
 
         ref(dt);
 
-        GocGamepad * gamepad    = dynamic_cast<GocGamepad *>(m_owner->GetComponent(GOC_TYPE_GAMEPAD));
-        GocSprite *  spriteComp = dynamic_cast<GocSprite *>(m_owner->GetComponent(GOC_TYPE_SPRITE));
-        ASSERT(gamepad);
+        GocSprite * spriteComp = m_spriteComp;
+        ASSERT(m_gamepad);
         ASSERT(spriteComp);
 
+        if (m_bodyComp) {
+            UpdateFixed();
+            return;
+        }
+
         Vec3 pos = m_owner->GetTransform().GetPosition();
         Vec3 vel = m_owner->GetTransform().GetVelocity();
 
-        if (m_canJump) {
-            if (gamepad->AreButtonsPressed(XInputGamepad::BUTTON_FLAG_A)) {
+        if (UpdateJump(vel.y < 0.0f, vel.y < 0.5f))
+            vel.y = m_jumpSpeed;
+
+        const LevelCollision * collision = LevelCollision::GetActive();
+        if (collision) {
+            float groundDistance;
+            if (vel.y <= 0.0f && collision->ProbeGround(spriteComp->GetWorldRect(), m_groundProbeDistance, &groundDistance)) {
+                pos.y -= groundDistance;
+                vel.y  = 0.0f;
+                Land();
+            }
+            else {
                 m_canJump = false;
-                m_jumping = true;
-                vel.y     = m_jumpSpeed;
-                spriteComp->TrySetAnim(L"jump", 0);
             }
         }
-        else if (vel.y < 0.0f && !IsJumping()) {
-            spriteComp->TrySetAnim(L"fall", 0);
-        }
-        else if (vel.y < 0.5f && IsJumping()) {
-            spriteComp->TrySetAnim(L"jump-crest", 0);
-        }
-
-        const SpritesheetFrame * frame  = spriteComp->GetCurrentFrame();
-        if (pos.y <= frame->height) {
-            pos.y = frame->height;
+        else if (pos.y <= spriteComp->GetCurrentFrame()->height) {
+            pos.y = spriteComp->GetCurrentFrame()->height;
             if (vel.y <= 0.0f) {
                 vel.y = 0.0f;
-                m_canJump = true;
-                m_jumping = false;
-                //spriteComp->TrySetAnim(L"land", 0);
+                Land();
             }
         }
 
@@ -66,12 +268,34 @@ private: // Data
 
     }
 
+    unsigned GetStateSize () const override { return 2; }
+
+    void SaveState (void * state) const override {
+        static_cast<unsigned char *>(state)[0] = m_canJump;
+        static_cast<unsigned char *>(state)[1] = m_jumping;
+    }
+
+    void LoadState (const void * state) override {
+        m_canJump = static_cast<const unsigned char *>(state)[0] != 0;
+        m_jumping = static_cast<const unsigned char *>(state)[1] != 0;
+    }
+
+    void OnSiblingsChanged () override {
+        m_gamepad    = m_owner->GetComponent<GocGamepad>();
+        m_spriteComp = m_owner->GetComponent<GocSprite>();
+        m_bodyComp   = m_owner->GetComponent<GocAgamBody>();
+    }
+
 public:
     GocJumpMan () :
-        GameObjectComponent(AGAM_MODULE_ID, AGAM_COMP_ID_JUMP_MAN),
+        GameObjectComponent(s_typeId),
         m_jumpSpeed(4.0f),
+        m_groundProbeDistance(0.5f),
         m_canJump(false),
-        m_jumping(false)
+        m_jumping(false),
+        m_gamepad(nullptr),
+        m_spriteComp(nullptr),
+        m_bodyComp(nullptr)
     {}
 
     bool CanJump () const   { return m_canJump; }
@@ -83,44 +307,187 @@ public:
 //==============================================================================
 // Based on ActionGame Algorithm Maniax "Lever Dash Man" chapter.
 class GocLeverDashMan : public GameObjectComponent {
+public:
+    static const GlobalTypeId s_typeId = AGAM_MODULE_ID << 16 | AGAM_COMP_ID_LEVER_DASH_MAN;
+    static const unsigned     s_reads  =
+        COMPONENT_DATA_INPUT |
+        COMPONENT_DATA_JUMP_STATE |
+        COMPONENT_DATA_LEVEL |
+        COMPONENT_DATA_AGAM_BODY;
+    static const unsigned     s_writes =
+        COMPONENT_DATA_TRANSFORM_POSITION |
+        COMPONENT_DATA_TRANSFORM_VELOCITY |
+        COMPONENT_DATA_TRANSFORM_SHAPE |
+        COMPONENT_DATA_SPRITE |
+        COMPONENT_DATA_AGAM_BODY;
 
-    void Update (float dt) override {
+private: // Constants
+    // Speeds and accelerations were tuned as units per 60 Hz frame; they're
+    // scaled by elapsed frames so other tick rates cover the same distance.
+    static const unsigned s_tuningTickRate = 60;
 
-        {
-            Vec3 vel = m_owner->GetTransform().GetVelocity();
-            //vel.y -= 0.98f * dt;
-            vel.y -= 6.0f * dt;
-            m_owner->GetTransform().SetVelocity(vel);
+private: // Data
+    GocGamepad *  m_gamepadComp;
+    GocSprite *   m_spriteComp;
+    GocJumpMan *  m_jumpComp;
+    GocAgamBody * m_bodyComp;
+    unsigned      m_substepBudget;
+    float         m_maxSubstepDistance;
+
+private: // Helpers
+    unsigned CountSubsteps (float distance, const LevelCollision & collision) const {
+        const float maxStepDistance = m_maxSubstepDistance > 0.0f
+            ? m_maxSubstepDistance
+            : 0.5f * MIN(collision.GetCellWidth(), collision.GetCellHeight());
+
+        const unsigned substeps = unsigned(ceilf(distance / maxStepDistance));
+        return MAX(1u, MIN(substeps, m_substepBudget));
+    }
+
+    // Fixed-point version of the float lever logic in Update, one tick's worth.
+    Fixed16 StepVelocityXFixed (Fixed16 vx, float isx) const {
+        const Fixed16 zero;
+        const Fixed16 maxSpeed = Fixed16::FromInt(5);
+        const Fixed16 accel    = Fixed16::FromRatio(1, 10);
+
+        if (isx > 0.0f)
+            vx += accel;
+        else if (isx < 0.0f)
+            vx -= accel;
+        else {
+            if (vx > zero)
+                vx -= accel / 2;
+            else if (vx < zero)
+                vx += accel / 2;
         }
 
-        ref(dt);
+        if (vx.Abs() < Fixed16::FromRatio(1, 1000))
+            vx = zero;
+
+        return MAX(-maxSpeed, MIN(vx, maxSpeed));
+    }
+
+    void MoveFixed () {
+        GocAgamBody & body = *m_bodyComp;
+        Fixed16       posX = body.GetPosX();
+        Fixed16       posY = body.GetPosY();
+        Fixed16       velX = body.GetVelX();
+        Fixed16       velY = body.GetVelY();
+        const Fixed16 zero;
+        const Fixed16 gravity = Fixed16::FromRatio(1, 10); // 6 units/s per 60 Hz tick
+
+        const LevelCollision * collision = LevelCollision::GetActive();
+        if (!collision) {
+            velY -= gravity;
+            posX += velX;
+            posY += velY;
+
+            const Fixed16 floor = Fixed16::FromInt(int(m_spriteComp->GetCurrentFrame()->height));
+            if (posY < floor) {
+                posY = floor;
+                velY = zero;
+            }
+        }
+        else {
+            const Fixed16  distance = MAX(velX.Abs(), velY.Abs() + gravity);
+            const unsigned substeps = CountSubsteps(distance.ToFloat(), *collision);
+
+            WorldRect box = m_spriteComp->GetWorldRect();
+            for (unsigned step = 0; step < substeps; ++step) {
+                velY -= gravity / int(substeps);
+
+                LevelCollision::MoveResult move;
+                collision->MoveAndSlide(box, (velX / int(substeps)).ToFloat(), (velY / int(substeps)).ToFloat(), &move);
+
+                const Fixed16 dx = Fixed16::FromFloat(move.dx);
+                const Fixed16 dy = Fixed16::FromFloat(move.dy);
+                posX     += dx;
+                posY     += dy;
+                box.minX += dx.ToFloat();
+                box.maxX += dx.ToFloat();
+                box.minY += dy.ToFloat();
+                box.maxY += dy.ToFloat();
+                if (move.blockedX)
+                    velX = zero;
+                if (move.blockedY)
+                    velY = zero;
+            }
+        }
 
-        GocGamepad * gamepadComp = dynamic_cast<GocGamepad *>(m_owner->GetComponent(GOC_TYPE_GAMEPAD));
-        GocSprite *  spriteComp  = dynamic_cast<GocSprite *>(m_owner->GetComponent(GOC_TYPE_SPRITE));
+        body.SetPosition(posX, posY);
+        body.SetVelocity(velX, velY);
+        body.PublishToTransform();
+    }
+
+    // Integrates gravity and sweeps the sprite through the level in sub-steps
+    // short enough that the arc, not its chord, is what hits the tiles.
+    void MoveSwept (const LevelCollision & collision, float dt, Vec3 * posInOut, Vec3 * velInOut) const {
+
+        const float    frames   = dt * s_tuningTickRate;
+        const float    distance = MAX(fabsf(velInOut->x), fabsf(velInOut->y) + 6.0f * dt) * frames;
+        const unsigned substeps = CountSubsteps(distance, collision);
+
+        const float stepSeconds = dt / substeps;
+        const float stepFrames  = frames / substeps;
+        WorldRect   box         = m_spriteComp->GetWorldRect();
+        for (unsigned step = 0; step < substeps; ++step) {
+            velInOut->y -= 6.0f * stepSeconds;
+
+            LevelCollision::MoveResult move;
+            collision.MoveAndSlide(box, velInOut->x * stepFrames, velInOut->y * stepFrames, &move);
+            box.minX    += move.dx;
+            box.maxX    += move.dx;
+            box.minY    += move.dy;
+            box.maxY    += move.dy;
+            posInOut->x += move.dx;
+            posInOut->y += move.dy;
+            if (move.blockedX)
+                velInOut->x = 0.0f;
+            if (move.blockedY)
+                velInOut->y = 0.0f;
+        }
+
+    }
+
+public: // GameObjectComponent
+    void Update (float dt) override {
+
+        GocGamepad * gamepadComp = m_gamepadComp;
+        GocSprite *  spriteComp  = m_spriteComp;
         assert(gamepadComp);
         assert(spriteComp);
 
-        float isx       = gamepadComp->GetAnalogValueAsFloat(XInputGamepad::ANALOG_TYPE_LEFT_STICK_X);
+        const float frames = dt * s_tuningTickRate;
+
+        float isx       = gamepadComp->GetLeftStickXAsFloat();
         float vx        = m_owner->GetTransform().GetVelocity().x;
         float max_speed = 0.5f  * 10.0f;
-        float accel     = 0.01f * 10.0f;
-        
-        if (isx > 0.0f)
-            vx += accel;
-        else if (isx < 0.0f)
-            vx -= accel;
+        float accel     = 0.01f * 10.0f * frames;
+
+        if (m_bodyComp) {
+            m_bodyComp->EnsureInitialized();
+            const Fixed16 fixedVx = StepVelocityXFixed(m_bodyComp->GetVelX(), isx);
+            m_bodyComp->SetVelocity(fixedVx, m_bodyComp->GetVelY());
+            vx = fixedVx.ToFloat();
+        }
         else {
-            if (vx > 0.0f)
-                vx -= accel * 0.5f;
-            else if (vx < 0.0f)
-                vx += accel * 0.5f;
+            if (isx > 0.0f)
+                vx += accel;
+            else if (isx < 0.0f)
+                vx -= accel;
+            else {
+                if (vx > 0.0f)
+                    vx -= accel * 0.5f;
+                else if (vx < 0.0f)
+                    vx += accel * 0.5f;
+            }
+
+            if (fabs(vx) < 0.001f)
+                vx = 0.0f;
+
+            vx = MAX(-max_speed, MIN(vx, max_speed));
         }
             
-        if (fabs(vx) < 0.001f)
-            vx = 0.0f;
-            
-        vx = max(-max_speed, min(vx, max_speed));
-            
         float angle = vx / max_speed * 0.1f;
         
         
@@ -137,35 +504,48 @@ class GocLeverDashMan : public GameObjectComponent {
         
         m_owner->GetTransform().SetRotation(angle);
 
-        SpriteAnimation & sprite = spriteComp->GetSprite();
-        
         // Animation control
-        unsigned  oldIndex = sprite.GetAnimationIndex();
-        GocJumpMan * jumpComp = dynamic_cast<GocJumpMan * >(m_owner->GetComponent(AGAM_MODULE_ID << 16 | AGAM_COMP_ID_JUMP_MAN));
+        GocJumpMan * jumpComp = m_jumpComp;
         if (!jumpComp || jumpComp->CanJump()) {
             // Skidding
             if (fabs(vx) > max_speed * 0.5f && ((vx < 0.0f && isx > 0.0f) || (vx > 0.0f && isx < 0.0f))) {
-                spriteComp->TrySetAnim(L"skid", 0);
+                spriteComp->TrySetAnim(AgamAnim::s_skid, 0);
             }
-            else if (oldIndex == 7 && fabs(vx) > 0.05f)
-                spriteComp->TrySetAnim(L"skid", 0);
+            else if (spriteComp->IsAnim(AgamAnim::s_skid) && fabs(vx) > 0.05f)
+                spriteComp->TrySetAnim(AgamAnim::s_skid, 0);
             // Running
             else if (fabs(vx) > max_speed * 0.9f) {
-                spriteComp->TrySetAnim(L"run", 0) || spriteComp->TrySetAnim(L"walk", 0);
+                spriteComp->TrySetAnim(AgamAnim::s_run, 0) || spriteComp->TrySetAnim(AgamAnim::s_walk, 0);
             }
             // Walking
             else if (fabs(vx) > max_speed * 0.1f) {
-                spriteComp->TrySetAnim(L"walk", 0) || spriteComp->TrySetAnim(L"run", 0);
+                spriteComp->TrySetAnim(AgamAnim::s_walk, 0) || spriteComp->TrySetAnim(AgamAnim::s_run, 0);
             }
             else
-                spriteComp->TrySetAnim(L"idle", 0) || spriteComp->TrySetAnim(L"stand", 0);
+                spriteComp->TrySetAnim(AgamAnim::s_idle, 0) || spriteComp->TrySetAnim(AgamAnim::s_stand, 0);
+        }
+
+        if (m_bodyComp) {
+            MoveFixed();
+            return;
         }
 
         {
             Vec3 pos = m_owner->GetTransform().GetPosition();
             Vec3 vel = m_owner->GetTransform().GetVelocity();
-            pos.x += vel.x;
-            pos.y += vel.y;
+
+            const LevelCollision * collision = LevelCollision::GetActive();
+            if (collision) {
+                MoveSwept(*collision, dt, &pos, &vel);
+                m_owner->GetTransform().SetPosition(pos);
+                m_owner->GetTransform().SetVelocity(vel);
+                return;
+            }
+
+            //vel.y -= 0.98f * dt;
+            vel.y -= 6.0f * dt;
+            pos.x += vel.x * frames;
+            pos.y += vel.y * frames;
             
             const SpritesheetFrame * frame = spriteComp->GetCurrentFrame();
             ASSERT(frame);
@@ -181,8 +561,27 @@ class GocLeverDashMan : public GameObjectComponent {
 
     }
 
+    void OnSiblingsChanged () override {
+        m_gamepadComp = m_owner->GetComponent<GocGamepad>();
+        m_spriteComp  = m_owner->GetComponent<GocSprite>();
+        m_jumpComp    = m_owner->GetComponent<GocJumpMan>();
+        m_bodyComp    = m_owner->GetComponent<GocAgamBody>();
+    }
+
 public:
-    GocLeverDashMan () : GameObjectComponent(AGAM_MODULE_ID << 16 | AGAM_COMP_ID_LEVER_DASH_MAN)
+    GocLeverDashMan () :
+        GameObjectComponent(s_typeId),
+        m_gamepadComp(nullptr),
+        m_spriteComp(nullptr),
+        m_jumpComp(nullptr),
+        m_bodyComp(nullptr),
+        m_substepBudget(8),
+        m_maxSubstepDistance(0.0f)
     {}
 
+    // At most budget sub-steps per update, each moving at most distance; a
+    // distance of 0 means half a level tile.
+    void SetSubstepBudget (unsigned budget)        { m_substepBudget = budget ? budget : 1; }
+    void SetMaxSubstepDistance (float distance)    { m_maxSubstepDistance = distance; }
+
 };
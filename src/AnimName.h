@@ -0,0 +1,46 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Christopher Higgins Barrett
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+//==============================================================================
+// An interned animation name: the Djb2 hash of the name, plus the text for
+// the one time a sprite has to look it up in its sheet.  Declare these once
+// (at namespace scope, not per frame) and compare ids instead of strings.
+//
+// Hashed during static initialization rather than at compile time; the
+// toolchain has no constexpr.  The text must outlive the name, so build them
+// from literals.
+struct AnimName {
+    std::uint32_t id;
+    const char *  text;
+
+    explicit AnimName (const char * name) :
+        id(Core::Djb2Hash(name)),
+        text(name)
+    {}
+
+    bool operator== (const AnimName & rhs) const { return id == rhs.id; }
+    bool operator!= (const AnimName & rhs) const { return id != rhs.id; }
+};
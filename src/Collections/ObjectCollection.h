@@ -22,8 +22,18 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.
 */
 
+#pragma once
+
+#include <new>
+#include <type_traits>
+
 namespace CSaru {
 
+enum class EObjectStorage {
+    Pointer, // Collection stores caller-allocated objects and deletes them on Remove
+    InPlace, // Objects are constructed inside the collection's own slab via Emplace
+};
+
 struct IObjectCollection {
     struct Handle {
         unsigned index;
@@ -41,38 +51,102 @@ struct IObjectCollection {
 };
 
 
-template <typename T_ObjectType, unsigned T_Capacity, bool T_ObjectTypeIsPod = false>
+// Backing memory for EObjectStorage::InPlace; empty for Pointer storage.
+template <typename T_ObjectType, unsigned T_Capacity, EObjectStorage T_Storage>
+struct ObjectCollectionSlab {
+    void * SlotAt (unsigned) { return nullptr; }
+};
+
+template <typename T_ObjectType, unsigned T_Capacity>
+struct ObjectCollectionSlab<T_ObjectType, T_Capacity, EObjectStorage::InPlace> {
+    typename std::aligned_storage<
+        sizeof(T_ObjectType),
+        std::alignment_of<T_ObjectType>::value
+    >::type slots[T_Capacity];
+
+    void * SlotAt (unsigned index) { return &slots[index]; }
+};
+
+
+template <
+    typename       T_ObjectType,
+    unsigned       T_Capacity,
+    bool           T_ObjectTypeIsPod = false,
+    EObjectStorage T_Storage         = EObjectStorage::Pointer
+>
 class CObjectCollection : public IObjectCollection {
     static_assert(
         sizeof(T_ObjectType *) == sizeof(void *),
         "ObjectLibrary only supports objects with pointers castable to void*."
     );
 
+public: // Types
+    // Walks live objects in dense order.  Don't Add or Remove while iterating;
+    // use DeferRemove instead.
+    class Iterator {
+        CObjectCollection * m_collection;
+        unsigned            m_denseIndex;
+
+    public:
+        Iterator (CObjectCollection * collection, unsigned denseIndex) :
+            m_collection(collection),
+            m_denseIndex(denseIndex)
+        {}
+
+        T_ObjectType & operator* () const  { return *m_collection->GetAt(m_denseIndex); }
+        T_ObjectType * operator-> () const { return m_collection->GetAt(m_denseIndex); }
+        Iterator &     operator++ ()       { ++m_denseIndex; return *this; }
+        bool operator== (const Iterator & rhs) const { return m_denseIndex == rhs.m_denseIndex; }
+        bool operator!= (const Iterator & rhs) const { return m_denseIndex != rhs.m_denseIndex; }
+    };
+
 private: // Data and types
     Entry    m_entries[T_Capacity];
     // [0, m_freeEntryIndex) are allocated.  [m_freeEntryIndex, T_Capacity) are free.
     unsigned m_entryIndices[T_Capacity];
+    // Inverse of m_entryIndices: where each entry currently sits in it.
+    unsigned m_densePositions[T_Capacity];
     unsigned m_freeEntryIndex;
 
+    Handle   m_deferredRemoves[T_Capacity];
+    bool     m_removePending[T_Capacity];
+    unsigned m_deferredRemoveCount;
+
+    ObjectCollectionSlab<T_ObjectType, T_Capacity, T_Storage> m_slab;
+
 protected: // Helpers
     void Remove (unsigned objectIndex) {
-        if (!T_ObjectTypeIsPod)
-            delete static_cast<T_ObjectType *>(m_entries[m_entryIndices[objectIndex]].object);
-        m_entries[m_entryIndices[objectIndex]].object = nullptr;
+        const unsigned entryIndex = m_entryIndices[objectIndex];
+        T_ObjectType * object     = static_cast<T_ObjectType *>(m_entries[entryIndex].object);
+        if (!T_ObjectTypeIsPod) {
+            if (T_Storage == EObjectStorage::InPlace)
+                object->~T_ObjectType();
+            else
+                delete object;
+        }
+        m_entries[entryIndex].object = nullptr;
+        // A queued DeferRemove for this object is stale now; the entry's next
+        // object starts out not pending.
+        m_removePending[entryIndex] = false;
 
         unsigned tailEntryIndex = m_entryIndices[--m_freeEntryIndex];
-        m_entryIndices[m_freeEntryIndex] = m_entryIndices[objectIndex];
+        m_entryIndices[m_freeEntryIndex] = entryIndex;
         m_entryIndices[objectIndex]      = tailEntryIndex;
+        m_densePositions[entryIndex]     = m_freeEntryIndex;
+        m_densePositions[tailEntryIndex] = objectIndex;
     }
 
     void ResetEntryIndices () {
-        for (unsigned i = 0; i < T_Capacity; ++i)
-            m_entryIndices[i] = i;
+        for (unsigned i = 0; i < T_Capacity; ++i) {
+            m_entryIndices[i]   = i;
+            m_densePositions[i] = i;
+        }
     }
 
 public: // Methods
-    CObjectCollection () : m_freeEntryIndex(0) {
+    CObjectCollection () : m_freeEntryIndex(0), m_deferredRemoveCount(0) {
         memset(m_entries, 0, sizeof(m_entries));
+        memset(m_removePending, 0, sizeof(m_removePending));
         ResetEntryIndices();
     }
 
@@ -84,6 +158,8 @@ public: // Methods
     unsigned Capacity () const { return T_Capacity; }
 
     Handle Add (T_ObjectType * object) {
+        static_assert(T_Storage == EObjectStorage::Pointer, "In-place collections construct objects with Emplace.");
+
         Handle handle;
         if (m_freeEntryIndex >= T_Capacity)
             return handle;
@@ -97,6 +173,26 @@ public: // Methods
         return handle;
     }
 
+    // Constructs a new object inside the collection; no heap allocation.
+    template <typename... T_Args>
+    Handle Emplace (T_Args &&... args) {
+        static_assert(T_Storage == EObjectStorage::InPlace, "Pointer collections take caller-allocated objects via Add.");
+
+        Handle handle;
+        if (m_freeEntryIndex >= T_Capacity)
+            return handle;
+
+        const unsigned entryIndex = m_entryIndices[m_freeEntryIndex];
+        Entry &        entry      = m_entries[entryIndex];
+        entry.object = new (m_slab.SlotAt(entryIndex)) T_ObjectType(std::forward<T_Args>(args)...);
+        ++entry.generation;
+        ++m_freeEntryIndex;
+
+        handle.index      = entryIndex;
+        handle.generation = entry.generation;
+        return handle;
+    }
+
     T_ObjectType * Get (const Handle & handle) {
         if (handle.index >= T_Capacity)
             return nullptr;
@@ -112,14 +208,91 @@ public: // Methods
         if (!Get(handle))
             return;
 
-        Remove(handle.index);
+        Remove(m_densePositions[handle.index]);
     }
 
     void RemoveAll () {
         while (m_freeEntryIndex)
-            Remove(0);
+            Remove(0u);
         ResetEntryIndices();
+        memset(m_removePending, 0, sizeof(m_removePending));
+        m_deferredRemoveCount = 0;
+    }
+
+    // Dense access: [0, Count()) in iteration order.
+    T_ObjectType * GetAt (unsigned denseIndex) {
+        ASSERT(denseIndex < m_freeEntryIndex);
+        return static_cast<T_ObjectType *>(m_entries[m_entryIndices[denseIndex]].object);
+    }
+
+    Handle GetHandleAt (unsigned denseIndex) const {
+        ASSERT(denseIndex < m_freeEntryIndex);
+        Handle handle;
+        handle.index      = m_entryIndices[denseIndex];
+        handle.generation = m_entries[handle.index].generation;
+        return handle;
+    }
+
+    Iterator begin () { return Iterator(this, 0); }
+    Iterator end ()   { return Iterator(this, m_freeEntryIndex); }
+
+    template <typename T_Func>
+    void ForEach (T_Func func) {
+        ForEachInRange(0, m_freeEntryIndex, func);
+    }
+
+    template <typename T_Func>
+    void ForEachInRange (unsigned firstDenseIndex, unsigned count, T_Func func) {
+        ASSERT(firstDenseIndex + count <= m_freeEntryIndex);
+        const unsigned * indices = m_entryIndices + firstDenseIndex;
+        for (unsigned i = 0; i < count; ++i)
+            func(*static_cast<T_ObjectType *>(m_entries[indices[i]].object));
+    }
+
+    // Splits the live range into chunkCount near-equal pieces so workers can
+    // each take one; chunks never overlap and together cover every object.
+    void GetChunkRange (unsigned chunkIndex, unsigned chunkCount, unsigned * firstOut, unsigned * countOut) const {
+        ASSERT(chunkCount && chunkIndex < chunkCount);
+        const unsigned first = unsigned(std::uint64_t(m_freeEntryIndex) * chunkIndex / chunkCount);
+        const unsigned last  = unsigned(std::uint64_t(m_freeEntryIndex) * (chunkIndex + 1) / chunkCount);
+        *firstOut = first;
+        *countOut = last - first;
+    }
+
+    template <typename T_Func>
+    void ForEachInChunk (unsigned chunkIndex, unsigned chunkCount, T_Func func) {
+        unsigned first;
+        unsigned count;
+        GetChunkRange(chunkIndex, chunkCount, &first, &count);
+        ForEachInRange(first, count, func);
+    }
+
+    // Queues a Remove for the next FlushDeferredRemoves, so it's safe to call
+    // while iterating.  The object stays valid until then.
+    void DeferRemove (const Handle & handle) {
+        if (!Get(handle) || m_removePending[handle.index])
+            return;
+
+        ASSERT(m_deferredRemoveCount < T_Capacity);
+        m_removePending[handle.index]              = true;
+        m_deferredRemoves[m_deferredRemoveCount++] = handle;
+    }
+
+    bool IsRemovePending (const Handle & handle) {
+        return Get(handle) && m_removePending[handle.index];
+    }
+
+    // Call at a frame boundary, outside any iteration.
+    void FlushDeferredRemoves () {
+        for (unsigned i = 0; i < m_deferredRemoveCount; ++i)
+            Remove(m_deferredRemoves[i]);
+        m_deferredRemoveCount = 0;
     }
 };
 
+
+// Objects live inside the collection itself; see EObjectStorage::InPlace.
+template <typename T_ObjectType, unsigned T_Capacity>
+using CInPlaceObjectCollection = CObjectCollection<T_ObjectType, T_Capacity, false, EObjectStorage::InPlace>;
+
 };
\ No newline at end of file
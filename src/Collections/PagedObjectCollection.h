@@ -0,0 +1,251 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Christopher Higgins Barrett
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include "ObjectCollection.h"
+
+#include <atomic>
+
+namespace CSaru {
+
+//==============================================================================
+// Growable counterpart to CObjectCollection.  Entries live in fixed-size pages
+// that are allocated on demand and never move or free until the collection is
+// destroyed, so outstanding Handles and object pointers stay valid as it
+// grows.  Add, Remove and Get may be called concurrently from any thread: free
+// entries are kept on a lock-free (tagged Treiber stack) free-list, and a new
+// page is published whenever that list runs dry.
+//
+// Live entries have odd generations; Remove advances the generation with a
+// CAS so exactly one of several racing Removes deletes the object.  As with
+// CObjectCollection, keeping an object alive while another thread uses a
+// pointer from Get is up to the caller.
+template <
+    typename T_ObjectType,
+    unsigned T_PageSize        = 256,
+    unsigned T_MaxPages        = 1024,
+    bool     T_ObjectTypeIsPod = false
+>
+class CPagedObjectCollection : public IObjectCollection {
+    static_assert(
+        sizeof(T_ObjectType *) == sizeof(void *),
+        "ObjectLibrary only supports objects with pointers castable to void*."
+    );
+    static_assert(T_PageSize >= 2, "CPagedObjectCollection pages need at least two entries.");
+    static_assert(
+        std::uint64_t(T_PageSize) * T_MaxPages < 0xFFFFFFFFull,
+        "CPagedObjectCollection entry indices must fit in 32 bits."
+    );
+
+private: // Types
+    struct AtomicEntry {
+        std::atomic<unsigned> generation;
+        std::atomic<void *>   object;
+        std::atomic<unsigned> nextFree;
+    };
+
+    struct Page {
+        AtomicEntry entries[T_PageSize];
+    };
+
+    static const unsigned s_invalidIndex = unsigned(-1);
+
+private: // Data
+    std::atomic<Page *>        m_pages[T_MaxPages];
+    std::atomic<unsigned>      m_pageCount; // Pages reserved; a page may still be publishing
+    std::atomic<std::uint64_t> m_freeHead;  // ABA tag << 32 | entry index
+    std::atomic<unsigned>      m_count;
+
+private: // Helpers
+    AtomicEntry * TryEntryAt (unsigned index) const {
+        const unsigned pageIndex = index / T_PageSize;
+        if (pageIndex >= T_MaxPages)
+            return nullptr;
+
+        Page * page = m_pages[pageIndex].load(std::memory_order_acquire);
+        if (!page)
+            return nullptr;
+
+        return &page->entries[index % T_PageSize];
+    }
+
+    unsigned PopFree () {
+        std::uint64_t head = m_freeHead.load(std::memory_order_acquire);
+        for (;;) {
+            const unsigned index = unsigned(head);
+            if (index == s_invalidIndex)
+                return s_invalidIndex;
+
+            // Pages are never freed while the collection lives, so reading a
+            // stale next link is safe; the tag makes the CAS fail instead.
+            // Free-list indices always name published pages; a head that
+            // doesn't is corrupt, and the list is treated as empty.
+            const AtomicEntry * entry = TryEntryAt(index);
+            ASSERT(entry);
+            if (!entry)
+                return s_invalidIndex;
+
+            const unsigned      next    = entry->nextFree.load(std::memory_order_relaxed);
+            const std::uint64_t newHead = ((head >> 32) + 1) << 32 | next;
+            if (m_freeHead.compare_exchange_weak(head, newHead, std::memory_order_acq_rel, std::memory_order_acquire))
+                return index;
+        }
+    }
+
+    void PushFreeChain (unsigned first, unsigned last) {
+        AtomicEntry * lastEntry = TryEntryAt(last);
+        ASSERT(lastEntry);
+        if (!lastEntry)
+            return;
+
+        std::uint64_t head = m_freeHead.load(std::memory_order_relaxed);
+        for (;;) {
+            lastEntry->nextFree.store(unsigned(head), std::memory_order_relaxed);
+            const std::uint64_t newHead = ((head >> 32) + 1) << 32 | first;
+            if (m_freeHead.compare_exchange_weak(head, newHead, std::memory_order_release, std::memory_order_relaxed))
+                return;
+        }
+    }
+
+    // Publishes a new page, keeps its first entry for the caller and pushes
+    // the rest onto the free-list.
+    bool Grow (unsigned * reservedIndexOut) {
+        unsigned pageIndex = m_pageCount.load(std::memory_order_relaxed);
+        do {
+            if (pageIndex >= T_MaxPages)
+                return false;
+        } while (!m_pageCount.compare_exchange_weak(pageIndex, pageIndex + 1, std::memory_order_relaxed));
+
+        const unsigned firstIndex = pageIndex * T_PageSize;
+        Page *         page       = new Page;
+        for (unsigned i = 0; i < T_PageSize; ++i) {
+            page->entries[i].generation.store(0, std::memory_order_relaxed);
+            page->entries[i].object.store(nullptr, std::memory_order_relaxed);
+            page->entries[i].nextFree.store(firstIndex + i + 1, std::memory_order_relaxed);
+        }
+        m_pages[pageIndex].store(page, std::memory_order_release);
+
+        *reservedIndexOut = firstIndex;
+        PushFreeChain(firstIndex + 1, firstIndex + T_PageSize - 1);
+        return true;
+    }
+
+public: // Methods
+    CPagedObjectCollection () :
+        m_pageCount(0),
+        m_freeHead(s_invalidIndex),
+        m_count(0)
+    {
+        for (unsigned i = 0; i < T_MaxPages; ++i)
+            m_pages[i].store(nullptr, std::memory_order_relaxed);
+    }
+
+    virtual ~CPagedObjectCollection () {
+        RemoveAll();
+
+        const unsigned pageCount = MIN(m_pageCount.load(), T_MaxPages);
+        for (unsigned i = 0; i < pageCount; ++i)
+            delete m_pages[i].load();
+    }
+
+    unsigned Count () const    { return m_count.load(std::memory_order_relaxed); }
+    unsigned Capacity () const { return MIN(m_pageCount.load(std::memory_order_relaxed), T_MaxPages) * T_PageSize; }
+
+    Handle Add (T_ObjectType * object) {
+        Handle handle;
+
+        unsigned index = PopFree();
+        if (index == s_invalidIndex && !Grow(&index))
+            return handle;
+
+        AtomicEntry * entry = TryEntryAt(index);
+        ASSERT(entry);
+        if (!entry)
+            return handle;
+
+        const unsigned generation = entry->generation.load(std::memory_order_relaxed) + 1;
+        ASSERT(generation & 1);
+        // Released so a Get that reads this object also sees the generation
+        // the Remove before us left behind; see Get.
+        entry->object.store(object, std::memory_order_release);
+        entry->generation.store(generation, std::memory_order_release);
+        m_count.fetch_add(1, std::memory_order_relaxed);
+
+        handle.index      = index;
+        handle.generation = generation;
+        return handle;
+    }
+
+    // The generation is checked again after the object is read: between the
+    // two loads another thread may Remove the entry and Add a new object to
+    // it, and a stale handle must not return that object.
+    T_ObjectType * Get (const Handle & handle) const {
+        const AtomicEntry * entry = TryEntryAt(handle.index);
+        if (!entry || entry->generation.load(std::memory_order_acquire) != handle.generation)
+            return nullptr;
+
+        void * object = entry->object.load(std::memory_order_acquire);
+        if (entry->generation.load(std::memory_order_acquire) != handle.generation)
+            return nullptr;
+
+        return static_cast<T_ObjectType *>(object);
+    }
+
+    bool Remove (const Handle & handle) {
+        AtomicEntry * entry = TryEntryAt(handle.index);
+        if (!entry || !(handle.generation & 1))
+            return false;
+
+        unsigned expected = handle.generation;
+        if (!entry->generation.compare_exchange_strong(expected, handle.generation + 1, std::memory_order_acq_rel))
+            return false;
+
+        void * object = entry->object.exchange(nullptr, std::memory_order_acq_rel);
+        if (!T_ObjectTypeIsPod)
+            delete static_cast<T_ObjectType *>(object);
+
+        m_count.fetch_sub(1, std::memory_order_relaxed);
+        PushFreeChain(handle.index, handle.index);
+        return true;
+    }
+
+    // Not safe against concurrent Adds.
+    void RemoveAll () {
+        const unsigned pageCount = MIN(m_pageCount.load(), T_MaxPages);
+        for (unsigned index = 0; index < pageCount * T_PageSize; ++index) {
+            const AtomicEntry * entry = TryEntryAt(index);
+            if (!entry)
+                continue;
+
+            Handle handle;
+            handle.index      = index;
+            handle.generation = entry->generation.load(std::memory_order_acquire);
+            if (handle.generation & 1)
+                Remove(handle);
+        }
+    }
+};
+
+} // namespace CSaru
@@ -0,0 +1,272 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Christopher Higgins Barrett
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Broadphase.h"
+
+#include <algorithm>
+
+namespace {
+
+//==============================================================================
+bool Overlaps (const WorldRect & a, const WorldRect & b) {
+    return a.minX < b.maxX && b.minX < a.maxX && a.minY < b.maxY && b.minY < a.maxY;
+}
+
+//==============================================================================
+bool Touches (const WorldRect & a, const WorldRect & b) {
+    return a.minX <= b.maxX && b.minX <= a.maxX && a.minY <= b.maxY && b.minY <= a.maxY;
+}
+
+} // namespace
+
+const Broadphase::ProxyId Broadphase::s_invalidProxy;
+
+//==============================================================================
+Broadphase::Broadphase (float cellSize) :
+    m_cellSize(cellSize),
+    m_invCellSize(1.0f / cellSize),
+    m_proxyCount(0),
+    m_bucketMask(0),
+    m_indexDirty(false)
+{
+    ASSERT(cellSize > 0.0f);
+    m_bucketStarts.assign(2, 0);
+}
+
+//==============================================================================
+Broadphase::CellRange Broadphase::GetCellRange (const WorldRect & bounds) const {
+
+    const CellRange range = {
+        CellCoord(bounds.minX),
+        CellCoord(bounds.minY),
+        CellCoord(bounds.maxX),
+        CellCoord(bounds.maxY)
+    };
+    return range;
+
+}
+
+//==============================================================================
+unsigned Broadphase::GetBucket (int cellX, int cellY) const {
+
+    const unsigned hash = unsigned(cellX) * 0x8da6b343u ^ unsigned(cellY) * 0xd8163841u;
+    return (hash ^ hash >> 16) & m_bucketMask;
+
+}
+
+//==============================================================================
+Broadphase::ProxyId Broadphase::CreateProxy (const WorldRect & bounds, void * userData) {
+
+    ProxyId proxy;
+    if (!m_freeProxies.empty()) {
+        proxy = m_freeProxies.back();
+        m_freeProxies.pop_back();
+    }
+    else {
+        proxy = ProxyId(m_bounds.size());
+        m_bounds.push_back(bounds);
+        m_userData.push_back(nullptr);
+        m_indexedBounds.push_back(bounds);
+        m_indexedCells.push_back(CellRange());
+        m_alive.push_back(0);
+        m_indexed.push_back(0);
+    }
+
+    m_bounds[proxy]   = bounds;
+    m_userData[proxy] = userData;
+    m_alive[proxy]    = 1;
+    m_indexed[proxy]  = 0;
+    ++m_proxyCount;
+    m_indexDirty = true;
+    return proxy;
+
+}
+
+//==============================================================================
+void Broadphase::DestroyProxy (ProxyId proxy) {
+
+    ASSERT(proxy < m_alive.size() && m_alive[proxy]);
+    m_alive[proxy]    = 0;
+    m_indexed[proxy]  = 0;
+    m_userData[proxy] = nullptr;
+    m_freeProxies.push_back(proxy);
+    --m_proxyCount;
+    m_indexDirty = true;
+
+}
+
+//==============================================================================
+void Broadphase::Clear () {
+
+    m_bounds.clear();
+    m_userData.clear();
+    m_indexedBounds.clear();
+    m_indexedCells.clear();
+    m_alive.clear();
+    m_indexed.clear();
+    m_freeProxies.clear();
+    m_proxyCount = 0;
+    m_entries.clear();
+    m_bucketStarts.assign(2, 0);
+    m_bucketMask = 0;
+    m_indexDirty = false;
+
+}
+
+//==============================================================================
+void Broadphase::Rebuild () {
+
+    const ProxyId slotCount = ProxyId(m_bounds.size());
+
+    // Most frames most proxies stay within the cells they're listed under;
+    // moves inside those cells only need the bounds copied.
+    m_indexedBounds = m_bounds;
+    for (ProxyId proxy = 0; proxy < slotCount && !m_indexDirty; ++proxy) {
+        if (m_alive[proxy] && GetCellRange(m_bounds[proxy]) != m_indexedCells[proxy])
+            m_indexDirty = true;
+    }
+    if (!m_indexDirty)
+        return;
+    m_indexDirty = false;
+    m_indexed    = m_alive;
+
+    // Keep the table at most half full of proxies.
+    unsigned bucketCount = 64;
+    while (bucketCount < m_proxyCount * 2)
+        bucketCount <<= 1;
+    m_bucketMask = bucketCount - 1;
+    m_bucketStarts.assign(bucketCount + 1, 0);
+
+    // Counting sort by bucket: count, turn counts into bucket ends, then fill
+    // each bucket back to front so the ends become starts.
+    for (ProxyId proxy = 0; proxy < slotCount; ++proxy) {
+        if (!m_alive[proxy])
+            continue;
+
+        const CellRange range  = GetCellRange(m_bounds[proxy]);
+        m_indexedCells[proxy] = range;
+        for (int cellY = range.minY; cellY <= range.maxY; ++cellY) {
+            for (int cellX = range.minX; cellX <= range.maxX; ++cellX)
+                ++m_bucketStarts[GetBucket(cellX, cellY)];
+        }
+    }
+
+    for (unsigned bucket = 1; bucket < bucketCount; ++bucket)
+        m_bucketStarts[bucket] += m_bucketStarts[bucket - 1];
+    m_bucketStarts[bucketCount] = m_bucketStarts[bucketCount - 1];
+    m_entries.resize(m_bucketStarts[bucketCount]);
+
+    for (ProxyId proxy = 0; proxy < slotCount; ++proxy) {
+        if (!m_alive[proxy])
+            continue;
+
+        const CellRange & range = m_indexedCells[proxy];
+        for (int cellY = range.minY; cellY <= range.maxY; ++cellY) {
+            for (int cellX = range.minX; cellX <= range.maxX; ++cellX) {
+                Entry & entry = m_entries[--m_bucketStarts[GetBucket(cellX, cellY)]];
+                entry.proxy = proxy;
+                entry.cellX = cellX;
+                entry.cellY = cellY;
+            }
+        }
+    }
+
+}
+
+//==============================================================================
+void Broadphase::FindPairs (std::vector<Pair> * pairsOut) const {
+
+    pairsOut->clear();
+
+    const unsigned bucketCount = m_bucketMask + 1;
+    for (unsigned bucket = 0; bucket < bucketCount; ++bucket) {
+        const Entry * begin = m_entries.data() + m_bucketStarts[bucket];
+        const Entry * end   = m_entries.data() + m_bucketStarts[bucket + 1];
+        for (const Entry * a = begin; a < end; ++a) {
+            if (!m_indexed[a->proxy])
+                continue;
+
+            const WorldRect & boundsA = m_indexedBounds[a->proxy];
+            for (const Entry * b = a + 1; b < end; ++b) {
+                if (a->cellX != b->cellX || a->cellY != b->cellY || !m_indexed[b->proxy])
+                    continue;
+
+                const WorldRect & boundsB = m_indexedBounds[b->proxy];
+                if (!Overlaps(boundsA, boundsB))
+                    continue;
+
+                // Both proxies share every cell of their overlap; only the
+                // first of those reports the pair.
+                if (CellCoord(MAX(boundsA.minX, boundsB.minX)) != a->cellX ||
+                    CellCoord(MAX(boundsA.minY, boundsB.minY)) != a->cellY)
+                    continue;
+
+                const Pair pair = { MIN(a->proxy, b->proxy), MAX(a->proxy, b->proxy) };
+                pairsOut->push_back(pair);
+            }
+        }
+    }
+
+}
+
+//==============================================================================
+void Broadphase::QueryRegion (const WorldRect & region, std::vector<ProxyId> * proxiesOut) const {
+
+    proxiesOut->clear();
+    if (region.minX > region.maxX || region.minY > region.maxY)
+        return;
+
+    // Regions wider than the index are cheaper to answer by brute force.
+    const CellRange range     = GetCellRange(region);
+    const double    cellCount = (double(range.maxX) - range.minX + 1.0) * (double(range.maxY) - range.minY + 1.0);
+    if (cellCount > double(m_entries.size())) {
+        const ProxyId slotCount = ProxyId(m_indexed.size());
+        for (ProxyId proxy = 0; proxy < slotCount; ++proxy) {
+            if (m_indexed[proxy] && Touches(m_indexedBounds[proxy], region))
+                proxiesOut->push_back(proxy);
+        }
+        return;
+    }
+
+    for (int cellY = range.minY; cellY <= range.maxY; ++cellY) {
+        for (int cellX = range.minX; cellX <= range.maxX; ++cellX) {
+            const unsigned bucket = GetBucket(cellX, cellY);
+            const Entry *  end    = m_entries.data() + m_bucketStarts[bucket + 1];
+            for (const Entry * entry = m_entries.data() + m_bucketStarts[bucket]; entry < end; ++entry) {
+                if (entry->cellX != cellX || entry->cellY != cellY || !m_indexed[entry->proxy])
+                    continue;
+
+                const WorldRect & bounds = m_indexedBounds[entry->proxy];
+                if (!Touches(bounds, region))
+                    continue;
+
+                if (CellCoord(MAX(bounds.minX, region.minX)) != cellX || CellCoord(MAX(bounds.minY, region.minY)) != cellY)
+                    continue;
+
+                proxiesOut->push_back(entry->proxy);
+            }
+        }
+    }
+
+}
@@ -0,0 +1,118 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Christopher Higgins Barrett
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+//==============================================================================
+// Uniform-grid broadphase for world-space boxes, hashed so the grid needs no
+// bounds.  Proxies are moved freely (MoveProxy only writes that proxy's slot,
+// so objects may move their own proxies from parallel updates); Rebuild() then
+// re-indexes them in one counting-sort pass, O(proxies + cells touched), and
+// does nothing when no proxy has changed cells.
+//
+// Each proxy is listed once per cell it touches.  A pair is reported only from
+// the cell holding the min corner of the two boxes' overlap, and a region
+// query reports a proxy only from the cell holding the min corner of its
+// intersection with the region, so results need no de-duplication and
+// queries are read-only.
+//
+// Queries run against the bounds Rebuild() indexed, not the live ones, so a
+// proxy moved since then is still found where it was listed.  Proxies created
+// since the last Rebuild aren't reported yet; destroyed ones no longer are.
+class Broadphase {
+public: // Types and Constants
+    typedef unsigned ProxyId;
+
+    static const ProxyId s_invalidProxy = ProxyId(-1);
+
+    struct Pair {
+        ProxyId a; // a < b
+        ProxyId b;
+    };
+
+private: // Types
+    struct CellRange {
+        int minX;
+        int minY;
+        int maxX; // Inclusive
+        int maxY;
+
+        bool operator== (const CellRange & rhs) const {
+            return minX == rhs.minX && minY == rhs.minY && maxX == rhs.maxX && maxY == rhs.maxY;
+        }
+        bool operator!= (const CellRange & rhs) const { return !(*this == rhs); }
+    };
+
+    struct Entry {
+        ProxyId proxy;
+        int     cellX;
+        int     cellY;
+    };
+
+private: // Data
+    float m_cellSize;
+    float m_invCellSize;
+
+    // Proxies, by ProxyId
+    std::vector<WorldRect>     m_bounds;
+    std::vector<void *>        m_userData;
+    std::vector<WorldRect>     m_indexedBounds; // Bounds as of the last Rebuild
+    std::vector<CellRange>     m_indexedCells;  // Cells each proxy is listed under
+    std::vector<unsigned char> m_alive;
+    std::vector<unsigned char> m_indexed;       // Alive at the last Rebuild and since
+    std::vector<ProxyId>       m_freeProxies;
+    unsigned                   m_proxyCount;
+
+    // Index: m_entries sorted by bucket, m_bucketStarts[b] .. [b + 1] per bucket
+    std::vector<Entry>    m_entries;
+    std::vector<unsigned> m_bucketStarts;
+    unsigned              m_bucketMask;
+    bool                  m_indexDirty;
+
+private: // Helpers
+    int       CellCoord (float v) const { return int(floorf(v * m_invCellSize)); }
+    CellRange GetCellRange (const WorldRect & bounds) const;
+    unsigned  GetBucket (int cellX, int cellY) const;
+
+public:
+    explicit Broadphase (float cellSize = 64.0f);
+
+    // Commands
+    ProxyId CreateProxy (const WorldRect & bounds, void * userData);
+    void    DestroyProxy (ProxyId proxy);
+    void    MoveProxy (ProxyId proxy, const WorldRect & bounds) { m_bounds[proxy] = bounds; }
+    void    Clear ();
+
+    // Brings the index up to date with every proxy change since the last call.
+    void    Rebuild ();
+
+    // Queries; these see the indexed bounds (see above).
+    void    FindPairs (std::vector<Pair> * pairsOut) const;
+    void    QueryRegion (const WorldRect & region, std::vector<ProxyId> * proxiesOut) const;
+
+    const WorldRect & GetBounds (ProxyId proxy) const   { return m_bounds[proxy]; } // Latest MoveProxy
+    void *            GetUserData (ProxyId proxy) const { return m_userData[proxy]; }
+    unsigned          GetProxyCount () const            { return m_proxyCount; }
+    float             GetCellSize () const              { return m_cellSize; }
+};
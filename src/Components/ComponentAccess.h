@@ -0,0 +1,62 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Christopher Higgins Barrett
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+//==============================================================================
+// Per-object data a component type reads or writes during Update.  Component
+// types declare these as s_reads/s_writes so the scheduler can run
+// non-conflicting pools side by side.  Only data on the component's own
+// GameObject counts; anything shared between objects is COMPONENT_DATA_GLOBAL,
+// which always runs alone on the calling thread.
+enum EComponentData : unsigned {
+    COMPONENT_DATA_NONE               = 0,
+    COMPONENT_DATA_INPUT              = 1 << 0,
+    COMPONENT_DATA_TRANSFORM_POSITION = 1 << 1,
+    COMPONENT_DATA_TRANSFORM_VELOCITY = 1 << 2,
+    COMPONENT_DATA_TRANSFORM_SHAPE    = 1 << 3, // Rotation and scale
+    COMPONENT_DATA_SPRITE             = 1 << 4,
+    COMPONENT_DATA_JUMP_STATE         = 1 << 5,
+    COMPONENT_DATA_CAMERA             = 1 << 6,
+    COMPONENT_DATA_LEVEL              = 1 << 7,
+    COMPONENT_DATA_BROADPHASE_PROXY   = 1 << 8, // The object's own Broadphase slot
+    COMPONENT_DATA_AGAM_BODY          = 1 << 9, // Fixed-point state in GocAgamBody
+    COMPONENT_DATA_GLOBAL             = 1u << 31,
+};
+
+//==============================================================================
+struct ComponentAccess {
+    unsigned reads;
+    unsigned writes;
+
+    bool IsGlobal () const {
+        return ((reads | writes) & COMPONENT_DATA_GLOBAL) != 0;
+    }
+
+    bool ConflictsWith (const ComponentAccess & other) const {
+        if (IsGlobal() || other.IsGlobal())
+            return true;
+        return (writes & (other.reads | other.writes)) || (other.writes & reads);
+    }
+};
@@ -0,0 +1,215 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Christopher Higgins Barrett
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include "../GameObject.h"
+#include "../GameObjectComponent.h"
+
+#include <new>
+#include <type_traits>
+
+//==============================================================================
+class IComponentPool {
+public:
+    virtual ~IComponentPool () {}
+
+    virtual void     UpdateAll (float dt) = 0;
+    virtual void     RenderAll () = 0;
+    virtual unsigned Count () const = 0;
+
+    // Parallel update support: a pool is split into independent batches, and
+    // reports what its component type touches so the scheduler can order it.
+    virtual ComponentAccess GetAccess () const = 0;
+    virtual unsigned        GetBatchCount () const = 0;
+    virtual void            UpdateBatch (float dt, unsigned batchIndex) = 0;
+};
+
+
+//==============================================================================
+// Contiguous storage for one concrete component type.  Components are
+// constructed in place inside fixed-size pages, so they never move while
+// alive (see GameObjectComponent's address guarantee), and UpdateAll/RenderAll
+// walk each page in order with non-virtual calls.
+template <typename T_Component, unsigned T_PageSize = 256>
+class ComponentPool : public IComponentPool {
+    static_assert(
+        std::is_base_of<GameObjectComponent, T_Component>::value,
+        "ComponentPool only holds GameObjectComponents."
+    );
+
+private: // Types
+    typedef typename std::aligned_storage<
+        sizeof(T_Component),
+        std::alignment_of<T_Component>::value
+    >::type Slot;
+
+    struct Page {
+        Slot     slots[T_PageSize];
+        bool     live[T_PageSize];
+        unsigned highWater; // Slots [highWater, T_PageSize) have never been used
+    };
+
+private: // Data
+    std::vector<Page *>   m_pages;
+    std::vector<unsigned> m_freeSlots; // page << 16 | slot
+    unsigned              m_count;
+
+private: // Helpers
+    static T_Component * SlotObject (Page * page, unsigned slot) {
+        return reinterpret_cast<T_Component *>(&page->slots[slot]);
+    }
+
+    bool FindSlot (const T_Component * component, unsigned * pageIndexOut, unsigned * slotOut) const {
+        const Slot * slot = reinterpret_cast<const Slot *>(component);
+        for (unsigned p = 0; p < m_pages.size(); ++p) {
+            const Page * page = m_pages[p];
+            if (slot < page->slots || slot >= page->slots + T_PageSize)
+                continue;
+
+            *pageIndexOut = p;
+            *slotOut      = unsigned(slot - page->slots);
+            return true;
+        }
+
+        return false;
+    }
+
+    void AllocateSlot (unsigned * pageIndexOut, unsigned * slotOut) {
+        if (!m_freeSlots.empty()) {
+            const unsigned packed = m_freeSlots.back();
+            m_freeSlots.pop_back();
+            *pageIndexOut = packed >> 16;
+            *slotOut      = packed & 0xFFFF;
+            return;
+        }
+
+        if (m_pages.empty() || m_pages.back()->highWater >= T_PageSize) {
+            Page * page = new Page;
+            memset(page->live, 0, sizeof(page->live));
+            page->highWater = 0;
+            m_pages.push_back(page);
+        }
+
+        *pageIndexOut = unsigned(m_pages.size() - 1);
+        *slotOut      = m_pages.back()->highWater++;
+    }
+
+public: // Methods
+    ComponentPool () : m_count(0) {
+        static_assert(T_PageSize <= 0x10000, "ComponentPool page index packing assumes 16-bit slots.");
+    }
+
+    ~ComponentPool () {
+        DestroyAll();
+    }
+
+    template <typename... T_Args>
+    T_Component * Create (T_Args &&... args) {
+        unsigned pageIndex;
+        unsigned slot;
+        AllocateSlot(&pageIndex, &slot);
+
+        Page *        page      = m_pages[pageIndex];
+        T_Component * component = new (&page->slots[slot]) T_Component(std::forward<T_Args>(args)...);
+        page->live[slot] = true;
+        ++m_count;
+
+        return component;
+    }
+
+    void Destroy (T_Component * component) {
+        unsigned pageIndex;
+        unsigned slot;
+        if (!FindSlot(component, &pageIndex, &slot))
+            return;
+
+        Page * page = m_pages[pageIndex];
+        ASSERT(page->live[slot]);
+        if (component->GetOwner())
+            component->GetOwner()->RemoveComponent(component);
+        component->~T_Component();
+        page->live[slot] = false;
+        m_freeSlots.push_back(pageIndex << 16 | slot);
+        --m_count;
+    }
+
+    void DestroyAll () {
+        for (Page * page : m_pages) {
+            for (unsigned i = 0; i < page->highWater; ++i) {
+                if (!page->live[i])
+                    continue;
+
+                T_Component * component = SlotObject(page, i);
+                if (component->GetOwner())
+                    component->GetOwner()->RemoveComponent(component);
+                component->~T_Component();
+            }
+            delete page;
+        }
+
+        m_pages.clear();
+        m_freeSlots.clear();
+        m_count = 0;
+    }
+
+    template <typename T_Func>
+    void ForEach (T_Func func) {
+        for (unsigned p = 0; p < m_pages.size(); ++p)
+            ForEachInPage(p, func);
+    }
+
+    template <typename T_Func>
+    void ForEachInPage (unsigned pageIndex, T_Func func) {
+        Page *         page      = m_pages[pageIndex];
+        const unsigned highWater = page->highWater;
+        for (unsigned i = 0; i < highWater; ++i) {
+            if (page->live[i])
+                func(*SlotObject(page, i));
+        }
+    }
+
+    // IComponentPool
+    void UpdateAll (float dt) override {
+        // Qualified calls bind statically, so there's no vtable load per component.
+        ForEach([dt](T_Component & component) { component.T_Component::Update(dt); });
+    }
+
+    void RenderAll () override {
+        ForEach([](T_Component & component) { component.T_Component::Render(); });
+    }
+
+    unsigned Count () const override { return m_count; }
+
+    ComponentAccess GetAccess () const override {
+        ComponentAccess access = { T_Component::s_reads, T_Component::s_writes };
+        return access;
+    }
+
+    unsigned GetBatchCount () const override { return unsigned(m_pages.size()); }
+
+    void UpdateBatch (float dt, unsigned batchIndex) override {
+        ForEachInPage(batchIndex, [dt](T_Component & component) { component.T_Component::Update(dt); });
+    }
+};
@@ -0,0 +1,144 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Christopher Higgins Barrett
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "ComponentStore.h"
+#include "../Jobs/JobSystem.h"
+
+namespace {
+
+struct PoolBatchContext {
+    IComponentPool * pool;
+    float            dt;
+};
+
+//==============================================================================
+void UpdatePoolBatches (void * context, unsigned begin, unsigned end) {
+
+    PoolBatchContext * batch = static_cast<PoolBatchContext *>(context);
+    for (unsigned i = begin; i < end; ++i)
+        batch->pool->UpdateBatch(batch->dt, i);
+
+}
+
+} // namespace
+
+//==============================================================================
+ComponentStore::~ComponentStore () {
+
+    for (PoolRecord & record : m_pools)
+        delete record.pool;
+    m_pools.clear();
+
+}
+
+//==============================================================================
+void ComponentStore::BuildPhases () {
+
+    // Greedy: a pool joins the current phase unless it conflicts with a pool
+    // already in it.  Conflicting pools start a new phase, which keeps
+    // registration order wherever order could matter.
+    m_phases.clear();
+
+    for (unsigned i = 0; i < m_pools.size(); ++i) {
+        const ComponentAccess access = m_pools[i].pool->GetAccess();
+
+        bool startNew = m_phases.empty();
+        if (!startNew) {
+            const Phase & phase = m_phases.back();
+            for (unsigned j = phase.firstPool; j < phase.firstPool + phase.poolCount; ++j) {
+                if (access.ConflictsWith(m_pools[j].pool->GetAccess())) {
+                    startNew = true;
+                    break;
+                }
+            }
+        }
+
+        if (startNew) {
+            Phase phase = { i, 0, false };
+            m_phases.push_back(phase);
+        }
+
+        Phase & phase = m_phases.back();
+        ++phase.poolCount;
+        phase.serial = phase.serial || access.IsGlobal();
+    }
+
+    m_phasesDirty = false;
+
+}
+
+//==============================================================================
+IComponentPool * ComponentStore::FindPool (PoolKey key) const {
+
+    for (const PoolRecord & record : m_pools) {
+        if (record.key == key)
+            return record.pool;
+    }
+
+    return nullptr;
+
+}
+
+//==============================================================================
+void ComponentStore::RenderAll () {
+
+    for (PoolRecord & record : m_pools)
+        record.pool->RenderAll();
+
+}
+
+//==============================================================================
+void ComponentStore::UpdateAll (float dt) {
+
+    for (PoolRecord & record : m_pools)
+        record.pool->UpdateAll(dt);
+
+}
+
+//==============================================================================
+void ComponentStore::UpdateParallel (JobSystem & jobs, float dt) {
+
+    if (m_phasesDirty)
+        BuildPhases();
+
+    std::vector<PoolBatchContext> contexts(m_pools.size());
+
+    for (const Phase & phase : m_phases) {
+        if (phase.serial) {
+            for (unsigned i = phase.firstPool; i < phase.firstPool + phase.poolCount; ++i)
+                m_pools[i].pool->UpdateAll(dt);
+            continue;
+        }
+
+        JobSystem::JobCounter counter;
+        for (unsigned i = phase.firstPool; i < phase.firstPool + phase.poolCount; ++i) {
+            IComponentPool * pool = m_pools[i].pool;
+            contexts[i].pool = pool;
+            contexts[i].dt   = dt;
+            jobs.Dispatch(&UpdatePoolBatches, &contexts[i], pool->GetBatchCount(), 1, &counter);
+        }
+        jobs.Wait(&counter);
+    }
+
+}
@@ -0,0 +1,122 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Christopher Higgins Barrett
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include "ComponentPool.h"
+
+class JobSystem;
+
+//==============================================================================
+// Owns one ComponentPool per registered component type.  Pools are updated in
+// registration order, each in a single tight loop across every object, instead
+// of GameObject::Update's per-object pointer chase.  Components created here
+// are still attached to their owner so GetComponent keeps working; the owner
+// just skips them in its own Update/Render.
+class ComponentStore {
+private: // Types
+    typedef const void * PoolKey;
+
+    struct PoolRecord {
+        PoolKey          key;
+        IComponentPool * pool;
+    };
+
+    // A run of consecutive pools whose access sets don't conflict.
+    struct Phase {
+        unsigned firstPool;
+        unsigned poolCount;
+        bool     serial; // Contains a COMPONENT_DATA_GLOBAL pool
+    };
+
+private: // Data
+    std::vector<PoolRecord> m_pools;
+    std::vector<Phase>      m_phases;
+    bool                    m_phasesDirty;
+
+private: // Helpers
+    template <typename T_Component>
+    static PoolKey KeyOf () {
+        static const char s_key = 0;
+        return &s_key;
+    }
+
+    IComponentPool * FindPool (PoolKey key) const;
+    void             BuildPhases ();
+
+public:
+    ComponentStore () : m_phasesDirty(false) {}
+    ~ComponentStore ();
+
+    // Pools must be registered before use; registration order is update order.
+    template <typename T_Component>
+    ComponentPool<T_Component> & RegisterPool () {
+        ComponentPool<T_Component> * pool = GetPool<T_Component>();
+        if (pool)
+            return *pool;
+
+        pool = new ComponentPool<T_Component>();
+        PoolRecord record = { KeyOf<T_Component>(), pool };
+        m_pools.push_back(record);
+        m_phasesDirty = true;
+        return *pool;
+    }
+
+    template <typename T_Component>
+    ComponentPool<T_Component> * GetPool () const {
+        return static_cast<ComponentPool<T_Component> *>(FindPool(KeyOf<T_Component>()));
+    }
+
+    template <typename T_Component, typename... T_Args>
+    T_Component * Create (GameObject * owner, T_Args &&... args) {
+        ComponentPool<T_Component> * pool = GetPool<T_Component>();
+        ASSERT(pool);
+        if (!pool)
+            return nullptr;
+
+        T_Component * component = pool->Create(std::forward<T_Args>(args)...);
+        component->SetPooled(true);
+        owner->AddComponent(component);
+        return component;
+    }
+
+    template <typename T_Component>
+    void Destroy (T_Component * component) {
+        ComponentPool<T_Component> * pool = GetPool<T_Component>();
+        ASSERT(pool);
+        if (!pool || !component)
+            return;
+
+        pool->Destroy(component);
+    }
+
+    void UpdateAll (float dt);
+    void RenderAll ();
+
+    // Same result as UpdateAll, but each phase's pools are split into batches
+    // and run across the job system's workers.
+    void UpdateParallel (JobSystem & jobs, float dt);
+
+    unsigned GetPoolCount () const { return unsigned(m_pools.size()); }
+};
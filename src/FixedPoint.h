@@ -0,0 +1,110 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Christopher Higgins Barrett
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include <cstdint>
+
+//==============================================================================
+// Signed fixed-point number with 16 fraction bits, for simulation state that
+// must evolve bit-identically across runs, builds and machines.  Every
+// operation is plain integer math: products round toward negative infinity
+// and quotients toward zero.
+//
+// The raw value is 64-bit, but only +/-2^30 world units (s_maxRaw) are
+// valid, far past any level; that headroom keeps every intermediate inside
+// int64 without a 128-bit multiply.  Leaving the range asserts.
+//
+// Conversions from float round to nearest and are only exact for values that
+// came from ToFloat(); keep the authoritative state in Fixed16 and treat
+// floats derived from it as read-only copies.
+class Fixed16 {
+public: // Constants
+    static const int          s_fractionBits = 16;
+    static const std::int64_t s_one          = std::int64_t(1) << s_fractionBits;
+    static const std::int64_t s_maxRaw       = (std::int64_t(1) << 46) - 1;
+    static const int          s_maxInt       = int(s_maxRaw >> s_fractionBits);
+
+private: // Data
+    std::int64_t m_raw;
+
+public:
+    Fixed16 () : m_raw(0) {}
+
+    static Fixed16 FromRaw (std::int64_t raw) {
+        ASSERT(raw >= -s_maxRaw && raw <= s_maxRaw);
+        Fixed16 f;
+        f.m_raw = raw;
+        return f;
+    }
+    static Fixed16 FromInt (int value) {
+        ASSERT(value >= -s_maxInt && value <= s_maxInt);
+        return FromRaw(value * s_one);
+    }
+    static Fixed16 FromRatio (int numerator, int denominator) {
+        return FromRaw(std::int64_t(numerator) * s_one / denominator);
+    }
+    static Fixed16 FromFloat (float value) {
+        ASSERT(value >= -float(s_maxInt) && value <= float(s_maxInt));
+        const double scaled = double(value) * double(s_one);
+        return FromRaw(std::int64_t(scaled < 0.0 ? scaled - 0.5 : scaled + 0.5));
+    }
+
+    // Queries
+    std::int64_t GetRaw () const  { return m_raw; }
+    float        ToFloat () const { return float(double(m_raw) * (1.0 / double(s_one))); }
+    Fixed16      Abs () const     { return FromRaw(m_raw < 0 ? -m_raw : m_raw); }
+
+    // Operators
+    Fixed16 operator- () const                  { return FromRaw(-m_raw); }
+    Fixed16 operator+ (Fixed16 rhs) const       { return FromRaw(m_raw + rhs.m_raw); }
+    Fixed16 operator- (Fixed16 rhs) const       { return FromRaw(m_raw - rhs.m_raw); }
+
+    // rhs splits into whole and fraction parts, which floors exactly like
+    // (m_raw * rhs.m_raw) >> 16 would.  With both in range and the result in
+    // range, neither partial product leaves int64.
+    Fixed16 operator* (Fixed16 rhs) const {
+        const std::int64_t whole    = rhs.m_raw >> s_fractionBits;
+        const std::int64_t fraction = rhs.m_raw & (s_one - 1);
+        ASSERT(!whole || (m_raw < 0 ? -m_raw : m_raw) <= s_maxRaw / (whole < 0 ? -whole : whole));
+        return FromRaw(m_raw * whole + ((m_raw * fraction) >> s_fractionBits));
+    }
+    Fixed16 operator/ (Fixed16 rhs) const {
+        ASSERT(rhs.m_raw);
+        return FromRaw(m_raw * s_one / rhs.m_raw);
+    }
+    Fixed16 operator* (int rhs) const           { return *this * FromInt(rhs); }
+    Fixed16 operator/ (int rhs) const           { return FromRaw(m_raw / rhs); }
+
+    Fixed16 & operator+= (Fixed16 rhs)          { return *this = *this + rhs; }
+    Fixed16 & operator-= (Fixed16 rhs)          { return *this = *this - rhs; }
+    Fixed16 & operator*= (Fixed16 rhs)          { return *this = *this * rhs; }
+
+    bool operator== (Fixed16 rhs) const         { return m_raw == rhs.m_raw; }
+    bool operator!= (Fixed16 rhs) const         { return m_raw != rhs.m_raw; }
+    bool operator<  (Fixed16 rhs) const         { return m_raw <  rhs.m_raw; }
+    bool operator<= (Fixed16 rhs) const         { return m_raw <= rhs.m_raw; }
+    bool operator>  (Fixed16 rhs) const         { return m_raw >  rhs.m_raw; }
+    bool operator>= (Fixed16 rhs) const         { return m_raw >= rhs.m_raw; }
+};
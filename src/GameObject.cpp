@@ -1,18 +1,50 @@
 #include "GameObject.h"
 #include "GameObjectComponent.h"
 
+#include <cstring>
+
 //==============================================================================
-GameObject::GameObject ()
-{}
+GameObject::GameObject () {
+
+    memset(m_slots, 0, sizeof(m_slots));
+
+}
 
 //==============================================================================
 void GameObject::AddComponent (GameObjectComponent * component) {
     m_components.push_back(component);
     component->SetOwner(this);
+
+    // First component of a type wins, matching the old linear scan.
+    unsigned slot;
+    if (SlotIndex(component->GetGlobalTypeId(), &slot) && !m_slots[slot])
+        m_slots[slot] = component;
+
+    NotifySiblingsChanged();
+}
+
+//==============================================================================
+void GameObject::RemoveComponent (GameObjectComponent * component) {
+
+    for (unsigned i = 0; i < m_components.size(); ++i) {
+        if (m_components[i] != component)
+            continue;
+
+        m_components.erase(m_components.begin() + i);
+        component->SetOwner(nullptr);
+
+        unsigned slot;
+        if (SlotIndex(component->GetGlobalTypeId(), &slot) && m_slots[slot] == component)
+            m_slots[slot] = FindComponentSlow(component->GetGlobalTypeId());
+
+        NotifySiblingsChanged();
+        return;
+    }
+
 }
 
 //==============================================================================
-GameObjectComponent * GameObject::GetComponent (unsigned componentType) {
+GameObjectComponent * GameObject::FindComponentSlow (unsigned componentType) {
 
     for (GameObjectComponent * goc : m_components) {
         if (goc->GetGlobalTypeId() == componentType)
@@ -23,22 +55,86 @@ GameObjectComponent * GameObject::GetComponent (unsigned componentType) {
 
 }
 
+//==============================================================================
+void GameObject::NotifySiblingsChanged () {
+
+    for (GameObjectComponent * goc : m_components)
+        goc->OnSiblingsChanged();
+
+}
+
 //==============================================================================
 void GameObject::Render () {
 
     for (unsigned i = 0; i < m_components.size(); ++i) {
         GameObjectComponent * comp = m_components[i];
-        comp->Render();
+        if (!comp->IsPooled())
+            comp->Render();
     }
 
 }
 
+//==============================================================================
+bool GameObject::SlotIndex (unsigned componentTypeId, unsigned * indexOut) {
+
+    const unsigned module    = componentTypeId >> 16;
+    const unsigned localType = componentTypeId & 0xFFFF;
+    if (module >= s_slotModules || localType >= s_slotLocalTypes)
+        return false;
+
+    *indexOut = module * s_slotLocalTypes + localType;
+    return true;
+
+}
+
 //==============================================================================
 void GameObject::Update (float dt) {
 
     for (unsigned i = 0; i < m_components.size(); ++i) {
         GameObjectComponent * comp = m_components[i];
-        comp->Update(dt);
+        if (!comp->IsPooled())
+            comp->Update(dt);
+    }
+
+}
+
+//==============================================================================
+unsigned GameObject::GetStateSize () const {
+
+    unsigned size = Transform::s_stateFloats * sizeof(float);
+    for (const GameObjectComponent * comp : m_components)
+        size += comp->GetStateSize();
+
+    return size;
+
+}
+
+//==============================================================================
+void GameObject::SaveState (unsigned char * state) const {
+
+    float transformState[Transform::s_stateFloats];
+    m_transform.SaveState(transformState);
+    memcpy(state, transformState, sizeof(transformState));
+    state += sizeof(transformState);
+
+    for (const GameObjectComponent * comp : m_components) {
+        comp->SaveState(state);
+        state += comp->GetStateSize();
+    }
+
+}
+
+//==============================================================================
+void GameObject::LoadState (const unsigned char * state) {
+
+    float transformState[Transform::s_stateFloats];
+    memcpy(transformState, state, sizeof(transformState));
+    m_transform.LoadState(transformState);
+    state += sizeof(transformState);
+
+    for (GameObjectComponent * comp : m_components) {
+        comp->LoadState(state);
+        state += comp->GetStateSize();
     }
 
 }
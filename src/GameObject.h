@@ -27,11 +27,19 @@ SOFTWARE.
 class GameObjectComponent;
 
 class GameObject {
+
+public: // Constants
+
+    // Component slots are indexed directly by GlobalTypeId module/local pairs
+    // that fall inside this table; anything outside falls back to a scan.
+    static const unsigned s_slotModules    = 4;
+    static const unsigned s_slotLocalTypes = 8;
     
 protected: // Data
 
     Transform                          m_transform;
     std::vector<GameObjectComponent *> m_components;
+    GameObjectComponent *              m_slots[s_slotModules * s_slotLocalTypes];
     
 public:
 
@@ -39,18 +47,42 @@ public:
     
 private: // Helpers
 
+    static bool SlotIndex (unsigned componentTypeId, unsigned * indexOut);
+    void        NotifySiblingsChanged ();
+    GameObjectComponent * FindComponentSlow (unsigned componentTypeId);
+
 public: // GameObject
 
     void Update (float dt);
     void Render ();
+
+    // Rollback: the Transform's state followed by each component's, in the
+    // order they were added.
+    unsigned GetStateSize () const;
+    void     SaveState (unsigned char * state) const;
+    void     LoadState (const unsigned char * state);
     
     Transform &       GetTransform ()       { return m_transform; }
     const Transform & GetTransform () const { return m_transform; }
 
     void                  AddComponent (GameObjectComponent * component);
-    GameObjectComponent * GetComponent (unsigned componentTypeId);
+    void                  RemoveComponent (GameObjectComponent * component);
+    GameObjectComponent * GetComponent (unsigned componentTypeId) {
+        unsigned slot;
+        if (SlotIndex(componentTypeId, &slot))
+            return m_slots[slot];
+        return FindComponentSlow(componentTypeId);
+    }
     GameObjectComponent * GetComponent (unsigned short module, unsigned short componentType) {
         return GetComponent(module << 16 | componentType);
     }
 
+    // T_Component must declare its GlobalTypeId as a static s_typeId.
+    template <typename T_Component>
+    T_Component * GetComponent () {
+        GameObjectComponent * component = GetComponent(T_Component::s_typeId);
+        ASSERT(!component || dynamic_cast<T_Component *>(component));
+        return static_cast<T_Component *>(component);
+    }
+
 };
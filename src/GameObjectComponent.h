@@ -22,23 +22,34 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.
 */
 
+#pragma once
+
+#include "Components/ComponentAccess.h"
+
 // GameObjectComponents must be guaranteed to not change address or delete while attached to a GameObject.
 class GameObjectComponent {
 public: // Types
     typedef unsigned GlobalTypeId;
     static const unsigned s_InvalidGlobalTypeId = 0;
 
+    // What Update touches on the owner (see EComponentData).  Component types
+    // override these; the conservative default keeps unknown types serial.
+    static const unsigned s_reads  = COMPONENT_DATA_GLOBAL;
+    static const unsigned s_writes = COMPONENT_DATA_GLOBAL;
+
 protected: // Data
     GlobalTypeId m_typeId;
     GameObject * m_owner;
+    bool         m_pooled; // Updated/rendered by a ComponentPool rather than by its owner
 
 public: // Methods
-    GameObjectComponent (GlobalTypeId typeId = s_InvalidGlobalTypeId) : m_typeId(typeId), m_owner(nullptr)
+    GameObjectComponent (GlobalTypeId typeId = s_InvalidGlobalTypeId) : m_typeId(typeId), m_owner(nullptr), m_pooled(false)
     {}
 
     GameObjectComponent (unsigned short moduleId, unsigned short componentTypeId) :
         m_typeId(moduleId << 16 | componentTypeId),
-        m_owner(nullptr)
+        m_owner(nullptr),
+        m_pooled(false)
     {}
 
     virtual ~GameObjectComponent () {}
@@ -46,9 +57,23 @@ public: // Methods
     virtual void Update (float dt) { ref(dt); }
     virtual void Render ()         {}
 
+    // Called whenever a sibling is attached to or detached from the owner.
+    // Components cache the siblings they depend on here rather than looking
+    // them up every Update.
+    virtual void OnSiblingsChanged () {}
+
+    // Rollback.  Components with state that can't be rebuilt from the owner's
+    // Transform and their siblings save it into world snapshots: GetStateSize
+    // bytes, written by SaveState and read back by LoadState.
+    virtual unsigned GetStateSize () const          { return 0; }
+    virtual void     SaveState (void * state) const { ref(state); }
+    virtual void     LoadState (const void * state) { ref(state); }
+
     GlobalTypeId GetGlobalTypeId () const      { return m_typeId; }
     unsigned short  GetLocalTypeId () const       { return m_typeId & 0xFFFF; }
     unsigned short  GetModuleId () const          { return m_typeId >> 16; }
     GameObject *    GetOwner ()                   { return m_owner; }
     void            SetOwner (GameObject * owner) { m_owner = owner; }
+    bool            IsPooled () const             { return m_pooled; }
+    void            SetPooled (bool pooled)       { m_pooled = pooled; }
 };
@@ -12,8 +12,17 @@ static const unsigned s_spriteFilesCount = arrsize(s_spriteFiles);
 
 static const char s_levelFile[] = "levels/level0.json";
 
-GameSpriteDemo::GameSpriteDemo(void)
-{}
+GameSpriteDemo::GameSpriteDemo(bool threadedSimulation) :
+    m_jobs(new JobSystem()),
+    m_renderBackend(&m_immediateBackend)
+{
+    m_simulation.SetComponentStore(&m_componentStore);
+    m_simulation.SetJobSystem(m_jobs.get());
+
+    // Fixed steps at the AGAM tick rate, which GocAgamBody assumes.
+    if (threadedSimulation)
+        m_simulationThread.reset(new SimulationThread(this, this, &m_snapshots, 1.0f / float(GocAgamBody::s_tickRate)));
+}
 
 
 GameSpriteDemo::~GameSpriteDemo(void)
@@ -25,26 +34,50 @@ GameSpriteDemo::~GameSpriteDemo(void)
 bool GameSpriteDemo::LoadContent(void)
 {
 
-    // Make every GameObject hot-reloadable when 'A' is pressed
+    // Registration order is update order.
+    m_componentStore.RegisterPool<GocTest>();
+    m_componentStore.RegisterPool<GocGamepad>();
+    m_componentStore.RegisterPool<GocSprite>();
+    m_componentStore.RegisterPool<GocAgamBody>();
+    m_componentStore.RegisterPool<GocJumpMan>();
+    m_componentStore.RegisterPool<GocLeverDashMan>();
+    m_componentStore.RegisterPool<GocBroadphaseProxy>();
+    m_componentStore.RegisterPool<GocCamera>();
+    m_componentStore.RegisterPool<GocLevel>();
+
+    GameObject * gameObjects[s_goCount];
+    for (unsigned i = 0; i < s_goCount; ++i) {
+        gameObjects[i] = m_gameObjects.Get(m_gameObjects.Emplace());
+        m_simulation.AddObject(gameObjects[i]);
+    }
+
+    // Make every GameObject hot-reloadable when Start is pressed.  Reloading
+    // touches graphics resources, which the simulation thread mustn't.
     for (unsigned i = 0; i < s_goCount; ++i) {
-        m_gameObjects[i].AddComponent(new GocTest());
-        m_gameObjects[i].AddComponent(new GocGamepad());
+        if (!m_simulationThread)
+            m_componentStore.Create<GocTest>(gameObjects[i]);
+        m_componentStore.Create<GocGamepad>(gameObjects[i])->SetSource(&m_padSource);
     }
 
     Vec3 sprite_pos(200.0f, 100.0f, 0.0f);
     for (unsigned i = 0;  i < s_spriteFilesCount && i < s_goCount;  ++i) {
-        GocSprite * sprite = new GocSprite();
-        m_gameObjects[i].AddComponent(sprite);
+        GocSprite * sprite = m_componentStore.Create<GocSprite>(gameObjects[i]);
         bool success = sprite->BuildFromDatafile(s_spriteFiles[i]);
         ASSERT(success);
 
-        m_gameObjects[i].AddComponent(new GocJumpMan());
-        m_gameObjects[i].AddComponent(new GocLeverDashMan());
+        // Bodies step a whole tick per Update, so they only keep time when
+        // the simulation thread runs fixed steps; serial mode follows the
+        // frame's dt with the controllers' float path.
+        if (m_simulationThread)
+            m_componentStore.Create<GocAgamBody>(gameObjects[i]);
+        m_componentStore.Create<GocJumpMan>(gameObjects[i]);
+        m_componentStore.Create<GocLeverDashMan>(gameObjects[i]);
+        m_componentStore.Create<GocBroadphaseProxy>(gameObjects[i])->SetBroadphase(&m_broadphase);
 
-        m_gameObjects[i].AddComponent(new GocCamera());
-        dynamic_cast<GocCamera *>(m_gameObjects[0].GetComponent(GOC_TYPE_CAMERA))->GetCamera().Setup();
+        m_componentStore.Create<GocCamera>(gameObjects[i]);
+        gameObjects[0]->GetComponent<GocCamera>()->GetCamera().Setup();
 
-        //m_gameObjects[i].AddComponent(new GocDebugLines());
+        //gameObjects[i]->AddComponent(new GocDebugLines());
 
         //////
         //
@@ -52,34 +85,38 @@ bool GameSpriteDemo::LoadContent(void)
             Vec3 scale;
             scale.x = scale.y = 1.6f;
             scale.z = 1.6f;
-            m_gameObjects[i].GetTransform().SetScale(scale);
+            gameObjects[i]->GetTransform().SetScale(scale);
         }
         //
         /////
 
-        m_gameObjects[i].GetTransform().SetPosition(sprite_pos);
+        gameObjects[i]->GetTransform().SetPosition(sprite_pos);
 
         sprite_pos.x += 100.0f;
         sprite_pos.y += 50.0f;
     }
 
-    dynamic_cast<GocCamera *>(m_gameObjects[0].GetComponent(GOC_TYPE_CAMERA))->SetAsActiveCamera();
+    gameObjects[0]->GetComponent<GocCamera>()->SetAsActiveCamera();
 
 
     // -- go3 --
     {
-        GameObject & go3 = m_gameObjects[s_goCount - 1];
+        GameObject & go3 = *gameObjects[s_goCount - 1];
         go3.GetTransform().SetPosition(Vec3(300.0f, 200.0f, 0.0f));
         //go3.GetTransform().SetScale(XMFLOAT2(3.0f, 3.0f));
 
-        GocLevel * level = new GocLevel();
-        go3.AddComponent(level);
+        GocLevel * level = m_componentStore.Create<GocLevel>(&go3);
         level->LoadLevel(s_levelFile);
 
 
         //go3.AddComponent(new GocDebugLines());
     }
 
+    if (m_simulationThread) {
+        m_renderCamera.Setup();
+        m_simulationThread->Start();
+    }
+
     return true;
 
 }
@@ -87,6 +124,9 @@ bool GameSpriteDemo::LoadContent(void)
 
 void GameSpriteDemo::UnloadContent(void)
 {
+
+    if (m_simulationThread)
+        m_simulationThread->Stop();
         
     g_graphicsMgr->Shutdown();
     
@@ -94,22 +134,96 @@ void GameSpriteDemo::UnloadContent(void)
 
 
 void GameSpriteDemo::Update(float dt)
+{
+    // The simulation thread steps the objects itself.
+    if (!m_simulationThread)
+        Step(dt);
+}
+
+
+void GameSpriteDemo::Step(float dt)
 {
     ++m_demoFrame;
 
-    for (unsigned i = 0; i < s_goCount; ++i) {
-        m_gameObjects[i].Update(dt);
-    }
+    m_simulation.Step(dt);
+
+    // Proxies moved during the step; pairs are as of its end.
+    m_broadphase.Rebuild();
+    m_broadphase.FindPairs(&m_actorPairs);
+
+    m_gameObjects.FlushDeferredRemoves();
 }
 
 
 void GameSpriteDemo::Render () {
 
-    g_graphicsMgr->RenderPre();
+    if (m_simulationThread) {
+        RenderLatestSnapshot();
+        return;
+    }
 
-    for (unsigned i = 0;  i < s_goCount;  ++i)
-        m_gameObjects[i].Render();
-    
-    g_graphicsMgr->RenderPost();
+    // Components record into the batcher; the backend then draws the sorted
+    // result (or, for profiling, just counts it).
+    RecordSprites();
+    m_renderBackend->BeginFrame();
+    m_spriteBatcher.Submit(m_renderBackend);
+    m_renderBackend->EndFrame();
+
+}
+
+
+void GameSpriteDemo::RecordSprites () {
+
+    m_spriteBatcher.Begin();
+    SpriteBatcher::SetActive(&m_spriteBatcher);
+    for (GameObject & go : m_gameObjects)
+        go.Render();
+    m_componentStore.RenderAll();
+    SpriteBatcher::SetActive(nullptr);
+
+}
+
+
+// Simulation thread.
+void GameSpriteDemo::RecordRender (unsigned tick, RenderSnapshot * snapshotOut) {
+
+    RecordSprites();
+
+    GocCamera * camera = GocCamera::GetActiveCamera();
+    if (camera) {
+        const Vec3 cameraPos = camera->GetCamera().GetPosition();
+        snapshotOut->Capture(m_spriteBatcher, &cameraPos, tick);
+    }
+    else
+        snapshotOut->Capture(m_spriteBatcher, nullptr, tick);
+
+}
+
+
+void GameSpriteDemo::RenderLatestSnapshot () {
+
+    m_snapshots.Acquire();
+    const RenderSnapshot * current = m_snapshots.GetCurrent();
+    if (!current)
+        return;
+
+    const RenderSnapshot * previous = m_snapshots.GetPrevious();
+    const float            alpha    = SnapshotRenderer::ComputeAlpha(previous, *current, Core::GetPerformanceCounter());
+    m_snapshotRenderer.Prepare(previous, *current, alpha);
+
+    // The simulation's camera keeps moving; draw from a render-side copy.
+    if (current->HasCamera()) {
+        m_renderCamera.SetPosition(m_snapshotRenderer.GetCameraPosition());
+        g_graphicsMgr->SetActiveCamera(&m_renderCamera);
+    }
+
+    m_snapshotRenderer.Submit(m_renderBackend);
+
+}
+
+
+void GameSpriteDemo::SetRenderBackend (IRenderBackend * backend) {
+
+    m_renderBackend = backend ? backend : &m_immediateBackend;
 
 }
@@ -1,11 +1,27 @@
 #pragma once
 
+#include <memory>
+
 #include "GameObject.h"
+#include "Collections/ObjectCollection.h"
+#include "Collision/Broadphase.h"
+#include "Components/ComponentStore.h"
+#include "Input/XInputGamepadSource.h"
+#include "Jobs/JobSystem.h"
+#include "Simulation/GameObjectSimulation.h"
+#include "Render/ImmediateRenderBackend.h"
+#include "Render/RenderSnapshot.h"
+#include "Simulation/SimulationThread.h"
 
-class GameSpriteDemo : public Dx11DemoBase
+// With threadedSimulation, GameObjects update at a fixed step on a simulation
+// thread that publishes render snapshots; Update does nothing and Render
+// draws the newest snapshot, interpolated.  Hot reload (GocTest) would touch
+// graphics resources from the simulation thread, so it's only attached in
+// the serial mode.  main.cpp turns this on with -threaded.
+class GameSpriteDemo : public Dx11DemoBase, private ISimulation, private IRenderRecorder
 {
  public:
-  GameSpriteDemo(void);
+  explicit GameSpriteDemo(bool threadedSimulation = false);
   virtual ~GameSpriteDemo(void);
   
   virtual bool LoadContent(void);
@@ -13,8 +29,46 @@ class GameSpriteDemo : public Dx11DemoBase
   
   virtual void Update(float dt);
   virtual void Render(void);
+
+  // Null restores the default backend, which draws through g_graphicsMgr.
+  void SetRenderBackend(IRenderBackend * backend);
  
  private:
-  static const unsigned s_goCount = 5;
-  GameObject m_gameObjects[s_goCount];
+  // ISimulation
+  void Step(float dt) override;
+
+  // IRenderRecorder
+  void RecordRender(unsigned tick, RenderSnapshot * snapshotOut) override;
+
+  void RecordSprites();
+  void RenderLatestSnapshot();
+
+  static const unsigned s_goCount    = 5;
+  static const unsigned s_goCapacity = 256;
+  CSaru::CInPlaceObjectCollection<GameObject, s_goCapacity> m_gameObjects;
+
+  // Every object's GocGamepad reads the one pad.
+  XInputGamepadSource m_padSource;
+
+  // Actor overlaps, re-indexed after every step.  GocBroadphaseProxy removes
+  // its proxy on destruction, so this outlives the component store.
+  Broadphase                    m_broadphase;
+  std::vector<Broadphase::Pair> m_actorPairs;
+
+  // Components live in per-type pools and are updated phase by phase across
+  // the job system's workers.  The store detaches them from their objects on
+  // destruction, so it's declared after m_gameObjects.
+  ComponentStore             m_componentStore;
+  std::unique_ptr<JobSystem> m_jobs;
+  GameObjectSimulation       m_simulation;
+
+  SpriteBatcher          m_spriteBatcher;
+  ImmediateRenderBackend m_immediateBackend;
+  IRenderBackend *       m_renderBackend;
+
+  // Threaded simulation only
+  std::unique_ptr<SimulationThread> m_simulationThread;
+  RenderSnapshotExchange            m_snapshots;
+  SnapshotRenderer                  m_snapshotRenderer;
+  Camera                            m_renderCamera;
 };
@@ -0,0 +1,89 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Christopher Higgins Barrett
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "HeadlessAgam.h"
+#include "../GameObject.h"
+#include "../GameObjectComponent.h"
+#include "../Components/ComponentStore.h"
+#include "../Render/SpritesheetDesc.h"
+#include "../ScratchComponents.h"
+#include "../ActionGameAlgorithmManiaxComponents.h"
+
+//==============================================================================
+void BuildAgamSheet (Spritesheet * sheetOut) {
+
+    const AnimName * const names[] = {
+        &AgamAnim::s_jump,
+        &AgamAnim::s_jumpCrest,
+        &AgamAnim::s_fall,
+        &AgamAnim::s_skid,
+        &AgamAnim::s_run,
+        &AgamAnim::s_walk,
+        &AgamAnim::s_idle,
+        &AgamAnim::s_stand,
+    };
+
+    SpritesheetDesc desc;
+    desc.name = "headless-agam";
+    desc.animations.resize(arrsize(names));
+    for (unsigned a = 0; a < arrsize(names); ++a) {
+        desc.animations[a].name = names[a]->text;
+        for (unsigned f = 0; f < 2; ++f) {
+            const SpritesheetFrameDesc frame = { f * 32, a * 48, 32, 48, 100 };
+            desc.animations[a].frames.push_back(frame);
+        }
+    }
+
+    sheetOut->BuildFromDesc(desc);
+
+}
+
+//==============================================================================
+void RegisterAgamPools (ComponentStore * store) {
+
+    store->RegisterPool<GocGamepad>();
+    store->RegisterPool<GocSprite>();
+    store->RegisterPool<GocAgamBody>();
+    store->RegisterPool<GocJumpMan>();
+    store->RegisterPool<GocLeverDashMan>();
+
+}
+
+//==============================================================================
+GocGamepad * CreateAgamPlayer (ComponentStore * store, GameObject * object, Spritesheet * sheet, IGamepadSource * source) {
+
+    GocGamepad * gamepad = store->Create<GocGamepad>(object);
+    gamepad->SetSource(source);
+
+    GocSprite * sprite = store->Create<GocSprite>(object);
+    sprite->GetSprite().SetSheet(sheet);
+    sprite->ClearAnimLookups();
+
+    store->Create<GocAgamBody>(object);
+    store->Create<GocJumpMan>(object);
+    store->Create<GocLeverDashMan>(object);
+
+    return gamepad;
+
+}
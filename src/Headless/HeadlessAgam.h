@@ -0,0 +1,45 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Christopher Higgins Barrett
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+// AGAM players for headless runs and tests: a stand-in for the player sheets,
+// which this build can't parse, and the component set the runner and tests
+// give every player.
+#pragma once
+
+class ComponentStore;
+class GameObject;
+class GocGamepad;
+class IGamepadSource;
+class Spritesheet;
+
+// Every animation the AGAM controllers switch to, two 32x48 frames each.
+void BuildAgamSheet (Spritesheet * sheetOut);
+
+// Registers pools for the components CreateAgamPlayer adds.
+void RegisterAgamPools (ComponentStore * store);
+
+// Adds GocGamepad (fed by source), GocSprite (drawing sheet), GocAgamBody,
+// GocJumpMan and GocLeverDashMan to object.  Returns the gamepad so callers
+// can record its input.
+GocGamepad * CreateAgamPlayer (ComponentStore * store, GameObject * object, Spritesheet * sheet, IGamepadSource * source);
@@ -0,0 +1,87 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Christopher Higgins Barrett
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "HeadlessCore.h"
+
+//==============================================================================
+Mtx44::Mtx44 () {
+
+    for (unsigned row = 0; row < 4; ++row) {
+        for (unsigned col = 0; col < 4; ++col)
+            m[row][col] = row == col ? 1.0f : 0.0f;
+    }
+
+}
+
+//==============================================================================
+Mtx44 Mtx44::operator* (const Mtx44 & rhs) const {
+
+    Mtx44 product;
+    for (unsigned row = 0; row < 4; ++row) {
+        for (unsigned col = 0; col < 4; ++col) {
+            product.m[row][col] =
+                m[row][0] * rhs.m[0][col] +
+                m[row][1] * rhs.m[1][col] +
+                m[row][2] * rhs.m[2][col] +
+                m[row][3] * rhs.m[3][col];
+        }
+    }
+
+    return product;
+
+}
+
+//==============================================================================
+void Mtx44::BuildTranslate (float x, float y, float z, Mtx44 * mtxOut) {
+
+    *mtxOut = Mtx44();
+    mtxOut->m[3][0] = x;
+    mtxOut->m[3][1] = y;
+    mtxOut->m[3][2] = z;
+
+}
+
+//==============================================================================
+void Mtx44::BuildRotateZ (float radians, Mtx44 * mtxOut) {
+
+    const float c = cosf(radians);
+    const float s = sinf(radians);
+
+    *mtxOut = Mtx44();
+    mtxOut->m[0][0] =  c;
+    mtxOut->m[0][1] =  s;
+    mtxOut->m[1][0] = -s;
+    mtxOut->m[1][1] =  c;
+
+}
+
+//==============================================================================
+void Mtx44::BuildScale (float x, float y, float z, Mtx44 * mtxOut) {
+
+    *mtxOut = Mtx44();
+    mtxOut->m[0][0] = x;
+    mtxOut->m[1][1] = y;
+    mtxOut->m[2][2] = z;
+
+}
@@ -0,0 +1,60 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Christopher Higgins Barrett
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+// Stand-ins for the parts of csaru-core-cpp the simulation uses: the assert
+// and min/max helpers, Vec3 and Mtx44.  Matrices are row-major and multiply
+// row vectors, like the engine's, so world matrices match it float for float.
+#pragma once
+
+#define ASSERT(exp) assert(exp)
+#define ref(x)      ((void)(x))
+#define MIN(a, b)   ((a) < (b) ? (a) : (b))
+#define MAX(a, b)   ((a) > (b) ? (a) : (b))
+
+template <typename T, size_t N>
+char (&ArraySizeHelper (T (&array)[N]))[N];
+#define arrsize(array) (sizeof(ArraySizeHelper(array)))
+
+//==============================================================================
+struct Vec3 {
+    float x;
+    float y;
+    float z;
+
+    Vec3 () : x(0.0f), y(0.0f), z(0.0f) {}
+    Vec3 (float x, float y, float z) : x(x), y(y), z(z) {}
+};
+
+//==============================================================================
+struct Mtx44 {
+    float m[4][4];
+
+    Mtx44 (); // Identity
+
+    Mtx44 operator* (const Mtx44 & rhs) const;
+
+    static void BuildTranslate (float x, float y, float z, Mtx44 * mtxOut);
+    static void BuildRotateZ (float radians, Mtx44 * mtxOut);
+    static void BuildScale (float x, float y, float z, Mtx44 * mtxOut);
+};
@@ -0,0 +1,50 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Christopher Higgins Barrett
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+// The headless build has no JSON parser, so the datafile readers in
+// Levels/LevelDatafile.cpp and Render/SpritesheetDatafile.cpp are replaced
+// with ones that always fail.  Levels and sheets load from their cooked files
+// instead; cook them with a full build.
+
+#include "../Levels/Level.hpp"
+#include "../Render/SpritesheetDesc.h"
+
+//==============================================================================
+bool Level::ParseDatafile (const char * filepath, Desc * descOut, std::vector<unsigned short> * tilesOut) {
+
+    ref(filepath);
+    ref(descOut);
+    ref(tilesOut);
+    return false;
+
+}
+
+//==============================================================================
+bool ParseSpritesheetDatafile (const char * filepath, SpritesheetDesc * descOut) {
+
+    ref(filepath);
+    ref(descOut);
+    return false;
+
+}
@@ -0,0 +1,222 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Christopher Higgins Barrett
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "HeadlessGraphics.h"
+#include "../Render/SpritesheetFile.h"
+
+namespace {
+
+//==============================================================================
+class HeadlessGraphicsMgr final : public IGraphicsMgr {
+private: // Data
+    std::map<std::string, std::unique_ptr<Spritesheet>> m_sheets;
+
+public: // IGraphicsMgr
+    Spritesheet * LoadSpritesheet (const char * datafilePath) override {
+
+        std::unique_ptr<Spritesheet> & sheet = m_sheets[datafilePath];
+        if (!sheet) {
+            sheet.reset(new Spritesheet);
+            if (!sheet->BuildFromDatafile(datafilePath)) {
+                m_sheets.erase(datafilePath);
+                return nullptr;
+            }
+        }
+
+        return sheet.get();
+
+    }
+
+    void SetActiveCamera (Camera * camera) override { ref(camera); }
+    void RenderPre () override                      {}
+    void RenderPost () override                     {}
+    void Shutdown () override                       { m_sheets.clear(); }
+};
+
+HeadlessGraphicsMgr s_graphicsMgr;
+
+} // namespace
+
+IGraphicsMgr * g_graphicsMgr = &s_graphicsMgr;
+
+
+//==============================================================================
+// Spritesheet
+//==============================================================================
+
+//==============================================================================
+bool Spritesheet::BuildFromDesc (const SpritesheetDesc & desc) {
+
+    m_animations.clear();
+    m_animations.resize(desc.animations.size());
+    for (unsigned a = 0; a < desc.animations.size(); ++a) {
+        const SpritesheetAnimDesc & animDesc  = desc.animations[a];
+        Animation &                 animation = m_animations[a];
+
+        animation.name.assign(animDesc.name.begin(), animDesc.name.end());
+        for (const SpritesheetFrameDesc & frameDesc : animDesc.frames) {
+            SpritesheetFrame frame;
+            frame.x          = frameDesc.x;
+            frame.y          = frameDesc.y;
+            frame.width      = frameDesc.width;
+            frame.height     = frameDesc.height;
+            frame.durationMs = frameDesc.durationMs;
+            animation.frames.push_back(frame);
+        }
+    }
+
+    return true;
+
+}
+
+//==============================================================================
+// Cooks first where the datafile can be parsed; a cooked file shipped without
+// its datafile is used as is.
+bool Spritesheet::BuildFromDatafile (const char * datafilePath) {
+
+    m_datafilePath = datafilePath;
+
+    CookedSpritesheet cooked;
+    if (!cooked.OpenFromDatafile(datafilePath) && !cooked.Open(SpritesheetFile::GetCookedPath(datafilePath).c_str()))
+        return false;
+
+    SpritesheetDesc desc;
+    desc.name      = cooked.GetName();
+    desc.imageFile = cooked.GetImageFile();
+    desc.animations.resize(cooked.GetAnimCount());
+    for (unsigned a = 0; a < cooked.GetAnimCount(); ++a) {
+        desc.animations[a].name = cooked.GetAnimName(a);
+
+        unsigned                       frameCount;
+        const SpritesheetFile::Frame * frames = cooked.GetFrames(a, &frameCount);
+        for (unsigned f = 0; f < frameCount; ++f) {
+            SpritesheetFrameDesc frame;
+            frame.x          = frames[f].x;
+            frame.y          = frames[f].y;
+            frame.width      = frames[f].width;
+            frame.height     = frames[f].height;
+            frame.durationMs = frames[f].durationMs;
+            desc.animations[a].frames.push_back(frame);
+        }
+    }
+
+    return BuildFromDesc(desc);
+
+}
+
+//==============================================================================
+bool Spritesheet::RebuildFromDatafile () {
+
+    if (m_datafilePath.empty())
+        return false;
+
+    const std::string datafilePath = m_datafilePath;
+    return BuildFromDatafile(datafilePath.c_str());
+
+}
+
+//==============================================================================
+unsigned Spritesheet::GetAnimationIndex (const wchar_t * name) const {
+
+    for (unsigned i = 0; i < m_animations.size(); ++i) {
+        if (m_animations[i].name == name)
+            return i;
+    }
+
+    return unsigned(-1);
+
+}
+
+//==============================================================================
+unsigned Spritesheet::GetFrameCount (unsigned animIndex) const {
+    return animIndex < m_animations.size() ? unsigned(m_animations[animIndex].frames.size()) : 0;
+}
+
+//==============================================================================
+const SpritesheetFrame * Spritesheet::GetFrame (unsigned animIndex, unsigned frameIndex) const {
+
+    if (frameIndex >= GetFrameCount(animIndex))
+        return nullptr;
+
+    return &m_animations[animIndex].frames[frameIndex];
+
+}
+
+
+//==============================================================================
+// SpriteAnimation
+//==============================================================================
+
+//==============================================================================
+SpriteAnimation::SpriteAnimation () :
+    m_sheet(nullptr),
+    m_animIndex(0),
+    m_frameIndex(0),
+    m_timeOnFrameSeconds(0.0f)
+{}
+
+//==============================================================================
+void SpriteAnimation::SetSheet (Spritesheet * sheet) {
+
+    m_sheet              = sheet;
+    m_animIndex          = 0;
+    m_frameIndex         = 0;
+    m_timeOnFrameSeconds = 0.0f;
+
+}
+
+//==============================================================================
+void SpriteAnimation::SetAnimIndex (unsigned animIndex) {
+
+    m_animIndex          = animIndex;
+    m_frameIndex         = 0;
+    m_timeOnFrameSeconds = 0.0f;
+
+}
+
+//==============================================================================
+// Frames without a duration hold until the animation changes.
+void SpriteAnimation::Update (float dt) {
+
+    const SpritesheetFrame * frame = GetCurrentFrame();
+    if (!frame || !frame->durationMs)
+        return;
+
+    m_timeOnFrameSeconds += dt;
+    for (;;) {
+        frame = GetCurrentFrame();
+        const float duration = float(frame->durationMs) * 0.001f;
+        if (!frame->durationMs || m_timeOnFrameSeconds < duration)
+            break;
+
+        m_timeOnFrameSeconds -= duration;
+        m_frameIndex          = (m_frameIndex + 1) % m_sheet->GetFrameCount(m_animIndex);
+    }
+
+}
+
+//==============================================================================
+const SpritesheetFrame * SpriteAnimation::GetCurrentFrame () const {
+    return m_sheet ? m_sheet->GetFrame(m_animIndex, m_frameIndex) : nullptr;
+}
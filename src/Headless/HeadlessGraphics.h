@@ -0,0 +1,123 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Christopher Higgins Barrett
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+// Stand-ins for the csaru-dx11_graphics-cpp types the simulation touches:
+// sheets, sprite animations, cameras and g_graphicsMgr.  Nothing is drawn.
+// Sheets come from cooked (.cspr) files, cooking the datafile first where
+// this build can parse it, so animation indices and frame sizes match the
+// real sheets and gameplay that reads them behaves the same headless.
+#pragma once
+
+#include <memory>
+
+struct SpritesheetDesc;
+
+//==============================================================================
+struct SpritesheetFrame {
+    unsigned x;
+    unsigned y;
+    unsigned width;
+    unsigned height;
+    unsigned durationMs;
+};
+
+//==============================================================================
+class Spritesheet {
+private: // Types
+    struct Animation {
+        std::wstring                  name;
+        std::vector<SpritesheetFrame> frames;
+    };
+
+private: // Data
+    std::string            m_datafilePath;
+    std::vector<Animation> m_animations;
+
+public:
+    // Commands
+    bool BuildFromDesc (const SpritesheetDesc & desc);
+    bool BuildFromDatafile (const char * datafilePath);
+    bool RebuildFromDatafile ();
+
+    // Queries
+    unsigned                 GetAnimationCount () const { return unsigned(m_animations.size()); }
+    unsigned                 GetAnimationIndex (const wchar_t * name) const; // unsigned(-1) if missing
+    unsigned                 GetAnimationIndex (const std::wstring & name) const { return GetAnimationIndex(name.c_str()); }
+    unsigned                 GetFrameCount (unsigned animIndex) const;
+    const SpritesheetFrame * GetFrame (unsigned animIndex, unsigned frameIndex) const;
+};
+
+//==============================================================================
+class SpriteAnimation {
+private: // Data
+    Spritesheet * m_sheet;
+    unsigned      m_animIndex;
+    unsigned      m_frameIndex;
+    float         m_timeOnFrameSeconds;
+
+public:
+    SpriteAnimation ();
+
+    // Commands
+    void SetSheet (Spritesheet * sheet);
+    void SetAnimIndex (unsigned animIndex);
+    void SetFrameIndex (unsigned frameIndex)                  { m_frameIndex = frameIndex; }
+    void SetTimeOnFrameSeconds (float seconds)                { m_timeOnFrameSeconds = seconds; }
+    void Update (float dt);
+    void Render (const Mtx44 & worldFromModelMtx) const       { ref(worldFromModelMtx); }
+
+    // Queries
+    Spritesheet *            GetSheet () const                { return m_sheet; }
+    unsigned                 GetAnimationIndex () const       { return m_animIndex; }
+    unsigned                 GetFrameIndex () const           { return m_frameIndex; }
+    float                    GetTimeOnFrameSeconds () const   { return m_timeOnFrameSeconds; }
+    const SpritesheetFrame * GetCurrentFrame () const;
+};
+
+//==============================================================================
+class Camera {
+private: // Data
+    Vec3 m_position;
+
+public:
+    void Setup () {}
+
+    void         SetPosition (const Vec3 & position) { m_position = position; }
+    const Vec3 & GetPosition () const                { return m_position; }
+};
+
+//==============================================================================
+class IGraphicsMgr {
+public:
+    virtual ~IGraphicsMgr () {}
+
+    // Sheets are cached by path; null if the sheet can't be loaded.
+    virtual Spritesheet * LoadSpritesheet (const char * datafilePath) = 0;
+    virtual void          SetActiveCamera (Camera * camera) = 0;
+    virtual void          RenderPre () = 0;
+    virtual void          RenderPost () = 0;
+    virtual void          Shutdown () = 0;
+};
+
+extern IGraphicsMgr * g_graphicsMgr;
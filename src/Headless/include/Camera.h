@@ -0,0 +1,4 @@
+// The headless build's stand-in for the graphics library header.
+#pragma once
+
+#include "../HeadlessGraphics.h"
@@ -0,0 +1,272 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Christopher Higgins Barrett
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "GamepadInput.h"
+
+#include <cstdio>
+
+namespace {
+
+const unsigned s_stateBytes = 4;
+
+//==============================================================================
+void WriteUint32 (std::uint32_t value, FILE * file) {
+
+    const unsigned char bytes[] = {
+        (unsigned char)(value),
+        (unsigned char)(value >> 8),
+        (unsigned char)(value >> 16),
+        (unsigned char)(value >> 24)
+    };
+    fwrite(bytes, 1, sizeof(bytes), file);
+
+}
+
+//==============================================================================
+bool ReadUint32 (FILE * file, std::uint32_t * valueOut) {
+
+    unsigned char bytes[4];
+    if (fread(bytes, 1, sizeof(bytes), file) != sizeof(bytes))
+        return false;
+
+    *valueOut = std::uint32_t(bytes[0]) | std::uint32_t(bytes[1]) << 8 | std::uint32_t(bytes[2]) << 16 | std::uint32_t(bytes[3]) << 24;
+    return true;
+
+}
+
+} // namespace
+
+//==============================================================================
+std::int16_t GamepadState::QuantizeAxis (float value) {
+
+    value = MAX(-1.0f, MIN(value, 1.0f)) * 32767.0f;
+    return std::int16_t(value < 0.0f ? value - 0.5f : value + 0.5f);
+
+}
+
+//==============================================================================
+GamepadLog::GamepadLog () :
+    m_frameCount(0),
+    m_lastChangeFrame(0)
+{}
+
+//==============================================================================
+void GamepadLog::Clear () {
+
+    m_bytes.clear();
+    m_frameCount      = 0;
+    m_lastChangeFrame = 0;
+    m_lastState       = GamepadState();
+
+}
+
+//==============================================================================
+void GamepadLog::Append (const GamepadState & state) {
+
+    if (m_frameCount && state == m_lastState) {
+        ++m_frameCount;
+        return;
+    }
+
+    unsigned gap = m_frameCount - m_lastChangeFrame;
+    while (gap >= 0x80) {
+        m_bytes.push_back((unsigned char)(gap | 0x80));
+        gap >>= 7;
+    }
+    m_bytes.push_back((unsigned char)gap);
+
+    m_bytes.push_back((unsigned char)(state.buttons));
+    m_bytes.push_back((unsigned char)(state.buttons >> 8));
+    m_bytes.push_back((unsigned char)(std::uint16_t(state.leftStickX)));
+    m_bytes.push_back((unsigned char)(std::uint16_t(state.leftStickX) >> 8));
+
+    m_lastChangeFrame = m_frameCount;
+    m_lastState       = state;
+    ++m_frameCount;
+
+}
+
+//==============================================================================
+bool GamepadLog::Save (const char * filepath) const {
+
+    FILE * out = Core::OpenFile(filepath, "wb");
+    if (!out)
+        return false;
+
+    WriteUint32(s_magic, out);
+    WriteUint32(s_version, out);
+    WriteUint32(m_frameCount, out);
+    WriteUint32(std::uint32_t(m_bytes.size()), out);
+    const bool ok = m_bytes.empty() || fwrite(&m_bytes[0], 1, m_bytes.size(), out) == m_bytes.size();
+    fclose(out);
+
+    return ok;
+
+}
+
+//==============================================================================
+bool GamepadLog::Load (const char * filepath) {
+
+    Clear();
+
+    FILE * in = Core::OpenFile(filepath, "rb");
+    if (!in)
+        return false;
+
+    std::uint32_t magic;
+    std::uint32_t version;
+    std::uint32_t frameCount;
+    std::uint32_t byteCount;
+    bool ok = ReadUint32(in, &magic)
+        && ReadUint32(in, &version)
+        && ReadUint32(in, &frameCount)
+        && ReadUint32(in, &byteCount)
+        && magic == s_magic
+        && version == s_version;
+
+    if (ok) {
+        m_bytes.resize(byteCount);
+        ok = !byteCount || fread(&m_bytes[0], 1, byteCount, in) == byteCount;
+    }
+    fclose(in);
+
+    if (!ok) {
+        Clear();
+        return false;
+    }
+
+    // Only replayed, never appended to, so the append state can stay stale.
+    m_frameCount = frameCount;
+    return true;
+
+}
+
+//==============================================================================
+GamepadReplaySource::GamepadReplaySource (const GamepadLog * log) :
+    m_log(log)
+{
+    ASSERT(log);
+    Rewind();
+}
+
+//==============================================================================
+void GamepadReplaySource::Rewind () {
+
+    m_cursor          = m_log->GetBytes().data();
+    m_frame           = 0;
+    m_nextChangeFrame = 0;
+    m_state           = GamepadState();
+    ReadNextChange();
+
+}
+
+//==============================================================================
+// Reads the gap to the next change; past the end, no change ever comes.
+void GamepadReplaySource::ReadNextChange () {
+
+    const unsigned char * end = m_log->GetBytes().data() + m_log->GetBytes().size();
+    if (m_cursor >= end) {
+        m_nextChangeFrame = unsigned(-1);
+        return;
+    }
+
+    unsigned gap = 0;
+    for (unsigned shift = 0; m_cursor < end; shift += 7) {
+        const unsigned char byte = *m_cursor++;
+        gap |= unsigned(byte & 0x7f) << shift;
+        if (!(byte & 0x80))
+            break;
+    }
+
+    m_nextChangeFrame += gap;
+
+}
+
+//==============================================================================
+bool GamepadReplaySource::NextState (GamepadState * stateOut) {
+
+    if (m_frame >= m_log->GetFrameCount()) {
+        *stateOut = GamepadState();
+        return false;
+    }
+
+    const unsigned char * end = m_log->GetBytes().data() + m_log->GetBytes().size();
+    if (m_frame == m_nextChangeFrame && m_cursor + s_stateBytes <= end) {
+        m_state.buttons    = std::uint16_t(m_cursor[0] | m_cursor[1] << 8);
+        m_state.leftStickX = std::int16_t(std::uint16_t(m_cursor[2] | m_cursor[3] << 8));
+        m_cursor += s_stateBytes;
+        ReadNextChange();
+    }
+
+    ++m_frame;
+    *stateOut = m_state;
+    return true;
+
+}
+
+//==============================================================================
+SyntheticGamepadSource::SyntheticGamepadSource (std::uint32_t seed, unsigned frameLimit) :
+    m_random(seed ? seed : 1),
+    m_frame(0),
+    m_frameLimit(frameLimit),
+    m_holdFrames(0)
+{}
+
+//==============================================================================
+// xorshift32
+unsigned SyntheticGamepadSource::NextRandom () {
+
+    m_random ^= m_random << 13;
+    m_random ^= m_random >> 17;
+    m_random ^= m_random << 5;
+    return m_random;
+
+}
+
+//==============================================================================
+bool SyntheticGamepadSource::NextState (GamepadState * stateOut) {
+
+    if (m_frameLimit && m_frame >= m_frameLimit) {
+        *stateOut = GamepadState();
+        return false;
+    }
+    ++m_frame;
+
+    if (!m_holdFrames) {
+        static const std::int16_t s_directions[] = { -32767, 0, 32767 };
+        m_state.leftStickX = s_directions[NextRandom() % arrsize(s_directions)];
+        m_holdFrames       = 15 + NextRandom() % 120;
+    }
+    --m_holdFrames;
+
+    // Taps last a few frames so edge-triggered logic sees them.
+    if (m_state.buttons)
+        m_state.buttons = NextRandom() % 4 ? m_state.buttons : 0;
+    else if (NextRandom() % 60 == 0)
+        m_state.buttons = GamepadState::BUTTON_A;
+
+    *stateOut = m_state;
+    return true;
+
+}
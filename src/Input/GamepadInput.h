@@ -0,0 +1,154 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Christopher Higgins Barrett
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include <cstdint>
+
+//==============================================================================
+// One frame of gamepad input, as far as gameplay reads it.  Sticks are
+// quantized so live, recorded and replayed input drive the simulation with
+// bit-identical values.
+struct GamepadState {
+    // Same bits as XInput's XINPUT_GAMEPAD_* flags
+    enum EButton : std::uint16_t {
+        BUTTON_DPAD_UP        = 0x0001,
+        BUTTON_DPAD_DOWN      = 0x0002,
+        BUTTON_DPAD_LEFT      = 0x0004,
+        BUTTON_DPAD_RIGHT     = 0x0008,
+        BUTTON_START          = 0x0010,
+        BUTTON_BACK           = 0x0020,
+        BUTTON_LEFT_THUMB     = 0x0040,
+        BUTTON_RIGHT_THUMB    = 0x0080,
+        BUTTON_LEFT_SHOULDER  = 0x0100,
+        BUTTON_RIGHT_SHOULDER = 0x0200,
+        BUTTON_A              = 0x1000,
+        BUTTON_B              = 0x2000,
+        BUTTON_X              = 0x4000,
+        BUTTON_Y              = 0x8000,
+    };
+
+    std::uint16_t buttons;    // EButton bits
+    std::int16_t  leftStickX; // [-32767, 32767]
+
+    GamepadState () : buttons(0), leftStickX(0) {}
+
+    bool operator== (const GamepadState & rhs) const { return buttons == rhs.buttons && leftStickX == rhs.leftStickX; }
+    bool operator!= (const GamepadState & rhs) const { return !(*this == rhs); }
+
+    static std::int16_t QuantizeAxis (float value);
+    static float        AxisToFloat (std::int16_t value) { return float(value) * (1.0f / 32767.0f); }
+};
+
+
+//==============================================================================
+// Where GocGamepad gets each frame's input: the pad (XInputGamepadSource, on
+// Windows), a replay or synthetic play.
+class IGamepadSource {
+public:
+    virtual ~IGamepadSource () {}
+
+    // Produces the next frame's state.  Returns false once the source has
+    // nothing more to play; stateOut is then the neutral state.
+    virtual bool NextState (GamepadState * stateOut) = 0;
+};
+
+
+//==============================================================================
+// Per-frame input, stored only where it changes: a varint count of frames
+// since the previous change, then the new state (4 bytes).  A minute of
+// ordinary play is a few hundred bytes.
+//
+// File layout (little-endian): "GPAD", version, frame count, byte count, then
+// the encoded bytes.
+class GamepadLog {
+public: // Constants
+    static const std::uint32_t s_magic   = 'G' | 'P' << 8 | 'A' << 16 | 'D' << 24;
+    static const std::uint32_t s_version = 1;
+
+private: // Data
+    std::vector<unsigned char> m_bytes;
+    unsigned                   m_frameCount;
+    unsigned                   m_lastChangeFrame;
+    GamepadState               m_lastState;
+
+public:
+    GamepadLog ();
+
+    // Commands
+    void Clear ();
+    void Append (const GamepadState & state);
+    bool Save (const char * filepath) const;
+    bool Load (const char * filepath);
+
+    // Queries
+    unsigned                           GetFrameCount () const { return m_frameCount; }
+    const std::vector<unsigned char> & GetBytes () const      { return m_bytes; }
+};
+
+
+//==============================================================================
+// Plays a GamepadLog back frame by frame.  The log must outlive the source.
+class GamepadReplaySource : public IGamepadSource {
+private: // Data
+    const GamepadLog *    m_log;
+    const unsigned char * m_cursor;
+    unsigned              m_frame;
+    unsigned              m_nextChangeFrame;
+    GamepadState          m_state;
+
+private: // Helpers
+    void ReadNextChange ();
+
+public:
+    explicit GamepadReplaySource (const GamepadLog * log);
+
+    void     Rewind ();
+    unsigned GetFrame () const { return m_frame; }
+
+    bool NextState (GamepadState * stateOut) override;
+};
+
+
+//==============================================================================
+// Seeded pseudo-random play: the stick is held one way or at rest for a
+// while, with occasional taps of A.  Identical seeds give identical input, so
+// long headless runs need no recorded log.
+class SyntheticGamepadSource : public IGamepadSource {
+private: // Data
+    std::uint32_t m_random;
+    unsigned      m_frame;
+    unsigned      m_frameLimit;
+    unsigned      m_holdFrames; // Left on the current stick direction
+    GamepadState  m_state;
+
+private: // Helpers
+    unsigned NextRandom ();
+
+public:
+    // A frame limit of 0 never runs out.
+    explicit SyntheticGamepadSource (std::uint32_t seed, unsigned frameLimit = 0);
+
+    bool NextState (GamepadState * stateOut) override;
+};
@@ -0,0 +1,42 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Christopher Higgins Barrett
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "XInputGamepadSource.h"
+
+//==============================================================================
+bool XInputGamepadSource::NextState (GamepadState * stateOut) {
+
+    m_gamepad.Update();
+
+    // XInputGamepad's flags are XInput's own bits, as GamepadState's are.
+    *stateOut = GamepadState();
+    for (unsigned i = 0; i < 16; ++i) {
+        if (m_gamepad.AreButtonsPressed(XInputGamepad::EButtonFlags(1 << i)))
+            stateOut->buttons |= std::uint16_t(1 << i);
+    }
+    stateOut->leftStickX = GamepadState::QuantizeAxis(m_gamepad.GetLeftStickXAsFloat());
+
+    return true;
+
+}
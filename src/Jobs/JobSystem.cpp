@@ -0,0 +1,170 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Christopher Higgins Barrett
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "JobSystem.h"
+
+//==============================================================================
+JobSystem::JobSystem (unsigned workerCount) :
+    m_queues(nullptr),
+    m_queueCount(0),
+    m_nextQueue(0),
+    m_queuedJobs(0),
+    m_quit(false)
+{
+
+    if (!workerCount) {
+        const unsigned hardwareThreads = std::thread::hardware_concurrency();
+        workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+    }
+
+    m_queueCount = workerCount + 1;
+    m_queues     = new WorkQueue[m_queueCount];
+
+    for (unsigned i = 0; i < workerCount; ++i)
+        m_threads.push_back(std::thread(&JobSystem::WorkerMain, this, i + 1));
+
+}
+
+//==============================================================================
+JobSystem::~JobSystem () {
+
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_quit = true;
+    }
+    m_wake.notify_all();
+
+    for (std::thread & thread : m_threads)
+        thread.join();
+    m_threads.clear();
+
+    delete [] m_queues;
+    m_queues = nullptr;
+
+}
+
+//==============================================================================
+void JobSystem::Dispatch (JobFunc func, void * context, unsigned count, unsigned batchSize, JobCounter * counter) {
+
+    ASSERT(func && counter);
+    if (!batchSize)
+        batchSize = 1;
+
+    const unsigned batchCount = (count + batchSize - 1) / batchSize;
+    counter->remaining.fetch_add(batchCount);
+
+    // Each job is counted under its queue's lock, once it can be popped, so
+    // idle workers only wake for jobs that are really there, and the pop (and
+    // decrement) of a job can't come before its increment.
+    for (unsigned batch = 0; batch < batchCount; ++batch) {
+        Job job;
+        job.func    = func;
+        job.context = context;
+        job.begin   = batch * batchSize;
+        job.end     = MIN(job.begin + batchSize, count);
+        job.counter = counter;
+
+        WorkQueue & queue = m_queues[m_nextQueue.fetch_add(1) % m_queueCount];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.jobs.push_back(job);
+        m_queuedJobs.fetch_add(1);
+    }
+
+    // Taking the wake mutex orders the notify after any worker that checked
+    // the count before it went up has started waiting.
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+    }
+    m_wake.notify_all();
+
+}
+
+//==============================================================================
+bool JobSystem::PopLocal (unsigned queueIndex, Job * jobOut) {
+
+    WorkQueue & queue = m_queues[queueIndex];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.jobs.empty())
+        return false;
+
+    *jobOut = queue.jobs.back();
+    queue.jobs.pop_back();
+    return true;
+
+}
+
+//==============================================================================
+bool JobSystem::Steal (unsigned thiefIndex, Job * jobOut) {
+
+    for (unsigned i = 1; i < m_queueCount; ++i) {
+        WorkQueue & queue = m_queues[(thiefIndex + i) % m_queueCount];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.jobs.empty())
+            continue;
+
+        *jobOut = queue.jobs.front();
+        queue.jobs.pop_front();
+        return true;
+    }
+
+    return false;
+
+}
+
+//==============================================================================
+bool JobSystem::TryRunOne (unsigned queueIndex) {
+
+    Job job;
+    if (!PopLocal(queueIndex, &job) && !Steal(queueIndex, &job))
+        return false;
+
+    m_queuedJobs.fetch_sub(1);
+    job.func(job.context, job.begin, job.end);
+    job.counter->remaining.fetch_sub(1, std::memory_order_release);
+    return true;
+
+}
+
+//==============================================================================
+void JobSystem::Wait (JobCounter * counter) {
+
+    while (counter->remaining.load(std::memory_order_acquire)) {
+        if (!TryRunOne(0))
+            std::this_thread::yield();
+    }
+
+}
+
+//==============================================================================
+void JobSystem::WorkerMain (unsigned queueIndex) {
+
+    while (!m_quit) {
+        if (TryRunOne(queueIndex))
+            continue;
+
+        std::unique_lock<std::mutex> lock(m_wakeMutex);
+        m_wake.wait(lock, [this] { return m_quit || m_queuedJobs.load() != 0; });
+    }
+
+}
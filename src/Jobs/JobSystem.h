@@ -0,0 +1,111 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Christopher Higgins Barrett
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+//==============================================================================
+// Small work-stealing scheduler.  Each worker owns a queue it pops from the
+// back of; idle workers steal from the front of the others.  Dispatch spreads
+// batches round-robin over every queue, and Wait runs jobs on the calling
+// thread until the counter drains, so nested dispatches can't deadlock.
+class JobSystem {
+public: // Types
+    typedef void (*JobFunc)(void * context, unsigned begin, unsigned end);
+
+    struct JobCounter {
+        std::atomic<unsigned> remaining;
+
+        JobCounter () : remaining(0) {}
+    };
+
+private: // Types
+    struct Job {
+        JobFunc      func;
+        void *       context;
+        unsigned     begin;
+        unsigned     end;
+        JobCounter * counter;
+    };
+
+    struct WorkQueue {
+        std::mutex      mutex;
+        std::deque<Job> jobs;
+    };
+
+    template <typename T_Func>
+    static void InvokeRange (void * context, unsigned begin, unsigned end) {
+        (*static_cast<T_Func *>(context))(begin, end);
+    }
+
+private: // Data
+    std::vector<std::thread> m_threads;
+    WorkQueue *              m_queues; // [0] belongs to external callers, [1..] to workers
+    unsigned                 m_queueCount;
+    std::atomic<unsigned>    m_nextQueue;
+    std::atomic<unsigned>    m_queuedJobs;
+    std::atomic<bool>        m_quit;
+    std::mutex               m_wakeMutex;
+    std::condition_variable  m_wake;
+
+private: // Helpers
+    bool PopLocal (unsigned queueIndex, Job * jobOut);
+    bool Steal (unsigned thiefIndex, Job * jobOut);
+    bool TryRunOne (unsigned queueIndex);
+    void WorkerMain (unsigned queueIndex);
+
+public:
+    // workerCount == 0 uses one worker per hardware thread, minus the caller.
+    explicit JobSystem (unsigned workerCount = 0);
+    ~JobSystem ();
+
+    // Splits [0, count) into batchSize ranges and queues them; counter is
+    // incremented per batch and decremented as each finishes.
+    void Dispatch (JobFunc func, void * context, unsigned count, unsigned batchSize, JobCounter * counter);
+    void Wait (JobCounter * counter);
+
+    // Runs func(begin, end) over [0, count) across all workers and returns
+    // once every batch has finished.
+    template <typename T_Func>
+    void ParallelFor (unsigned count, unsigned batchSize, T_Func & func) {
+        if (!count)
+            return;
+
+        if (m_threads.empty() || count <= batchSize) {
+            func(0u, count);
+            return;
+        }
+
+        JobCounter counter;
+        Dispatch(&InvokeRange<T_Func>, &func, count, batchSize, &counter);
+        Wait(&counter);
+    }
+
+    unsigned GetWorkerCount () const { return unsigned(m_threads.size()); }
+};
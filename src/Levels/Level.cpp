@@ -23,127 +23,165 @@ SOFTWARE.
 */
 
 #include "Level.hpp"
+#include "LevelStreamer.hpp"
+#include "LevelFile.hpp"
+#include "../MappedFile.h"
+#include "../AnimName.h"
+#include "../Render/SpritesheetFile.h"
 
-#include <DataMap.hpp>
-#include <JsonParserCallbackForDataMap.hpp>
-#include <DataMapReaderSimple.hpp>
 #include <Spritesheet.h>
 
+#include <cfloat>
+#include <memory>
+
+#include "../TransformBatch.h"
+#include "../Render/SpriteBatcher.h"
+
 //==============================================================================
 Level::Level () :
     m_width(0),
     m_height(0),
-    m_tiles(nullptr)
+    m_chunksWide(0),
+    m_chunksHigh(0),
+    m_mappedFile(nullptr),
+    m_streamer(nullptr),
+    m_editBase(0)
 {}
 
 //==============================================================================
-bool Level::BuildFromDatafile (const char * filepath) {
-    
+Level::~Level () {
     Reset();
+}
 
-    CSaruContainer::DataMap                 dataMap;
-    CSaruJson::JsonParserCallbackForDataMap callback(dataMap.GetMutator());
+//==============================================================================
+bool Level::BuildFromDesc (const Desc & desc) {
 
-    FILE * file;
-    fopen_s(&file, filepath, "rt");
-    
-    CSaruJson::JsonParser parser;
-    if (!parser.ParseEntireFile(
-        file,
-        NULL,
-        0,
-        &callback
-    )) {
-        ASSERT(0 && "Failed to parse spritesheet file.");
-        fclose(file);
+    if (!desc.width || !desc.height || desc.legend.empty())
         return false;
+
+    m_name = desc.name;
+    Resize(desc.width, desc.height);
+
+    // Legends mostly share a few tilesets.  Each tileset's cooked file is
+    // opened (and recooked if stale) once, and legend animations are found
+    // by name id there instead of by string in the sheet.  The cooked anim
+    // table is in datafile order, so its indices are the sheet's.
+    std::map<std::string, std::unique_ptr<CookedSpritesheet>> cookedSheets;
+
+    m_legend.clear();
+    m_legend.resize(desc.legend.size());
+    for (unsigned i = 0; i < desc.legend.size(); ++i) {
+        const LegendDesc & legendDesc = desc.legend[i];
+        if (legendDesc.spriteFile.empty())
+            continue;
+
+        TileLegend & legend = m_legend[i];
+        legend.collision = legendDesc.collision;
+
+        Spritesheet * sheet = g_graphicsMgr->LoadSpritesheet(legendDesc.spriteFile.c_str());
+        legend.sprite.SetSheet(sheet);
+
+        std::unique_ptr<CookedSpritesheet> & cooked = cookedSheets[legendDesc.spriteFile];
+        if (!cooked) {
+            cooked.reset(new CookedSpritesheet);
+            cooked->OpenFromDatafile(legendDesc.spriteFile.c_str());
+        }
+
+        if (cooked->IsOpen()) {
+            const std::string animText(legendDesc.anim.begin(), legendDesc.anim.end());
+            legend.sprite.SetAnimIndex(cooked->FindAnimIndex(AnimName(animText.c_str())));
+        }
+        else
+            legend.sprite.SetAnimIndex(sheet->GetAnimationIndex(legendDesc.anim.c_str()));
     }
-    fclose(file);
-    file = nullptr;
-    
-    CSaruContainer::DataMapReader reader = dataMap.GetReader();
+
+    return true;
+
+}
+
+//==============================================================================
+bool Level::BuildFromDatafile (const char * filepath) {
     
-    reader.ToChild("level");
-    if (!reader.IsValid())
-        return false;
+    Reset();
 
-    char    tempStr[512];
-    wchar_t tempWStr[512];
-        
-    // Get spritesheet name
-    reader.ToChild("name");
-    if (!reader.IsValid())
-        return false;
-    if (!reader.ReadStringSafe(tempStr, arrsize(tempStr)))
+    Desc                        desc;
+    std::vector<unsigned short> tiles;
+    if (!ParseDatafile(filepath, &desc, &tiles) || !BuildFromDesc(desc))
         return false;
-    m_name.clear();
-    swprintf_s(tempWStr, L"%S", tempStr);
-    m_name = tempWStr;
 
-    // Get size and allocate
-    reader.PopNode().ToChild("width");
-    if (!reader.IsValid())
-        return false;
-    const unsigned width = reader.ReadInt();
-    reader.PopNode().ToChild("height");
-    if (!reader.IsValid())
+    // Legend 0 is the implicit fill, so all-zero chunks stay unallocated.
+    for (unsigned y = 0; y < m_height; ++y) {
+        for (unsigned x = 0; x < m_width; ++x) {
+            if (tiles[y * m_width + x])
+                WriteTile(x, y, tiles[y * m_width + x]);
+        }
+    }
+
+    // Store source filename
+    m_sourceFilepath = filepath;
+    
+    return true;
+
+}
+
+//==============================================================================
+bool Level::BuildFromCookedFile (const char * filepath) {
+
+    Reset();
+
+    m_mappedFile = new Core::MappedFile;
+    if (!m_mappedFile->Open(filepath) || !LevelFile::Validate(m_mappedFile->GetData(), m_mappedFile->GetSize())) {
+        Reset();
         return false;
-    const unsigned height = reader.ReadInt();
+    }
 
-    if (!width || !height)
+    Desc desc;
+    LevelFile::ReadDesc(m_mappedFile->GetData(), &desc);
+    if (!BuildFromDesc(desc)) {
+        Reset();
         return false;
-    Resize(width, height);
+    }
 
-    // Read in the tile legend
-    reader.PopNode().ToChild("visual").ToChild("legend");
-    {
-        reader.ToFirstChild();
-        do {
-            CSaruContainer::DataMapReaderSimple simple(reader);
-            const unsigned                      legendIndex = simple.Int("key");
-            if (m_legend.size() <= legendIndex)
-                m_legend.resize(legendIndex + 1);
+    // Same layout as TileChunk, so no copy; WriteTile copies before writing.
+    for (unsigned i = 0; i < m_chunks.size(); ++i)
+        m_chunks[i] = const_cast<TileChunk *>(LevelFile::GetChunk(m_mappedFile->GetData(), i));
 
-            TileLegend & legend = m_legend[legendIndex];
-            legend.collision = static_cast<Level::ETileCollision>(simple.Int("collision"));
+    m_sourceFilepath = filepath;
 
-            std::string tempStdStr = simple.String("spritefile");
-            Spritesheet * sheet = g_graphicsMgr->LoadSpritesheet(tempStdStr.c_str());
-            legend.sprite.SetSheet(sheet);
+    return true;
 
-            std::wstring tempStdWStr = simple.WString("anim");
-            legend.sprite.SetAnimIndex(sheet->GetAnimationIndex(tempStdWStr.c_str()));
+}
 
-        } while (reader.ToNextSibling().IsValid());
+//==============================================================================
+// Leaves a cooked file cooked from the same datafile bytes alone.
+bool Level::CookDatafile (const char * datafilePath, const char * cookedPath) {
 
-        reader.PopNode().PopNode();
+    // Hashing the datafile is a single pass over its bytes, far cheaper than
+    // parsing it.
+    std::uint64_t contentHash;
+    {
+        Core::MappedFile datafile;
+        if (!datafile.Open(datafilePath))
+            return false;
+        contentHash = Core::Fnv1aHash64(datafile.GetData(), datafile.GetSize());
     }
-        
-    // Prepare to read in rows
-    reader.PopNode().ToChild("terrainRows");
-    if (!reader.IsValid())
-        return false;
-    
-    // Try reading in each row
-    unsigned y = 0;
-    for (reader.ToFirstChild(); reader.IsValid(); reader.ToNextSibling()) {
-    
-        CSaruContainer::DataMapReader rowReader(reader);
-        rowReader.ToFirstChild();
-        for (unsigned x = 0; x < width; ++x) {
-            TileData & tileData = m_tiles[((height - y) - 1) * width + x];
-            tileData.legendIndex = rowReader.ReadIntWalk();
-            ASSERT(tileData.legendIndex < m_legend.size());
-            tileData.collision   = m_legend[tileData.legendIndex].collision;
-        }
 
-        ++y;
+    {
+        Core::MappedFile cooked;
+        if (cooked.Open(cookedPath)) {
+            const LevelFile::Header * header = LevelFile::Validate(cooked.GetData(), cooked.GetSize());
+            if (header && header->contentHash == contentHash)
+                return true;
+        }
+        // Closed here; Windows won't let a mapped file be rewritten.
     }
-    
-    // Store source filename
-    m_sourceFilepath = filepath;
-    
-    return true;
+
+    Desc                        desc;
+    std::vector<unsigned short> tiles;
+    if (!ParseDatafile(datafilePath, &desc, &tiles))
+        return false;
+
+    return LevelFile::Write(cookedPath, desc, tiles, contentHash);
 
 }
 
@@ -151,41 +189,241 @@ bool Level::BuildFromDatafile (const char * filepath) {
 void Level::Reload () {
 
     std::string tempFilepath = m_sourceFilepath;
+    if (m_mappedFile) {
+        BuildFromCookedFile(tempFilepath.c_str());
+        return;
+    }
+
+    if (m_streamer) {
+        const LevelStreamSettings settings = m_streamer->GetSettings();
+        BeginStreamingFromDatafile(tempFilepath.c_str(), settings);
+        return;
+    }
+
     BuildFromDatafile(tempFilepath.c_str());
 
 }
 
 //==============================================================================
-void Level::Render (const Transform & levelTransform) {
+void Level::BeginStreaming (ILevelChunkSource * source, const LevelStreamSettings & settings) {
+
+    Reset();
+    m_streamer = new LevelStreamer(source, settings);
+
+}
+
+//==============================================================================
+void Level::BeginStreamingFromDatafile (const char * filepath, const LevelStreamSettings & settings) {
+
+    // Cooked files page chunks straight from disk; JSON has to be parsed whole.
+    const std::string cookedExtension = LevelFile::s_extension;
+    const std::string path            = filepath;
+    const bool        cooked          = path.size() >= cookedExtension.size()
+        && !path.compare(path.size() - cookedExtension.size(), cookedExtension.size(), cookedExtension);
+
+    if (cooked)
+        BeginStreaming(new CookedLevelChunkSource(filepath), settings);
+    else
+        BeginStreaming(new JsonLevelChunkSource(filepath), settings);
+    m_sourceFilepath = filepath;
+
+}
+
+//==============================================================================
+bool Level::UpdateStreaming (const Transform & levelTransform, const WorldRect * viewRect) {
 
-    ASSERT(m_legend.size());
+    if (!m_streamer)
+        return true;
+
+    // Until the description arrives there's no grid to focus on.
+    if (!m_streamer->IsReady()) {
+        const LevelChunkRange none = { 0, 0, 0, 0 };
+        if (!m_streamer->Pump(*this, none))
+            return false;
+        if (!m_streamer->IsReady())
+            return true;
+    }
+
+    const LevelChunkRange focus = viewRect
+        ? GetVisibleChunks(levelTransform.GetWorldFromModelMtx(), *viewRect)
+        : GetAllChunks();
+    return m_streamer->Pump(*this, focus);
+
+}
+
+//==============================================================================
+void Level::InstallChunk (unsigned chunkIndex, TileChunk * chunk) {
 
+    ASSERT(chunkIndex < m_chunks.size() && !m_chunks[chunkIndex]);
+    m_chunks[chunkIndex] = chunk;
+    m_tileBatch.MarkChunkDirty(chunkIndex % m_chunksWide, chunkIndex / m_chunksWide);
+
+}
+
+//==============================================================================
+void Level::EvictChunk (unsigned chunkIndex) {
+
+    ASSERT(chunkIndex < m_chunks.size());
+    if (IsChunkOwned(m_chunks[chunkIndex]))
+        delete m_chunks[chunkIndex];
+    m_chunks[chunkIndex] = nullptr;
+    m_tileBatch.MarkChunkDirty(chunkIndex % m_chunksWide, chunkIndex / m_chunksWide);
+
+}
+
+//==============================================================================
+bool Level::IsChunkResident (unsigned chunkX, unsigned chunkY) const {
+    return !m_streamer || m_streamer->IsChunkResident(chunkY * m_chunksWide + chunkX);
+}
+
+//==============================================================================
+bool Level::GetTileSize (float * widthOut, float * heightOut) const {
+
+    if (m_legend.empty())
+        return false;
+
+    // All tiles share the grid of the first legend's frame.
     const SpritesheetFrame * sampleFrame = m_legend[0].sprite.GetCurrentFrame();
     ASSERT(sampleFrame);
-    const float tileWidth  = sampleFrame->width  * levelTransform.GetScale().x;
-    const float tileHeight = sampleFrame->height * levelTransform.GetScale().y;
+    if (!sampleFrame)
+        return false;
+
+    *widthOut  = float(sampleFrame->width);
+    *heightOut = float(sampleFrame->height);
+    return true;
+
+}
+
+//==============================================================================
+LevelChunkRange Level::GetAllChunks () const {
 
-    Transform tileTransform = levelTransform;
-    Mtx44     tileWorldFromModelMtx;
+    LevelChunkRange range = { 0, 0, m_chunksWide, m_chunksHigh };
+    return range;
 
-    const unsigned tileCount = m_width * m_height;
-    for (unsigned i = 0; i < tileCount; ++i) {
-        TileData & tile = m_tiles[i];
+}
+
+//==============================================================================
+LevelChunkRange Level::GetVisibleChunks (const Mtx44 & levelWorldFromModelMtx, const WorldRect & viewRect) const {
+
+    LevelChunkRange range = { 0, 0, 0, 0 };
+
+    float tileWidth;
+    float tileHeight;
+    Mtx44 levelFromWorldMtx;
+    if (!GetTileSize(&tileWidth, &tileHeight) || !InvertAffine2d(levelWorldFromModelMtx, &levelFromWorldMtx))
+        return range;
+
+    // Bound the view's corners in level space
+    const float cornersX[] = { viewRect.minX, viewRect.maxX, viewRect.minX, viewRect.maxX };
+    const float cornersY[] = { viewRect.minY, viewRect.minY, viewRect.maxY, viewRect.maxY };
+    float minX =  FLT_MAX;
+    float minY =  FLT_MAX;
+    float maxX = -FLT_MAX;
+    float maxY = -FLT_MAX;
+    for (unsigned i = 0; i < arrsize(cornersX); ++i) {
+        float x;
+        float y;
+        TransformPointAffine2d(levelFromWorldMtx, cornersX[i], cornersY[i], &x, &y);
+        minX = MIN(minX, x);
+        minY = MIN(minY, y);
+        maxX = MAX(maxX, x);
+        maxY = MAX(maxY, y);
+    }
+
+    // Tiles extend a tile either way of their anchor depending on the
+    // sprite's pivot, so pad by one tile rather than depend on it.
+    const float chunkWidth  = tileWidth  * s_chunkTiles;
+    const float chunkHeight = tileHeight * s_chunkTiles;
+    const float beginX      = floorf((minX - tileWidth)  / chunkWidth);
+    const float beginY      = floorf((minY - tileHeight) / chunkHeight);
+    const float endX        = floorf((maxX + tileWidth)  / chunkWidth)  + 1.0f;
+    const float endY        = floorf((maxY + tileHeight) / chunkHeight) + 1.0f;
+
+    range.beginX = unsigned(MAX(0.0f, MIN(beginX, float(m_chunksWide))));
+    range.beginY = unsigned(MAX(0.0f, MIN(beginY, float(m_chunksHigh))));
+    range.endX   = unsigned(MAX(0.0f, MIN(endX,   float(m_chunksWide))));
+    range.endY   = unsigned(MAX(0.0f, MIN(endY,   float(m_chunksHigh))));
+    return range;
+
+}
+
+//==============================================================================
+unsigned Level::GetTileLegendIndex (unsigned x, unsigned y) const {
+
+    ASSERT(x < m_width && y < m_height);
+
+    const TileChunk * chunk = m_chunks[(y / s_chunkTiles) * m_chunksWide + x / s_chunkTiles];
+    if (!chunk)
+        return 0;
 
-        ASSERT(tile.legendIndex < m_legend.size());
-        TileLegend & legend = m_legend[tile.legendIndex];
+    // Cooked and streamed chunks aren't scanned when they load, so a stale or
+    // corrupt file can hold indices past the legend; those read as legend 0.
+    const unsigned legendIndex = chunk->legendIndices[(y % s_chunkTiles) * s_chunkTiles + x % s_chunkTiles];
+    return legendIndex < m_legend.size() ? legendIndex : 0;
 
-        const unsigned x = i % m_width;
-        const unsigned y = i / m_width;
+}
+
+//==============================================================================
+Level::ETileCollision Level::GetTileCollision (unsigned x, unsigned y) const {
+    return m_legend[GetTileLegendIndex(x, y)].collision;
+}
 
-        tileTransform.SetPosition(Vec3(
-            x * tileWidth  + levelTransform.GetPosition().x,
-            y * tileHeight + levelTransform.GetPosition().y,
-            levelTransform.GetPosition().z
-        ));
+//==============================================================================
+bool Level::IsChunkOwned (const TileChunk * chunk) const {
+    return chunk && !(m_mappedFile && m_mappedFile->Contains(chunk));
+}
 
-        tileTransform.GetWorldFromModelMtx(&tileWorldFromModelMtx);
-        legend.sprite.Render(tileWorldFromModelMtx);
+//==============================================================================
+Level::TileChunk * Level::GetOrCreateChunk (unsigned x, unsigned y) {
+
+    ASSERT(x < m_width && y < m_height);
+
+    TileChunk *& chunk = m_chunks[(y / s_chunkTiles) * m_chunksWide + x / s_chunkTiles];
+    if (!chunk) {
+        chunk = new TileChunk;
+        memset(chunk, 0, sizeof(TileChunk));
+    }
+    else if (!IsChunkOwned(chunk)) {
+        // Mapped chunks are read-only; copy on first write.
+        TileChunk * copy = new TileChunk;
+        memcpy(copy, chunk, sizeof(TileChunk));
+        chunk = copy;
+    }
+
+    return chunk;
+
+}
+
+//==============================================================================
+void Level::Render (const Transform & levelTransform, const WorldRect * viewRect, unsigned batchLayer) {
+
+    // Streamed levels have nothing to draw until their description arrives.
+    if (m_legend.empty())
+        return;
+
+    const Mtx44 &         levelWorldFromModelMtx = levelTransform.GetWorldFromModelMtx();
+    const LevelChunkRange range                  = viewRect
+        ? GetVisibleChunks(levelWorldFromModelMtx, *viewRect)
+        : GetAllChunks();
+
+    // Tiles are children of the level; the batch bakes their world matrices
+    // and only rebakes chunks that changed since they were last drawn.
+    m_tileBatch.Rebuild(*this, levelTransform, range);
+
+    SpriteBatcher * batcher = SpriteBatcher::GetActive();
+    const float     depth   = levelTransform.GetPosition().z;
+    for (unsigned chunkY = range.beginY; chunkY < range.endY; ++chunkY) {
+        for (unsigned chunkX = range.beginX; chunkX < range.endX; ++chunkX) {
+            const LevelTileBatch::Chunk & chunk = m_tileBatch.GetChunk(chunkX, chunkY);
+            for (const LevelTileBatch::TileInstance & instance : chunk.instances) {
+                ASSERT(instance.legendIndex < m_legend.size());
+                SpriteAnimation & sprite = m_legend[instance.legendIndex].sprite;
+                if (batcher && instance.frame)
+                    batcher->Add(instance.sheet, batchLayer, depth, instance.worldFromModelMtx, *instance.frame, &sprite);
+                else
+                    sprite.Render(instance.worldFromModelMtx);
+            }
+        }
     }
 
 }
@@ -193,13 +431,28 @@ void Level::Render (const Transform & levelTransform) {
 //==============================================================================
 void Level::Reset () {
 
-    delete [] m_tiles;
-    m_tiles  = nullptr;
+    // Stops the streaming thread before the chunks it fills go away.
+    delete m_streamer;
+    m_streamer = nullptr;
 
-    m_width  = 0;
-    m_height = 0;
+    for (TileChunk * chunk : m_chunks) {
+        if (IsChunkOwned(chunk))
+            delete chunk;
+    }
+    m_chunks.clear();
+
+    delete m_mappedFile;
+    m_mappedFile = nullptr;
+
+    m_width      = 0;
+    m_height     = 0;
+    m_chunksWide = 0;
+    m_chunksHigh = 0;
     m_name.clear();
+    m_tileBatch.Reset(0, 0);
     m_sourceFilepath.clear();
+    m_edits.clear();
+    m_editBase = 0;
 
 }
 
@@ -209,36 +462,110 @@ bool Level::Resize (unsigned width, unsigned height) {
     if (width == m_width && height == m_height)
         return true;
 
-    const unsigned newTileCount = width * height;
-    TileData *     newTiles     = new TileData [newTileCount];
-    ASSERT(newTiles);
-    if (!newTiles)
-        return false;
-
-    memset(newTiles, 0, sizeof(TileData) * newTileCount);
-
-    if (m_tiles) {
-        const unsigned minWidth  = MIN(m_width, width);
-        const unsigned minHeight = MIN(m_height, height);
-        for (unsigned y = 0; y < minHeight; ++y) {
-            memcpy(newTiles + y * width, m_tiles + y * m_width, minWidth);
+    const unsigned chunksWide = (width  + s_chunkTiles - 1) / s_chunkTiles;
+    const unsigned chunksHigh = (height + s_chunkTiles - 1) / s_chunkTiles;
+
+    // Keep existing chunks that still fall inside the new bounds
+    std::vector<TileChunk *> newChunks(chunksWide * chunksHigh, nullptr);
+    for (unsigned chunkY = 0; chunkY < m_chunksHigh; ++chunkY) {
+        for (unsigned chunkX = 0; chunkX < m_chunksWide; ++chunkX) {
+            TileChunk *& chunk = m_chunks[chunkY * m_chunksWide + chunkX];
+            if (chunkX < chunksWide && chunkY < chunksHigh)
+                newChunks[chunkY * chunksWide + chunkX] = chunk;
+            else if (IsChunkOwned(chunk))
+                delete chunk;
+            chunk = nullptr;
         }
     }
 
-    m_width  = width;
-    m_height = height;
+    m_width      = width;
+    m_height     = height;
+    m_chunksWide = chunksWide;
+    m_chunksHigh = chunksHigh;
+    m_chunks.swap(newChunks);
 
-    delete [] m_tiles;
-    m_tiles = newTiles;
+    m_tileBatch.Reset(m_chunksWide, m_chunksHigh);
 
     return true;
 
 }
 
+//==============================================================================
+void Level::SetTile (unsigned x, unsigned y, unsigned legendIndex) {
+
+    const unsigned oldLegendIndex = WriteTile(x, y, legendIndex);
+    if (oldLegendIndex == legendIndex)
+        return;
+
+    const TileEdit edit = { x, y, (unsigned short)oldLegendIndex, (unsigned short)legendIndex };
+    m_edits.push_back(edit);
+
+}
+
+//==============================================================================
+// Returns the tile's previous legend index.
+unsigned Level::WriteTile (unsigned x, unsigned y, unsigned legendIndex) {
+
+    ASSERT(x < m_width && y < m_height);
+    ASSERT(legendIndex < m_legend.size());
+    ASSERT(legendIndex <= 0xFFFF && "Tiles store 16-bit legend indices.");
+
+    const unsigned oldLegendIndex = GetTileLegendIndex(x, y);
+    if (oldLegendIndex == legendIndex)
+        return oldLegendIndex;
+
+    // Edits to streamed chunks must survive eviction, so they pin the chunk.
+    if (m_streamer) {
+        ASSERT(IsChunkResident(x / s_chunkTiles, y / s_chunkTiles));
+        m_streamer->PinChunk((y / s_chunkTiles) * m_chunksWide + x / s_chunkTiles);
+    }
+
+    GetOrCreateChunk(x, y)->legendIndices[(y % s_chunkTiles) * s_chunkTiles + x % s_chunkTiles] = (unsigned short)legendIndex;
+    m_tileBatch.MarkTileDirty(x, y);
+    return oldLegendIndex;
+
+}
+
+//==============================================================================
+void Level::RevertEditsTo (unsigned sequence) {
+
+    ASSERT(sequence >= m_editBase && "Edits before the requested sequence were discarded.");
+    if (sequence < m_editBase)
+        return;
+
+    while (GetEditSequence() > sequence) {
+        const TileEdit & edit = m_edits.back();
+        WriteTile(edit.x, edit.y, edit.oldLegendIndex);
+        m_edits.pop_back();
+    }
+
+}
+
+//==============================================================================
+void Level::DiscardEditsBefore (unsigned sequence) {
+
+    if (sequence <= m_editBase)
+        return;
+
+    const unsigned count = MIN(sequence - m_editBase, unsigned(m_edits.size()));
+    m_edits.erase(m_edits.begin(), m_edits.begin() + count);
+    m_editBase += count;
+
+}
+
 //==============================================================================
 void Level::Update (float dt) {
 
-    for (TileLegend & legend : m_legend)
-        legend.sprite.Update(dt);
+    const unsigned legendCount = unsigned(m_legend.size());
+    for (unsigned i = 0; i < legendCount; ++i) {
+        SpriteAnimation &        sprite    = m_legend[i].sprite;
+        const SpritesheetFrame * lastFrame = sprite.GetCurrentFrame();
+
+        sprite.Update(dt);
+
+        // Baked tiles reference the frame, so chunks using it need rebaking.
+        if (sprite.GetCurrentFrame() != lastFrame)
+            m_tileBatch.MarkLegendDirty(i);
+    }
 
 }
@@ -24,8 +24,21 @@ SOFTWARE.
 
 #pragma once
 
+#include "LevelTileBatch.hpp"
+
+namespace Core { class MappedFile; }
+
+class ILevelChunkSource;
+class LevelStreamer;
+struct LevelStreamSettings;
+
 class Level {
+    friend class LevelStreamer;
+
 public: // Types and Constants
+    // Storage and render batches share the same chunk grid.
+    static const unsigned s_chunkTiles = LevelTileBatch::s_chunkTiles;
+
     enum class ETileCollision : unsigned char {
         None = 0,
         Solid,
@@ -33,11 +46,6 @@ public: // Types and Constants
         TERM
     };
 
-    struct TileData {
-        ETileCollision collision;
-        unsigned      legendIndex;
-    };
-
     struct TileLegend {
         SpriteAnimation sprite;
         ETileCollision   collision;
@@ -47,24 +55,128 @@ public: // Types and Constants
         {}
     };
 
+    // Legend index per tile, row-major within the chunk.  Collision comes
+    // from the legend, so a tile is just its index.
+    struct TileChunk {
+        unsigned short legendIndices[s_chunkTiles * s_chunkTiles];
+    };
+
+    // What a level file describes, without any graphics resources; filled by
+    // ParseDatafile and streaming sources, off the main thread if need be.
+    struct LegendDesc {
+        ETileCollision collision;
+        std::string    spriteFile; // Empty for unused legend keys
+        std::wstring   anim;
+
+        LegendDesc () :
+            collision(ETileCollision::None)
+        {}
+    };
+
+    struct Desc {
+        std::wstring            name;
+        unsigned                width;
+        unsigned                height;
+        std::vector<LegendDesc> legend; // Indexed by legend key
+
+        Desc () : width(0), height(0) {}
+    };
+
+    // One SetTile call, kept so rollback can undo it.
+    struct TileEdit {
+        unsigned       x;
+        unsigned       y;
+        unsigned short oldLegendIndex;
+        unsigned short newLegendIndex;
+    };
+
 private: // Data
-    std::wstring            m_name;
-    std::string             m_sourceFilepath;
-    unsigned                m_width;
-    unsigned                m_height;
-    TileData *              m_tiles;
-    std::vector<TileLegend> m_legend;
+    std::wstring             m_name;
+    std::string              m_sourceFilepath;
+    unsigned                 m_width;
+    unsigned                 m_height;
+    unsigned                 m_chunksWide;
+    unsigned                 m_chunksHigh;
+    std::vector<TileChunk *> m_chunks; // nullptr: every tile uses legend 0
+    Core::MappedFile *       m_mappedFile; // Backs chunks of a cooked level
+    std::vector<TileLegend>  m_legend;
+    LevelTileBatch           m_tileBatch;
+    LevelStreamer *          m_streamer; // Null unless streaming
+    std::vector<TileEdit>    m_edits;    // Edits numbered from m_editBase on
+    unsigned                 m_editBase;
 
 private: // Helpers
-    bool Resize (unsigned width, unsigned height);
-    void Reset ();
+    bool        Resize (unsigned width, unsigned height);
+    void        Reset ();
+    TileChunk * GetOrCreateChunk (unsigned x, unsigned y);
+    unsigned    WriteTile (unsigned x, unsigned y, unsigned legendIndex);
+    bool        IsChunkOwned (const TileChunk * chunk) const;
+    bool        BuildFromDesc (const Desc & desc);
+
+    // LevelStreamer
+    void        InstallChunk (unsigned chunkIndex, TileChunk * chunk);
+    void        EvictChunk (unsigned chunkIndex);
 
 public:
     Level ();
+    ~Level ();
 
     bool BuildFromDatafile (const char * filepath);
     void Reload ();
 
+    // Parses a level datafile without loading any graphics.  Tiles come back
+    // row-major, bottom row first, as legend indices.
+    static bool ParseDatafile (const char * filepath, Desc * descOut, std::vector<unsigned short> * tilesOut);
+
+    // Cooked levels (see LevelFile.hpp) are mapped rather than read; their
+    // chunks point straight into the mapping and are copied on first edit.
+    // CookDatafile skips levels already cooked from the datafile's contents.
+    bool        BuildFromCookedFile (const char * filepath);
+    static bool CookDatafile (const char * datafilePath, const char * cookedPath);
+
+    // Streaming: chunks load on a background thread around the view passed
+    // to UpdateStreaming, within the settings' memory budget.  The level is
+    // empty until its description has been read.  BeginStreaming takes
+    // ownership of source.  UpdateStreaming returns false once the stream
+    // has failed; GetStreamer says how.
+    void BeginStreaming (ILevelChunkSource * source, const LevelStreamSettings & settings);
+    void BeginStreamingFromDatafile (const char * filepath, const LevelStreamSettings & settings); // JSON or cooked
+    bool UpdateStreaming (const Transform & levelTransform, const WorldRect * viewRect);
+
+    void SetTile (unsigned x, unsigned y, unsigned legendIndex);
+
+    // Edit history for rollback.  Every SetTile since the level was built
+    // gets the next sequence number; reverting undoes edits from the newest
+    // back to sequence, and discarding forgets history no snapshot needs.
+    unsigned GetEditSequence () const       { return m_editBase + unsigned(m_edits.size()); }
+    unsigned GetOldestEditSequence () const { return m_editBase; }
+    void     RevertEditsTo (unsigned sequence);
+    void     DiscardEditsBefore (unsigned sequence);
+
     void Update (float dt);
-    void Render (const Transform & levelTransform);
-};
\ No newline at end of file
+
+    // Draws the chunks overlapping viewRect (world space), or every chunk if
+    // viewRect is null.  With a SpriteBatcher active the tiles are added to
+    // it on batchLayer instead of drawn one at a time.
+    void Render (const Transform & levelTransform, const WorldRect * viewRect = nullptr, unsigned batchLayer = 0);
+
+    // Queries
+    unsigned                 GetWidth () const                          { return m_width; }
+    unsigned                 GetHeight () const                         { return m_height; }
+    unsigned                 GetChunksWide () const                     { return m_chunksWide; }
+    unsigned                 GetChunksHigh () const                     { return m_chunksHigh; }
+    bool                     IsStreaming () const                       { return m_streamer != nullptr; }
+    const LevelStreamer *    GetStreamer () const                       { return m_streamer; }
+    LevelStreamer *          GetStreamer ()                             { return m_streamer; }
+    bool                     IsChunkResident (unsigned chunkX, unsigned chunkY) const;
+    unsigned                 GetTileLegendIndex (unsigned x, unsigned y) const;
+    ETileCollision           GetTileCollision (unsigned x, unsigned y) const;
+    unsigned                 GetLegendCount () const                    { return unsigned(m_legend.size()); }
+    const TileLegend &       GetLegend (unsigned legendIndex) const     { return m_legend[legendIndex]; }
+    bool                     GetTileSize (float * widthOut, float * heightOut) const;
+    const LevelTileBatch &   GetTileBatch () const                      { return m_tileBatch; }
+
+    // Chunks whose tiles may overlap viewRect, given the level's world matrix.
+    LevelChunkRange GetVisibleChunks (const Mtx44 & levelWorldFromModelMtx, const WorldRect & viewRect) const;
+    LevelChunkRange GetAllChunks () const;
+};
@@ -0,0 +1,424 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Christopher Higgins Barrett
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "LevelCollision.hpp"
+
+#include "../Jobs/JobSystem.h"
+
+#include <cfloat>
+
+namespace {
+
+// Boxes closer than this to a cell edge aren't considered inside the cell,
+// so surfaces being rested on or slid along don't block.
+const float s_edgeEpsilon = 1e-3f;
+
+// Overlap tolerated at the start of a sweep before it counts as starting
+// inside a tile; absorbs rounding from the previous move's contact.
+const float s_contactSkin = 1e-2f;
+
+//==============================================================================
+// Time of impact of box a moving by (dx, dy) with static box b.
+bool SweepBoxVsBox (
+    const WorldRect & a,
+    float             dx,
+    float             dy,
+    const WorldRect & b,
+    float *           timeOut,
+    float *           normalXOut,
+    float *           normalYOut
+) {
+
+    float enter   = -FLT_MAX;
+    float exit    =  FLT_MAX;
+    float normalX = 0.0f;
+    float normalY = 0.0f;
+    float enterDistance = 0.0f; // Along the entering axis, for the skin test
+
+    if (dx == 0.0f) {
+        if (a.maxX <= b.minX || a.minX >= b.maxX)
+            return false;
+    }
+    else {
+        const float gapIn  = dx > 0.0f ? b.minX - a.maxX : a.minX - b.maxX;
+        const float gapOut = dx > 0.0f ? b.maxX - a.minX : a.maxX - b.minX;
+        const float speed  = fabsf(dx);
+        enter         = gapIn / speed;
+        exit          = gapOut / speed;
+        normalX       = dx > 0.0f ? -1.0f : 1.0f;
+        enterDistance = gapIn;
+    }
+
+    if (dy == 0.0f) {
+        if (a.maxY <= b.minY || a.minY >= b.maxY)
+            return false;
+    }
+    else {
+        const float gapIn  = dy > 0.0f ? b.minY - a.maxY : a.minY - b.maxY;
+        const float gapOut = dy > 0.0f ? b.maxY - a.minY : a.maxY - b.minY;
+        const float speed  = fabsf(dy);
+        const float enterY = gapIn / speed;
+        if (enterY > enter) {
+            enter         = enterY;
+            normalX       = 0.0f;
+            normalY       = dy > 0.0f ? -1.0f : 1.0f;
+            enterDistance = gapIn;
+        }
+        exit = MIN(exit, gapOut / speed);
+    }
+
+    if (enter >= exit || enter > 1.0f || exit <= 0.0f)
+        return false;
+
+    // Starting inside: only a contact within the skin still counts.
+    if (enter < 0.0f) {
+        if (enterDistance < -s_contactSkin)
+            return false;
+        enter = 0.0f;
+    }
+
+    *timeOut    = enter;
+    *normalXOut = normalX;
+    *normalYOut = normalY;
+    return true;
+
+}
+
+} // namespace
+
+//==============================================================================
+LevelCollision::LevelCollision () :
+    m_level(nullptr),
+    m_originX(0.0f),
+    m_originY(0.0f),
+    m_cellWidth(1.0f),
+    m_cellHeight(1.0f)
+{}
+
+//==============================================================================
+const LevelCollision *& LevelCollision::ActiveSlot () {
+    static const LevelCollision * s_active = nullptr;
+    return s_active;
+}
+
+//==============================================================================
+void LevelCollision::Bind (const Level & level, const Transform & levelTransform) {
+
+    float tileWidth;
+    float tileHeight;
+    if (!level.GetTileSize(&tileWidth, &tileHeight)) {
+        m_level = nullptr;
+        return;
+    }
+
+    const float * m = reinterpret_cast<const float *>(&levelTransform.GetWorldFromModelMtx());
+    ASSERT(fabsf(m[1]) < 1e-4f && fabsf(m[4]) < 1e-4f && "Level collision doesn't support rotated levels.");
+    ASSERT(m[0] > 0.0f && m[5] > 0.0f);
+
+    m_level      = &level;
+    m_originX    = m[12];
+    m_originY    = m[13];
+    m_cellWidth  = tileWidth  * m[0];
+    m_cellHeight = tileHeight * m[5];
+
+}
+
+//==============================================================================
+int LevelCollision::CellX (float x) const {
+    return int(floorf((x - m_originX) / m_cellWidth));
+}
+
+//==============================================================================
+int LevelCollision::CellY (float y) const {
+    return int(floorf((y - m_originY) / m_cellHeight)) + 1;
+}
+
+//==============================================================================
+void LevelCollision::CellRangeX (float minX, float maxX, int * beginOut, int * endOut) const {
+
+    *beginOut = CellX(minX + s_edgeEpsilon);
+    *endOut   = CellX(maxX - s_edgeEpsilon) + 1;
+    if (*endOut <= *beginOut) { // Thinner than the epsilon (points, rays)
+        *beginOut = CellX(0.5f * (minX + maxX));
+        *endOut   = *beginOut + 1;
+    }
+
+}
+
+//==============================================================================
+void LevelCollision::CellRangeY (float minY, float maxY, int * beginOut, int * endOut) const {
+
+    *beginOut = CellY(minY + s_edgeEpsilon);
+    *endOut   = CellY(maxY - s_edgeEpsilon) + 1;
+    if (*endOut <= *beginOut) {
+        *beginOut = CellY(0.5f * (minY + maxY));
+        *endOut   = *beginOut + 1;
+    }
+
+}
+
+//==============================================================================
+bool LevelCollision::GetSolidBox (
+    int                     cellX,
+    int                     cellY,
+    WorldRect *             boxOut,
+    Level::ETileCollision * collisionOut
+) const {
+
+    if (cellX < 0 || cellY < 0 || unsigned(cellX) >= m_level->GetWidth() || unsigned(cellY) >= m_level->GetHeight())
+        return false;
+
+    const Level::ETileCollision collision = m_level->GetTileCollision(unsigned(cellX), unsigned(cellY));
+    if (collision == Level::ETileCollision::None)
+        return false;
+
+    boxOut->minX = m_originX + cellX * m_cellWidth;
+    boxOut->maxX = boxOut->minX + m_cellWidth;
+    boxOut->maxY = m_originY + cellY * m_cellHeight;
+    boxOut->minY = boxOut->maxY - m_cellHeight;
+    if (collision == Level::ETileCollision::BottomHalf)
+        boxOut->maxY = boxOut->minY + 0.5f * m_cellHeight;
+
+    *collisionOut = collision;
+    return true;
+
+}
+
+//==============================================================================
+void LevelCollision::TestCell (int cellX, int cellY, const WorldRect & box, float dx, float dy, Hit * bestInOut) const {
+
+    WorldRect             solid;
+    Level::ETileCollision collision;
+    if (!GetSolidBox(cellX, cellY, &solid, &collision))
+        return;
+
+    float time;
+    float normalX;
+    float normalY;
+    if (!SweepBoxVsBox(box, dx, dy, solid, &time, &normalX, &normalY) || time >= bestInOut->time)
+        return;
+
+    bestInOut->time      = time;
+    bestInOut->normalX   = normalX;
+    bestInOut->normalY   = normalY;
+    bestInOut->tileX     = cellX;
+    bestInOut->tileY     = cellY;
+    bestInOut->collision = collision;
+
+}
+
+//==============================================================================
+Level::ETileCollision LevelCollision::QueryPoint (float x, float y) const {
+
+    ASSERT(m_level);
+
+    WorldRect             solid;
+    Level::ETileCollision collision;
+    if (!GetSolidBox(CellX(x), CellY(y), &solid, &collision))
+        return Level::ETileCollision::None;
+
+    if (x < solid.minX || x >= solid.maxX || y < solid.minY || y >= solid.maxY)
+        return Level::ETileCollision::None;
+
+    return collision;
+
+}
+
+//==============================================================================
+bool LevelCollision::Raycast (float x, float y, float dx, float dy, Hit * hitOut) const {
+
+    const WorldRect point = { x, y, x, y };
+    return SweepBox(point, dx, dy, hitOut);
+
+}
+
+//==============================================================================
+bool LevelCollision::SweepBox (const WorldRect & box, float dx, float dy, Hit * hitOut) const {
+
+    ASSERT(m_level);
+
+    Hit best;
+    best.time      = 1.0f;
+    best.normalX   = 0.0f;
+    best.normalY   = 0.0f;
+    best.tileX     = -1;
+    best.tileY     = -1;
+    best.collision = Level::ETileCollision::None;
+
+    if (dx == 0.0f && dy == 0.0f) {
+        *hitOut = best;
+        return false;
+    }
+
+    // Cells under the box at the start; partial tiles there can still be hit.
+    int beginX;
+    int endX;
+    int beginY;
+    int endY;
+    CellRangeX(box.minX, box.maxX, &beginX, &endX);
+    CellRangeY(box.minY, box.maxY, &beginY, &endY);
+    for (int cellY = beginY; cellY < endY; ++cellY) {
+        for (int cellX = beginX; cellX < endX; ++cellX)
+            TestCell(cellX, cellY, box, dx, dy, &best);
+    }
+
+    // DDA over the grid lines crossed by the leading edges.  Each crossing
+    // brings one new column or row of cells under the box; test just those.
+    const int stepX = dx > 0.0f ? 1 : -1;
+    const int stepY = dy > 0.0f ? 1 : -1;
+    int   nextColumn = dx > 0.0f ? endX : beginX - 1;
+    int   nextRow    = dy > 0.0f ? endY : beginY - 1;
+    float timeX      = FLT_MAX;
+    float timeY      = FLT_MAX;
+    float deltaX     = FLT_MAX;
+    float deltaY     = FLT_MAX;
+    if (dx != 0.0f) {
+        const float edge     = dx > 0.0f ? box.maxX : box.minX;
+        const float boundary = m_originX + (dx > 0.0f ? nextColumn : nextColumn + 1) * m_cellWidth;
+        timeX  = (boundary - edge) / dx;
+        deltaX = m_cellWidth / fabsf(dx);
+    }
+    if (dy != 0.0f) {
+        const float edge     = dy > 0.0f ? box.maxY : box.minY;
+        const float boundary = m_originY + (dy > 0.0f ? nextRow - 1 : nextRow) * m_cellHeight;
+        timeY  = (boundary - edge) / dy;
+        deltaY = m_cellHeight / fabsf(dy);
+    }
+
+    for (;;) {
+        const float time = MIN(timeX, timeY);
+        if (time > best.time)
+            break;
+
+        if (timeX <= timeY) {
+            int rowBegin;
+            int rowEnd;
+            CellRangeY(box.minY + dy * time, box.maxY + dy * time, &rowBegin, &rowEnd);
+            for (int cellY = rowBegin; cellY < rowEnd; ++cellY)
+                TestCell(nextColumn, cellY, box, dx, dy, &best);
+
+            nextColumn += stepX;
+            timeX      += deltaX;
+        }
+        else {
+            int columnBegin;
+            int columnEnd;
+            CellRangeX(box.minX + dx * time, box.maxX + dx * time, &columnBegin, &columnEnd);
+            for (int cellX = columnBegin; cellX < columnEnd; ++cellX)
+                TestCell(cellX, nextRow, box, dx, dy, &best);
+
+            nextRow += stepY;
+            timeY   += deltaY;
+        }
+    }
+
+    *hitOut = best;
+    return best.collision != Level::ETileCollision::None;
+
+}
+
+//==============================================================================
+bool LevelCollision::ProbeGround (const WorldRect & box, float maxDistance, float * distanceOut) const {
+
+    Hit hit;
+    if (!SweepBox(box, 0.0f, -maxDistance, &hit) || hit.normalY <= 0.0f)
+        return false;
+
+    *distanceOut = hit.time * maxDistance;
+    return true;
+
+}
+
+//==============================================================================
+void LevelCollision::MoveAndSlide (
+    const WorldRect & box,
+    float             dx,
+    float             dy,
+    MoveResult *      resultOut,
+    unsigned          maxSlides
+) const {
+
+    resultOut->dx       = 0.0f;
+    resultOut->dy       = 0.0f;
+    resultOut->blockedX = false;
+    resultOut->blockedY = false;
+    resultOut->grounded = false;
+
+    WorldRect current = box;
+    for (unsigned slide = 0; slide <= maxSlides && (dx != 0.0f || dy != 0.0f); ++slide) {
+        Hit hit;
+        SweepBox(current, dx, dy, &hit);
+
+        const float moveX = dx * hit.time;
+        const float moveY = dy * hit.time;
+        current.minX += moveX;
+        current.maxX += moveX;
+        current.minY += moveY;
+        current.maxY += moveY;
+        resultOut->dx += moveX;
+        resultOut->dy += moveY;
+
+        if (hit.collision == Level::ETileCollision::None)
+            break;
+
+        // Drop the blocked axis and carry on with what's left of the other.
+        dx *= 1.0f - hit.time;
+        dy *= 1.0f - hit.time;
+        if (hit.normalX != 0.0f) {
+            dx                  = 0.0f;
+            resultOut->blockedX = true;
+        }
+        if (hit.normalY != 0.0f) {
+            dy                  = 0.0f;
+            resultOut->blockedY = true;
+            resultOut->grounded = resultOut->grounded || hit.normalY > 0.0f;
+        }
+    }
+
+}
+
+//==============================================================================
+void LevelCollision::SweepBoxes (const BoxSweep * sweeps, unsigned count, Hit * hitsOut) const {
+
+    for (unsigned i = 0; i < count; ++i)
+        SweepBox(sweeps[i].box, sweeps[i].dx, sweeps[i].dy, &hitsOut[i]);
+
+}
+
+//==============================================================================
+void LevelCollision::SweepBoxesParallel (
+    JobSystem &      jobs,
+    const BoxSweep * sweeps,
+    unsigned         count,
+    Hit *            hitsOut,
+    unsigned         sweepsPerBatch
+) const {
+
+    // Queries only read the level, so batches need no synchronization.
+    auto sweepRange = [this, sweeps, hitsOut] (unsigned begin, unsigned end) {
+        SweepBoxes(sweeps + begin, end - begin, hitsOut + begin);
+    };
+    jobs.ParallelFor(count, sweepsPerBatch, sweepRange);
+
+}
@@ -0,0 +1,115 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Christopher Higgins Barrett
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include "Level.hpp"
+
+class JobSystem;
+
+//==============================================================================
+// Point, ray and moving-box queries against a Level's tile collision.
+//
+// Queries are in world space.  Bind() captures the level's placement (its
+// transform may translate and scale the grid, not rotate it).  A tile at
+// (x, y) covers the same area its sprite draws over: sprites hang down and
+// right of their anchor, so the cell spans [x, x+1) tile widths across and
+// [y-1, y) tile heights up from the level origin.  Solid tiles block the
+// whole cell, BottomHalf tiles its lower half.
+//
+// Moving queries walk the grid with a DDA along the box's leading edges, so
+// only cells the box actually enters are tested: cost depends on distance
+// moved and box size, never on level size.  Boxes touching a surface slide
+// along it; boxes that start overlapping a tile ignore that tile.
+class LevelCollision {
+public: // Types
+    struct Hit {
+        float                 time;    // Fraction of the move made before contact, [0, 1]
+        float                 normalX; // Surface normal, axis-aligned
+        float                 normalY;
+        int                   tileX;
+        int                   tileY;
+        Level::ETileCollision collision; // None if nothing was hit
+    };
+
+    struct BoxSweep {
+        WorldRect box;
+        float     dx;
+        float     dy;
+    };
+
+    struct MoveResult {
+        float dx; // Displacement actually made
+        float dy;
+        bool  blockedX;
+        bool  blockedY;
+        bool  grounded; // Blocked while moving down
+    };
+
+private: // Data
+    const Level * m_level;
+    float         m_originX;
+    float         m_originY;
+    float         m_cellWidth;
+    float         m_cellHeight;
+
+private: // Helpers
+    static const LevelCollision *& ActiveSlot ();
+
+    int  CellX (float x) const;
+    int  CellY (float y) const;
+    void CellRangeX (float minX, float maxX, int * beginOut, int * endOut) const;
+    void CellRangeY (float minY, float maxY, int * beginOut, int * endOut) const;
+    bool GetSolidBox (int cellX, int cellY, WorldRect * boxOut, Level::ETileCollision * collisionOut) const;
+    void TestCell (int cellX, int cellY, const WorldRect & box, float dx, float dy, Hit * bestInOut) const;
+
+public:
+    LevelCollision ();
+
+    // Commands
+    void Bind (const Level & level, const Transform & levelTransform);
+    void Unbind ()                              { m_level = nullptr; }
+
+    // The level actors collide with; set by GocLevel.  May be null.
+    static void                   SetActive (const LevelCollision * collision) { ActiveSlot() = collision; }
+    static const LevelCollision * GetActive ()                                 { return ActiveSlot(); }
+
+    // Queries
+    bool                  IsBound () const      { return m_level != nullptr; }
+    float                 GetCellWidth () const  { return m_cellWidth; }
+    float                 GetCellHeight () const { return m_cellHeight; }
+    Level::ETileCollision QueryPoint (float x, float y) const;
+    bool                  Raycast (float x, float y, float dx, float dy, Hit * hitOut) const;
+    bool                  SweepBox (const WorldRect & box, float dx, float dy, Hit * hitOut) const;
+
+    // Distance the box can drop (up to maxDistance) before landing.
+    bool                  ProbeGround (const WorldRect & box, float maxDistance, float * distanceOut) const;
+
+    // Moves the box, stopping at contacts and sliding along them.
+    void                  MoveAndSlide (const WorldRect & box, float dx, float dy, MoveResult * resultOut, unsigned maxSlides = 3) const;
+
+    // Many sweeps at once; hitsOut[i].collision is None where nothing was hit.
+    void                  SweepBoxes (const BoxSweep * sweeps, unsigned count, Hit * hitsOut) const;
+    void                  SweepBoxesParallel (JobSystem & jobs, const BoxSweep * sweeps, unsigned count, Hit * hitsOut, unsigned sweepsPerBatch = 64) const;
+};
@@ -0,0 +1,114 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Christopher Higgins Barrett
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+// Offline level cook: turns JSON level datafiles into the cooked files
+// BuildFromCookedFile and CookedLevelChunkSource map, and checks them.
+//
+//   usage: <exe> [-check] datafile...
+//
+// For every "dir/name.json" this writes "dir/name.clvl" unless the cooked
+// file already matches the datafile's bytes (see Level::CookDatafile), then
+// validates it and prints its size, chunk and legend counts.  With -check,
+// nothing is cooked; each argument's cooked file is only validated, so it
+// can be pointed at "name.json" or "name.clvl" alike.  Exits nonzero if any
+// file can't be cooked or fails validation.
+//
+// Built by CMakeLists.txt at the repository root, not the Windows project.
+// This build can't parse JSON, so it only cooks datafiles whose cooked file
+// is already current; -check works on any cooked file.
+
+#include "Level.hpp"
+#include "LevelFile.hpp"
+#include "../MappedFile.h"
+
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+//==============================================================================
+bool CheckCookedFile (const std::string & cookedPath) {
+
+    Core::MappedFile cooked;
+    if (!cooked.Open(cookedPath.c_str())) {
+        fprintf(stderr, "Can't open %s\n", cookedPath.c_str());
+        return false;
+    }
+
+    const LevelFile::Header * header = LevelFile::Validate(cooked.GetData(), cooked.GetSize());
+    if (!header) {
+        fprintf(stderr, "%s isn't a valid cooked level\n", cookedPath.c_str());
+        return false;
+    }
+
+    printf(
+        "%s  %ux%u tiles  %ux%u chunks (%u stored)  legends %u  %u bytes\n",
+        cookedPath.c_str(),
+        header->width,
+        header->height,
+        header->chunksWide,
+        header->chunksHigh,
+        header->chunkDataCount,
+        header->legendCount,
+        unsigned(cooked.GetSize())
+    );
+    return true;
+
+}
+
+} // namespace
+
+//==============================================================================
+int main (int argc, char ** argv) {
+
+    bool                     checkOnly = false;
+    std::vector<std::string> datafilePaths;
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "-check"))
+            checkOnly = true;
+        else
+            datafilePaths.push_back(argv[i]);
+    }
+
+    if (datafilePaths.empty()) {
+        fprintf(stderr, "usage: %s [-check] datafile...\n", argv[0]);
+        return 1;
+    }
+
+    unsigned failures = 0;
+    for (const std::string & datafilePath : datafilePaths) {
+        const std::string cookedPath = LevelFile::GetCookedPath(datafilePath.c_str());
+        if (!checkOnly && !Level::CookDatafile(datafilePath.c_str(), cookedPath.c_str())) {
+            fprintf(stderr, "Can't cook %s\n", datafilePath.c_str());
+            ++failures;
+            continue;
+        }
+
+        if (!CheckCookedFile(cookedPath))
+            ++failures;
+    }
+
+    return failures ? 1 : 0;
+
+}
@@ -0,0 +1,136 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Christopher Higgins Barrett
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+// The JSON side of Level, kept apart so builds without the JSON parser (the
+// headless runner) can link everything else.
+
+#include "Level.hpp"
+
+#include <DataMap.hpp>
+#include <JsonParserCallbackForDataMap.hpp>
+#include <DataMapReaderSimple.hpp>
+
+//==============================================================================
+bool Level::ParseDatafile (const char * filepath, Desc * descOut, std::vector<unsigned short> * tilesOut) {
+
+    CSaruContainer::DataMap                 dataMap;
+    CSaruJson::JsonParserCallbackForDataMap callback(dataMap.GetMutator());
+
+    FILE * file = Core::OpenFile(filepath, "rt");
+    if (!file)
+        return false;
+    
+    CSaruJson::JsonParser parser;
+    if (!parser.ParseEntireFile(
+        file,
+        NULL,
+        0,
+        &callback
+    )) {
+        ASSERT(0 && "Failed to parse spritesheet file.");
+        fclose(file);
+        return false;
+    }
+    fclose(file);
+    file = nullptr;
+    
+    CSaruContainer::DataMapReader reader = dataMap.GetReader();
+    
+    reader.ToChild("level");
+    if (!reader.IsValid())
+        return false;
+
+    char    tempStr[512];
+    wchar_t tempWStr[512];
+        
+    // Get spritesheet name
+    reader.ToChild("name");
+    if (!reader.IsValid())
+        return false;
+    if (!reader.ReadStringSafe(tempStr, arrsize(tempStr)))
+        return false;
+    swprintf_s(tempWStr, L"%S", tempStr);
+    descOut->name = tempWStr;
+
+    // Get size
+    reader.PopNode().ToChild("width");
+    if (!reader.IsValid())
+        return false;
+    const unsigned width = reader.ReadInt();
+    reader.PopNode().ToChild("height");
+    if (!reader.IsValid())
+        return false;
+    const unsigned height = reader.ReadInt();
+
+    if (!width || !height)
+        return false;
+    descOut->width  = width;
+    descOut->height = height;
+
+    // Read in the tile legend
+    descOut->legend.clear();
+    reader.PopNode().ToChild("visual").ToChild("legend");
+    {
+        reader.ToFirstChild();
+        do {
+            CSaruContainer::DataMapReaderSimple simple(reader);
+            const unsigned                      legendIndex = simple.Int("key");
+            if (descOut->legend.size() <= legendIndex)
+                descOut->legend.resize(legendIndex + 1);
+
+            LegendDesc & legend = descOut->legend[legendIndex];
+            legend.collision  = static_cast<Level::ETileCollision>(simple.Int("collision"));
+            legend.spriteFile = simple.String("spritefile");
+            legend.anim       = simple.WString("anim");
+
+        } while (reader.ToNextSibling().IsValid());
+
+        reader.PopNode().PopNode();
+    }
+        
+    // Prepare to read in rows
+    reader.PopNode().ToChild("terrainRows");
+    if (!reader.IsValid())
+        return false;
+    
+    // Try reading in each row; the file lists the top row first.
+    tilesOut->assign(width * height, 0);
+    unsigned y = 0;
+    for (reader.ToFirstChild(); reader.IsValid() && y < height; reader.ToNextSibling()) {
+    
+        CSaruContainer::DataMapReader rowReader(reader);
+        rowReader.ToFirstChild();
+        for (unsigned x = 0; x < width; ++x) {
+            const unsigned legendIndex = rowReader.ReadIntWalk();
+            ASSERT(legendIndex < descOut->legend.size());
+            ASSERT(legendIndex <= 0xFFFF && "Tiles store 16-bit legend indices.");
+            (*tilesOut)[((height - y) - 1) * width + x] = (unsigned short)legendIndex;
+        }
+
+        ++y;
+    }
+
+    return true;
+
+}
@@ -0,0 +1,310 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Christopher Higgins Barrett
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "LevelFile.hpp"
+
+#include <type_traits>
+
+namespace LevelFile {
+
+namespace {
+
+static_assert(sizeof(Level::TileChunk) % 16 == 0, "Cooked chunk records are kept 16-byte aligned.");
+
+//==============================================================================
+// Wide strings are stored as UTF-8.  Only the BMP is handled, which is all a
+// 16-bit wchar_t holds without surrogates.
+void AppendUtf8 (const std::wstring & str, std::vector<char> * bytesOut) {
+
+    for (wchar_t wc : str) {
+        const unsigned c = unsigned(wc) & 0xFFFF;
+        if (c < 0x80) {
+            bytesOut->push_back(char(c));
+        }
+        else if (c < 0x800) {
+            bytesOut->push_back(char(0xC0 | (c >> 6)));
+            bytesOut->push_back(char(0x80 | (c & 0x3F)));
+        }
+        else {
+            bytesOut->push_back(char(0xE0 | (c >> 12)));
+            bytesOut->push_back(char(0x80 | ((c >> 6) & 0x3F)));
+            bytesOut->push_back(char(0x80 | (c & 0x3F)));
+        }
+    }
+
+}
+
+//==============================================================================
+std::wstring DecodeUtf8 (const char * str) {
+
+    std::wstring result;
+    const unsigned char * s = reinterpret_cast<const unsigned char *>(str);
+    while (*s) {
+        unsigned c = *s++;
+        if (c >= 0xE0 && s[0] && s[1]) {
+            c = (c & 0x0F) << 12 | (s[0] & 0x3F) << 6 | (s[1] & 0x3F);
+            s += 2;
+        }
+        else if (c >= 0xC0 && s[0]) {
+            c = (c & 0x1F) << 6 | (s[0] & 0x3F);
+            s += 1;
+        }
+        result.push_back(wchar_t(c));
+    }
+
+    return result;
+
+}
+
+//==============================================================================
+class StringTable {
+private: // Data
+    std::vector<char>                    m_bytes;
+    std::map<std::string, std::uint32_t> m_offsets;
+
+public:
+    StringTable () : m_bytes(1, '\0') {}
+
+    std::uint32_t Add (const std::string & str) {
+        if (str.empty())
+            return 0;
+
+        std::map<std::string, std::uint32_t>::const_iterator it = m_offsets.find(str);
+        if (it != m_offsets.end())
+            return it->second;
+
+        const std::uint32_t offset = std::uint32_t(m_bytes.size());
+        m_bytes.insert(m_bytes.end(), str.begin(), str.end());
+        m_bytes.push_back('\0');
+        m_offsets[str] = offset;
+        return offset;
+    }
+
+    std::uint32_t Add (const std::wstring & str) {
+        std::vector<char> utf8;
+        AppendUtf8(str, &utf8);
+        return Add(std::string(utf8.begin(), utf8.end()));
+    }
+
+    const std::vector<char> & GetBytes () const { return m_bytes; }
+};
+
+//==============================================================================
+template <typename T>
+const T * At (const void * data, std::uint32_t offset) {
+    return reinterpret_cast<const T *>(static_cast<const char *>(data) + offset);
+}
+
+//==============================================================================
+bool RangeInside (size_t fileSize, std::uint32_t offset, size_t count, size_t elementSize) {
+    return offset <= fileSize && count <= (fileSize - offset) / elementSize;
+}
+
+} // namespace
+
+//==============================================================================
+bool Write (const char * filepath, const Level::Desc & desc, const std::vector<unsigned short> & tiles, std::uint64_t contentHash) {
+
+    ASSERT(tiles.size() == desc.width * desc.height);
+
+    const unsigned chunkTiles = Level::s_chunkTiles;
+    const unsigned chunksWide = (desc.width  + chunkTiles - 1) / chunkTiles;
+    const unsigned chunksHigh = (desc.height + chunkTiles - 1) / chunkTiles;
+
+    StringTable strings;
+
+    std::vector<Legend> legends(desc.legend.size());
+    for (unsigned i = 0; i < legends.size(); ++i) {
+        legends[i].spriteFileString = strings.Add(desc.legend[i].spriteFile);
+        legends[i].animString       = strings.Add(desc.legend[i].anim);
+        legends[i].collision        = std::uint32_t(desc.legend[i].collision);
+    }
+
+    // Only chunks with a non-zero tile get a record
+    std::vector<std::uint32_t>    chunkTable(chunksWide * chunksHigh, s_emptyChunk);
+    std::vector<Level::TileChunk> chunkData;
+    for (unsigned chunkY = 0; chunkY < chunksHigh; ++chunkY) {
+        for (unsigned chunkX = 0; chunkX < chunksWide; ++chunkX) {
+            Level::TileChunk chunk;
+            memset(&chunk, 0, sizeof(chunk));
+
+            bool empty = true;
+            for (unsigned y = 0; y < chunkTiles && chunkY * chunkTiles + y < desc.height; ++y) {
+                for (unsigned x = 0; x < chunkTiles && chunkX * chunkTiles + x < desc.width; ++x) {
+                    const unsigned short legendIndex = tiles[(chunkY * chunkTiles + y) * desc.width + chunkX * chunkTiles + x];
+                    chunk.legendIndices[y * chunkTiles + x] = legendIndex;
+                    empty = empty && !legendIndex;
+                }
+            }
+
+            if (empty)
+                continue;
+
+            chunkTable[chunkY * chunksWide + chunkX] = std::uint32_t(chunkData.size());
+            chunkData.push_back(chunk);
+        }
+    }
+
+    Header header;
+    header.magic             = s_magic;
+    header.version           = s_version;
+    header.contentHash       = contentHash;
+    header.width             = desc.width;
+    header.height            = desc.height;
+    header.chunkTiles        = chunkTiles;
+    header.chunksWide        = chunksWide;
+    header.chunksHigh        = chunksHigh;
+    header.nameString        = strings.Add(desc.name);
+    header.legendCount       = std::uint32_t(legends.size());
+    header.legendOffset      = sizeof(Header);
+    header.chunkTableOffset  = header.legendOffset + std::uint32_t(legends.size() * sizeof(Legend));
+    header.chunkDataOffset   = (header.chunkTableOffset + std::uint32_t(chunkTable.size() * sizeof(std::uint32_t)) + 15) & ~15u;
+    header.chunkDataCount    = std::uint32_t(chunkData.size());
+    header.stringTableOffset = header.chunkDataOffset + std::uint32_t(chunkData.size() * sizeof(Level::TileChunk));
+    header.stringTableSize   = std::uint32_t(strings.GetBytes().size());
+
+    std::vector<char> file(header.stringTableOffset + header.stringTableSize, '\0');
+    memcpy(&file[0], &header, sizeof(header));
+    if (!legends.empty())
+        memcpy(&file[header.legendOffset], &legends[0], legends.size() * sizeof(Legend));
+    memcpy(&file[header.chunkTableOffset], &chunkTable[0], chunkTable.size() * sizeof(std::uint32_t));
+    if (!chunkData.empty())
+        memcpy(&file[header.chunkDataOffset], &chunkData[0], chunkData.size() * sizeof(Level::TileChunk));
+    memcpy(&file[header.stringTableOffset], &strings.GetBytes()[0], header.stringTableSize);
+
+    FILE * out = Core::OpenFile(filepath, "wb");
+    if (!out)
+        return false;
+    const bool ok = fwrite(&file[0], 1, file.size(), out) == file.size();
+    fclose(out);
+
+    return ok;
+
+}
+
+//==============================================================================
+const Header * Validate (const void * data, size_t size) {
+
+    if (!data || size < sizeof(Header))
+        return nullptr;
+
+    const Header * header = At<Header>(data, 0);
+    if (header->magic != s_magic || header->version != s_version)
+        return nullptr;
+    if (header->chunkTiles != Level::s_chunkTiles || !header->width || !header->height)
+        return nullptr;
+    if (header->chunksWide != (header->width  + Level::s_chunkTiles - 1) / Level::s_chunkTiles)
+        return nullptr;
+    if (header->chunksHigh != (header->height + Level::s_chunkTiles - 1) / Level::s_chunkTiles)
+        return nullptr;
+
+    // Tables are read in place, so each must start past the header and on
+    // its elements' alignment; chunk data is also 16-aligned for Level.
+    if (header->legendOffset      < sizeof(Header) || header->legendOffset     % std::alignment_of<Legend>::value        ||
+        header->chunkTableOffset  < sizeof(Header) || header->chunkTableOffset % std::alignment_of<std::uint32_t>::value ||
+        header->chunkDataOffset   < sizeof(Header) || header->chunkDataOffset  % 16                                      ||
+        header->stringTableOffset < sizeof(Header))
+        return nullptr;
+
+    const size_t chunkCount = size_t(header->chunksWide) * header->chunksHigh;
+    if (!RangeInside(size, header->legendOffset,      header->legendCount,     sizeof(Legend))           ||
+        !RangeInside(size, header->chunkTableOffset,  chunkCount,              sizeof(std::uint32_t))    ||
+        !RangeInside(size, header->chunkDataOffset,   header->chunkDataCount,  sizeof(Level::TileChunk)) ||
+        !RangeInside(size, header->stringTableOffset, header->stringTableSize, 1)                        ||
+        !header->stringTableSize)
+        return nullptr;
+
+    // The string table must end in a terminator, and every reference land in it.
+    const char * strings = At<char>(data, header->stringTableOffset);
+    if (strings[header->stringTableSize - 1] != '\0' || header->nameString >= header->stringTableSize)
+        return nullptr;
+
+    const Legend * legends = At<Legend>(data, header->legendOffset);
+    for (std::uint32_t i = 0; i < header->legendCount; ++i) {
+        if (legends[i].spriteFileString >= header->stringTableSize ||
+            legends[i].animString       >= header->stringTableSize ||
+            legends[i].collision        >= std::uint32_t(Level::ETileCollision::TERM))
+            return nullptr;
+    }
+
+    // Tile legend indices themselves aren't scanned; that would touch every
+    // page of the mapping.  Level reads out-of-range ones as legend 0.
+    const std::uint32_t * chunkTable = At<std::uint32_t>(data, header->chunkTableOffset);
+    for (size_t i = 0; i < chunkCount; ++i) {
+        if (chunkTable[i] != s_emptyChunk && chunkTable[i] >= header->chunkDataCount)
+            return nullptr;
+    }
+
+    return header;
+
+}
+
+//==============================================================================
+void ReadDesc (const void * data, Level::Desc * descOut) {
+
+    const Header * header  = At<Header>(data, 0);
+    const char *   strings = At<char>(data, header->stringTableOffset);
+
+    descOut->name   = DecodeUtf8(strings + header->nameString);
+    descOut->width  = header->width;
+    descOut->height = header->height;
+
+    const Legend * legends = At<Legend>(data, header->legendOffset);
+    descOut->legend.resize(header->legendCount);
+    for (std::uint32_t i = 0; i < header->legendCount; ++i) {
+        Level::LegendDesc & legend = descOut->legend[i];
+        legend.collision  = Level::ETileCollision(legends[i].collision);
+        legend.spriteFile = strings + legends[i].spriteFileString;
+        legend.anim       = DecodeUtf8(strings + legends[i].animString);
+    }
+
+}
+
+//==============================================================================
+const Level::TileChunk * GetChunk (const void * data, unsigned chunkIndex) {
+
+    const Header *        header     = At<Header>(data, 0);
+    const std::uint32_t * chunkTable = At<std::uint32_t>(data, header->chunkTableOffset);
+    if (chunkTable[chunkIndex] == s_emptyChunk)
+        return nullptr;
+
+    return At<Level::TileChunk>(data, header->chunkDataOffset) + chunkTable[chunkIndex];
+
+}
+
+//==============================================================================
+std::string GetCookedPath (const char * datafilePath) {
+
+    std::string path = datafilePath;
+
+    const size_t dot   = path.find_last_of('.');
+    const size_t slash = path.find_last_of("/\\");
+    if (dot != std::string::npos && (slash == std::string::npos || dot > slash))
+        path.erase(dot);
+
+    return path + s_extension;
+
+}
+
+} // namespace LevelFile
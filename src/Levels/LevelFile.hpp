@@ -0,0 +1,96 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Christopher Higgins Barrett
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include "Level.hpp"
+
+//==============================================================================
+// Cooked (binary) level files.
+//
+// Layout, all little-endian, all offsets in bytes from the start of the file:
+//
+//     Header
+//     Legend[legendCount]
+//     uint32 chunkTable[chunksWide * chunksHigh]   index into chunk data, or
+//                                                  s_emptyChunk (all legend 0)
+//     (pad to 16)
+//     Level::TileChunk chunkData[chunkDataCount]   16-bit legend indices,
+//                                                  row-major per chunk
+//     string table                                 NUL-terminated UTF-8;
+//                                                  offset 0 is ""
+//
+// Chunk data is exactly Level's in-memory chunk layout, so a mapped file can
+// back Level's chunks directly with no parsing.
+//
+// contentHash is Core::Fnv1aHash64 of the source datafile's bytes;
+// Level::CookDatafile compares it to recook levels whose datafile changed.
+namespace LevelFile {
+
+const std::uint32_t s_magic      = 'C' | 'L' << 8 | 'V' << 16 | 'L' << 24; // "CLVL"
+const std::uint32_t s_version    = 2;
+const std::uint32_t s_emptyChunk = std::uint32_t(-1);
+const char          s_extension[] = ".clvl";
+
+struct Header {
+    std::uint32_t magic;
+    std::uint32_t version;
+    std::uint64_t contentHash;
+    std::uint32_t width;
+    std::uint32_t height;
+    std::uint32_t chunkTiles;
+    std::uint32_t chunksWide;
+    std::uint32_t chunksHigh;
+    std::uint32_t nameString;
+    std::uint32_t legendCount;
+    std::uint32_t legendOffset;
+    std::uint32_t chunkTableOffset;
+    std::uint32_t chunkDataOffset;
+    std::uint32_t chunkDataCount;
+    std::uint32_t stringTableOffset;
+    std::uint32_t stringTableSize;
+};
+
+struct Legend {
+    std::uint32_t spriteFileString;
+    std::uint32_t animString;
+    std::uint32_t collision;
+};
+
+// tiles: row-major, bottom row first (see Level::ParseDatafile).
+bool Write (const char * filepath, const Level::Desc & desc, const std::vector<unsigned short> & tiles, std::uint64_t contentHash);
+
+// Checks the header and that every table lies inside the data.  Returns the
+// header, or null if the data isn't a usable level file.  Tile legend indices
+// aren't checked; see Level::GetTileLegendIndex.
+const Header * Validate (const void * data, size_t size);
+
+// Both expect data that passed Validate.
+void                     ReadDesc (const void * data, Level::Desc * descOut);
+const Level::TileChunk * GetChunk (const void * data, unsigned chunkIndex); // Null: all legend 0
+
+// "levels/level0.json" -> "levels/level0.clvl"
+std::string GetCookedPath (const char * datafilePath);
+
+} // namespace LevelFile
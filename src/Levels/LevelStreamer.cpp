@@ -0,0 +1,392 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Christopher Higgins Barrett
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "LevelStreamer.hpp"
+#include "LevelFile.hpp"
+
+#include <thread>
+
+//==============================================================================
+// JsonLevelChunkSource
+//==============================================================================
+
+//==============================================================================
+JsonLevelChunkSource::JsonLevelChunkSource (const char * filepath) :
+    m_filepath(filepath),
+    m_width(0),
+    m_height(0)
+{}
+
+//==============================================================================
+bool JsonLevelChunkSource::Open (Level::Desc * descOut) {
+
+    if (!Level::ParseDatafile(m_filepath.c_str(), descOut, &m_tiles))
+        return false;
+
+    m_width  = descOut->width;
+    m_height = descOut->height;
+    return true;
+
+}
+
+//==============================================================================
+bool JsonLevelChunkSource::ReadChunk (unsigned chunkX, unsigned chunkY, Level::TileChunk * chunkOut) {
+
+    memset(chunkOut, 0, sizeof(Level::TileChunk));
+
+    const unsigned beginX = chunkX * Level::s_chunkTiles;
+    const unsigned beginY = chunkY * Level::s_chunkTiles;
+    if (beginX >= m_width || beginY >= m_height)
+        return false;
+
+    const unsigned rowLength = MIN(Level::s_chunkTiles, m_width - beginX);
+    const unsigned rowCount  = MIN(Level::s_chunkTiles, m_height - beginY);
+    for (unsigned row = 0; row < rowCount; ++row) {
+        memcpy(
+            &chunkOut->legendIndices[row * Level::s_chunkTiles],
+            &m_tiles[(beginY + row) * m_width + beginX],
+            rowLength * sizeof(unsigned short)
+        );
+    }
+
+    return true;
+
+}
+
+//==============================================================================
+// CookedLevelChunkSource
+//==============================================================================
+
+//==============================================================================
+CookedLevelChunkSource::CookedLevelChunkSource (const char * filepath) :
+    m_filepath(filepath)
+{}
+
+//==============================================================================
+bool CookedLevelChunkSource::Open (Level::Desc * descOut) {
+
+    if (!m_file.Open(m_filepath.c_str()) || !LevelFile::Validate(m_file.GetData(), m_file.GetSize()))
+        return false;
+
+    LevelFile::ReadDesc(m_file.GetData(), descOut);
+    return true;
+
+}
+
+//==============================================================================
+bool CookedLevelChunkSource::ReadChunk (unsigned chunkX, unsigned chunkY, Level::TileChunk * chunkOut) {
+
+    const LevelFile::Header * header = static_cast<const LevelFile::Header *>(m_file.GetData());
+    if (chunkX >= header->chunksWide || chunkY >= header->chunksHigh)
+        return false;
+
+    const Level::TileChunk * chunk = LevelFile::GetChunk(m_file.GetData(), chunkY * header->chunksWide + chunkX);
+    if (chunk)
+        memcpy(chunkOut, chunk, sizeof(Level::TileChunk));
+    else
+        memset(chunkOut, 0, sizeof(Level::TileChunk));
+
+    return true;
+
+}
+
+//==============================================================================
+// LevelStreamer
+//==============================================================================
+
+//==============================================================================
+LevelStreamer::Shared::Shared (ILevelChunkSource * source) :
+    source(source),
+    descReady(false),
+    openOk(false),
+    quit(false),
+    chunksWide(0)
+{}
+
+//==============================================================================
+LevelStreamer::Shared::~Shared () {
+
+    for (const Completed & result : completed)
+        delete result.chunk;
+
+}
+
+//==============================================================================
+LevelStreamer::LevelStreamer (ILevelChunkSource * source, const LevelStreamSettings & settings) :
+    m_shared(std::make_shared<Shared>(source)),
+    m_settings(settings),
+    m_failedChunkCount(0),
+    m_frame(0),
+    m_status(STREAM_STATUS_OPENING)
+{
+    ASSERT(source);
+    std::thread(&LevelStreamer::ThreadMain, m_shared).detach();
+}
+
+//==============================================================================
+LevelStreamer::~LevelStreamer () {
+
+    {
+        std::lock_guard<std::mutex> lock(m_shared->mutex);
+        m_shared->quit = true;
+    }
+    m_shared->wake.notify_all();
+
+}
+
+//==============================================================================
+void LevelStreamer::ThreadMain (std::shared_ptr<Shared> shared) {
+
+    Level::Desc desc;
+    const bool  openOk = shared->source->Open(&desc);
+    {
+        std::lock_guard<std::mutex> lock(shared->mutex);
+        if (shared->quit)
+            return;
+
+        shared->desc      = desc;
+        shared->descReady = true;
+        shared->openOk    = openOk;
+    }
+
+    if (!openOk)
+        return;
+
+    for (;;) {
+        unsigned chunkIndex;
+        unsigned chunksWide;
+        {
+            std::unique_lock<std::mutex> lock(shared->mutex);
+            shared->wake.wait(lock, [&shared] { return shared->quit || !shared->requests.empty(); });
+            if (shared->quit)
+                return;
+
+            chunkIndex = shared->requests.front();
+            chunksWide = shared->chunksWide;
+            shared->requests.pop_front();
+        }
+
+        Completed completed;
+        completed.chunkIndex = chunkIndex;
+        completed.chunk      = new Level::TileChunk;
+        completed.ok         = shared->source->ReadChunk(chunkIndex % chunksWide, chunkIndex / chunksWide, completed.chunk);
+
+        // All-zero chunks are stored as nullptr, same as a full load.
+        bool empty = true;
+        for (unsigned short legendIndex : completed.chunk->legendIndices) {
+            if (legendIndex) {
+                empty = false;
+                break;
+            }
+        }
+        if (empty || !completed.ok) {
+            delete completed.chunk;
+            completed.chunk = nullptr;
+        }
+
+        std::lock_guard<std::mutex> lock(shared->mutex);
+        shared->completed.push_back(completed);
+    }
+
+}
+
+//==============================================================================
+void LevelStreamer::Evict (Level & level) {
+
+    const size_t budgetChunks = MAX(size_t(1), m_settings.memoryBudgetBytes / sizeof(Level::TileChunk));
+    if (m_resident.size() <= budgetChunks)
+        return;
+
+    // Oldest first; anything wanted this frame or edited stays.
+    std::vector<unsigned> candidates;
+    for (unsigned chunkIndex : m_resident) {
+        if (m_lastWanted[chunkIndex] != m_frame && !m_pinned[chunkIndex])
+            candidates.push_back(chunkIndex);
+    }
+    std::sort(candidates.begin(), candidates.end(), [this] (unsigned a, unsigned b) {
+        return m_lastWanted[a] < m_lastWanted[b];
+    });
+
+    const size_t evictCount = MIN(candidates.size(), m_resident.size() - budgetChunks);
+    for (size_t i = 0; i < evictCount; ++i) {
+        level.EvictChunk(candidates[i]);
+        m_states[candidates[i]] = CHUNK_STATE_ABSENT;
+    }
+
+    m_resident.erase(
+        std::remove_if(m_resident.begin(), m_resident.end(), [this] (unsigned chunkIndex) {
+            return m_states[chunkIndex] != CHUNK_STATE_RESIDENT;
+        }),
+        m_resident.end()
+    );
+
+}
+
+//==============================================================================
+bool LevelStreamer::Pump (Level & level, const LevelChunkRange & focus) {
+
+    if (HasFailed())
+        return false;
+
+    ++m_frame;
+
+    // Apply the level description once the thread has read it
+    if (m_status == STREAM_STATUS_OPENING) {
+        Level::Desc desc;
+        {
+            std::lock_guard<std::mutex> lock(m_shared->mutex);
+            if (!m_shared->descReady)
+                return true;
+            if (!m_shared->openOk) {
+                m_status = STREAM_STATUS_OPEN_FAILED;
+                return false;
+            }
+            desc = m_shared->desc;
+        }
+
+        // Spritesheets load here, on the main thread, with the graphics.
+        // Trying again next frame would only reload them to fail again.
+        if (!level.BuildFromDesc(desc)) {
+            m_status = STREAM_STATUS_BUILD_FAILED;
+            return false;
+        }
+
+        const unsigned chunkCount = level.GetChunksWide() * level.GetChunksHigh();
+        m_states.assign(chunkCount, CHUNK_STATE_ABSENT);
+        m_readFailures.assign(chunkCount, 0);
+        m_lastWanted.assign(chunkCount, 0);
+        m_pinned.assign(chunkCount, false);
+        {
+            std::lock_guard<std::mutex> lock(m_shared->mutex);
+            m_shared->chunksWide = level.GetChunksWide();
+        }
+        m_status = STREAM_STATUS_READY;
+    }
+
+    // Install whatever finished loading
+    std::vector<Completed> completed;
+    {
+        std::lock_guard<std::mutex> lock(m_shared->mutex);
+        completed.swap(m_shared->completed);
+    }
+    for (const Completed & result : completed) {
+        // A failed read is requested again while wanted, up to the limit.
+        if (!result.ok) {
+            if (++m_readFailures[result.chunkIndex] < s_maxChunkReadAttempts) {
+                m_states[result.chunkIndex] = CHUNK_STATE_ABSENT;
+                continue;
+            }
+
+            m_states[result.chunkIndex] = CHUNK_STATE_FAILED;
+            ++m_failedChunkCount;
+            continue;
+        }
+
+        ASSERT(m_states[result.chunkIndex] == CHUNK_STATE_QUEUED);
+        level.InstallChunk(result.chunkIndex, result.chunk);
+        m_states[result.chunkIndex]       = CHUNK_STATE_RESIDENT;
+        m_readFailures[result.chunkIndex] = 0;
+        m_resident.push_back(result.chunkIndex);
+    }
+
+    // Widen the focus by the prefetch margin
+    const unsigned  chunksWide = level.GetChunksWide();
+    const unsigned  chunksHigh = level.GetChunksHigh();
+    const unsigned  margin     = m_settings.prefetchChunks;
+    LevelChunkRange wanted     = { 0, 0, 0, 0 };
+    if (!focus.IsEmpty()) {
+        wanted.beginX = focus.beginX > margin ? focus.beginX - margin : 0;
+        wanted.beginY = focus.beginY > margin ? focus.beginY - margin : 0;
+        wanted.endX   = MIN(focus.endX + margin, chunksWide);
+        wanted.endY   = MIN(focus.endY + margin, chunksHigh);
+    }
+
+    // Gather what's missing, nearest the focus center first
+    std::vector<unsigned> missing;
+    for (unsigned chunkY = wanted.beginY; chunkY < wanted.endY; ++chunkY) {
+        for (unsigned chunkX = wanted.beginX; chunkX < wanted.endX; ++chunkX) {
+            const unsigned chunkIndex = chunkY * chunksWide + chunkX;
+            m_lastWanted[chunkIndex] = m_frame;
+            if (m_states[chunkIndex] == CHUNK_STATE_ABSENT)
+                missing.push_back(chunkIndex);
+        }
+    }
+
+    const int centerX2 = int(focus.beginX + focus.endX);
+    const int centerY2 = int(focus.beginY + focus.endY);
+    std::sort(missing.begin(), missing.end(), [=] (unsigned a, unsigned b) {
+        const int ax = int(a % chunksWide) * 2 + 1 - centerX2;
+        const int ay = int(a / chunksWide) * 2 + 1 - centerY2;
+        const int bx = int(b % chunksWide) * 2 + 1 - centerX2;
+        const int by = int(b / chunksWide) * 2 + 1 - centerY2;
+        return ax * ax + ay * ay < bx * bx + by * by;
+    });
+
+    {
+        std::lock_guard<std::mutex> lock(m_shared->mutex);
+        std::deque<unsigned> &      requests = m_shared->requests;
+
+        // Requests the thread hasn't started on are dropped once unwanted.
+        for (std::deque<unsigned>::iterator it = requests.begin(); it != requests.end(); ) {
+            if (m_lastWanted[*it] == m_frame) {
+                ++it;
+                continue;
+            }
+            m_states[*it] = CHUNK_STATE_ABSENT;
+            it = requests.erase(it);
+        }
+
+        for (unsigned chunkIndex : missing) {
+            m_states[chunkIndex] = CHUNK_STATE_QUEUED;
+            requests.push_back(chunkIndex);
+        }
+    }
+    if (!missing.empty())
+        m_shared->wake.notify_one();
+
+    Evict(level);
+    return true;
+
+}
+
+//==============================================================================
+// Gives chunks that ran out of read attempts a fresh set; the next Pump
+// requests any that are still wanted.
+void LevelStreamer::RetryFailedChunks () {
+
+    for (unsigned chunkIndex = 0; chunkIndex < m_states.size(); ++chunkIndex) {
+        if (m_states[chunkIndex] != CHUNK_STATE_FAILED)
+            continue;
+
+        m_states[chunkIndex]       = CHUNK_STATE_ABSENT;
+        m_readFailures[chunkIndex] = 0;
+    }
+    m_failedChunkCount = 0;
+
+}
+
+//==============================================================================
+size_t LevelStreamer::GetResidentBytes () const {
+    return m_resident.size() * sizeof(Level::TileChunk);
+}
@@ -0,0 +1,195 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Christopher Higgins Barrett
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+
+#include "Level.hpp"
+#include "../MappedFile.h"
+
+//==============================================================================
+// Where streamed level data comes from.  Both methods run on the streaming
+// thread; nothing here may touch graphics or the Level itself.
+class ILevelChunkSource {
+public:
+    virtual ~ILevelChunkSource () {}
+
+    // Called once, before any ReadChunk.
+    virtual bool Open (Level::Desc * descOut) = 0;
+
+    // Fills every tile of the chunk; tiles past the level edge must be zero.
+    virtual bool ReadChunk (unsigned chunkX, unsigned chunkY, Level::TileChunk * chunkOut) = 0;
+};
+
+//==============================================================================
+// Reads a JSON level datafile.  The JSON layout has no random access by
+// chunk, so Open parses it once (on the streaming thread) and keeps only the
+// compact 16-bit tile grid; ReadChunk copies out of that.  The grid stays
+// resident for the source's lifetime, 2 bytes a tile, outside the streamer's
+// memory budget; levels too big for that should be cooked.
+class JsonLevelChunkSource : public ILevelChunkSource {
+private: // Data
+    std::string                 m_filepath;
+    unsigned                    m_width;
+    unsigned                    m_height;
+    std::vector<unsigned short> m_tiles;
+
+public:
+    explicit JsonLevelChunkSource (const char * filepath);
+
+    bool Open (Level::Desc * descOut) override;
+    bool ReadChunk (unsigned chunkX, unsigned chunkY, Level::TileChunk * chunkOut) override;
+};
+
+//==============================================================================
+// Reads a cooked level file (see LevelFile.hpp).  The file is mapped, so a
+// chunk read only faults in that chunk's pages, on the streaming thread.
+class CookedLevelChunkSource : public ILevelChunkSource {
+private: // Data
+    std::string      m_filepath;
+    Core::MappedFile m_file;
+
+public:
+    explicit CookedLevelChunkSource (const char * filepath);
+
+    bool Open (Level::Desc * descOut) override;
+    bool ReadChunk (unsigned chunkX, unsigned chunkY, Level::TileChunk * chunkOut) override;
+};
+
+//==============================================================================
+struct LevelStreamSettings {
+    size_t   memoryBudgetBytes; // Installed chunks kept resident, at most
+    unsigned prefetchChunks;    // Chunks loaded beyond the view on each side
+
+    LevelStreamSettings () :
+        memoryBudgetBytes(4 * 1024 * 1024),
+        prefetchChunks(1)
+    {}
+};
+
+//==============================================================================
+// Pages a Level's chunks in and out around a focus range.
+//
+// File I/O and parsing happen on one background thread.  Pump() is the only
+// main-thread entry point and never waits on the source: it installs chunks
+// the thread has finished, queues the ones the focus now needs (nearest
+// first), drops queued work that's no longer wanted, and evicts the least
+// recently wanted chunks while over budget.  Chunks edited with SetTile are
+// pinned and never evicted.
+//
+// Destruction doesn't wait on the thread either: the thread is detached and
+// finishes whatever read it's in (Open can be a long parse) on its own.
+//
+// Failures don't retry forever.  A source that can't be opened, or whose
+// description doesn't build, fails the whole stream; a chunk whose read fails
+// s_maxChunkReadAttempts times in a row is given up on and stays absent until
+// RetryFailedChunks.  Both show in GetStatus and the failed chunk queries.
+class LevelStreamer {
+public: // Types and Constants
+    enum EStreamStatus : unsigned char {
+        STREAM_STATUS_OPENING = 0,  // The thread hasn't read the description yet
+        STREAM_STATUS_READY,
+        STREAM_STATUS_OPEN_FAILED,  // The source couldn't be opened
+        STREAM_STATUS_BUILD_FAILED, // The description's legends didn't load
+    };
+
+    static const unsigned s_maxChunkReadAttempts = 3;
+
+private: // Types and Constants
+    enum EChunkState : unsigned char {
+        CHUNK_STATE_ABSENT = 0,
+        CHUNK_STATE_QUEUED,   // Requested; the thread may be reading it
+        CHUNK_STATE_RESIDENT,
+        CHUNK_STATE_FAILED,   // Out of read attempts; never requested again
+    };
+
+    struct Completed {
+        unsigned           chunkIndex;
+        Level::TileChunk * chunk; // nullptr: all legend 0
+        bool               ok;
+    };
+
+    // Everything the streaming thread touches.  The streamer and the thread
+    // each hold a reference, and whichever lets go last deletes the source.
+    struct Shared {
+        std::unique_ptr<ILevelChunkSource> source;
+
+        // Guarded by mutex
+        std::mutex              mutex;
+        std::condition_variable wake;
+        std::deque<unsigned>    requests;
+        std::vector<Completed>  completed;
+        Level::Desc             desc;
+        bool                    descReady;
+        bool                    openOk;
+        bool                    quit;
+        unsigned                chunksWide;
+
+        explicit Shared (ILevelChunkSource * source);
+        ~Shared ();
+    };
+
+private: // Data
+    std::shared_ptr<Shared>     m_shared;
+    LevelStreamSettings         m_settings;
+
+    // Main thread only
+    std::vector<unsigned char>  m_states;
+    std::vector<unsigned char>  m_readFailures; // Consecutive failed reads per chunk
+    std::vector<unsigned>       m_lastWanted;
+    std::vector<bool>           m_pinned;
+    std::vector<unsigned>       m_resident;
+    unsigned                    m_failedChunkCount;
+    unsigned                    m_frame;
+    EStreamStatus               m_status;
+
+private: // Helpers
+    static void ThreadMain (std::shared_ptr<Shared> shared);
+    void Evict (Level & level);
+
+public:
+    // Takes ownership of source.
+    LevelStreamer (ILevelChunkSource * source, const LevelStreamSettings & settings);
+    ~LevelStreamer ();
+
+    // Main thread.  Pump returns false once the stream has failed.
+    bool Pump (Level & level, const LevelChunkRange & focus);
+    void PinChunk (unsigned chunkIndex) { if (chunkIndex < m_pinned.size()) m_pinned[chunkIndex] = true; }
+    void RetryFailedChunks ();
+
+    // Queries
+    const LevelStreamSettings & GetSettings () const   { return m_settings; }
+    bool          IsChunkResident (unsigned chunkIndex) const { return chunkIndex < m_states.size() && m_states[chunkIndex] == CHUNK_STATE_RESIDENT; }
+    bool          IsChunkFailed (unsigned chunkIndex) const   { return chunkIndex < m_states.size() && m_states[chunkIndex] == CHUNK_STATE_FAILED; }
+    bool          IsReady () const                             { return m_status == STREAM_STATUS_READY; }
+    bool          HasFailed () const                           { return m_status == STREAM_STATUS_OPEN_FAILED || m_status == STREAM_STATUS_BUILD_FAILED; }
+    EStreamStatus GetStatus () const                           { return m_status; }
+    unsigned      GetFailedChunkCount () const                 { return m_failedChunkCount; }
+    unsigned      GetResidentChunkCount () const               { return unsigned(m_resident.size()); }
+    size_t        GetResidentBytes () const;
+};
@@ -0,0 +1,253 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Christopher Higgins Barrett
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "LevelTileBatch.hpp"
+#include "Level.hpp"
+
+#include "../TransformBatch.h"
+
+//==============================================================================
+LevelTileBatch::LevelTileBatch () :
+    m_chunksWide(0),
+    m_chunksHigh(0),
+    m_allDirtyStamp(0),
+    m_stamp(0),
+    m_hasLevelMtx(false),
+    m_lastRebuiltChunks(0),
+    m_levelNode(TransformHierarchy::s_invalidNode),
+    m_tileWidth(0.0f),
+    m_tileHeight(0.0f)
+{}
+
+//==============================================================================
+bool LevelTileBatch::NeedsRebuild (const Chunk & chunk) const {
+
+    if (chunk.dirty || chunk.bakeStamp < m_allDirtyStamp)
+        return true;
+
+    for (unsigned legendIndex : chunk.legends) {
+        if (legendIndex < m_legendStamps.size() && m_legendStamps[legendIndex] > chunk.bakeStamp)
+            return true;
+    }
+
+    return false;
+
+}
+
+//==============================================================================
+void LevelTileBatch::RebuildChunk (const Level & level, unsigned chunkX, unsigned chunkY) {
+
+    Chunk &       chunk         = m_chunks[chunkY * m_chunksWide + chunkX];
+    const Mtx44 & chunkWorldMtx = GetChunkWorldMtx(chunkX, chunkY);
+    if (chunk.instances.empty())
+        m_resident.push_back(chunkY * m_chunksWide + chunkX);
+
+    chunk.instances.clear();
+    chunk.legends.clear();
+
+    const unsigned beginX = chunkX * s_chunkTiles;
+    const unsigned beginY = chunkY * s_chunkTiles;
+    const unsigned endX   = MIN(beginX + s_chunkTiles, level.GetWidth());
+    const unsigned endY   = MIN(beginY + s_chunkTiles, level.GetHeight());
+
+    chunk.instances.reserve((endX - beginX) * (endY - beginY));
+    for (unsigned y = beginY; y < endY; ++y) {
+        for (unsigned x = beginX; x < endX; ++x) {
+            const unsigned            legendIndex = level.GetTileLegendIndex(x, y);
+            const Level::TileLegend & legend      = level.GetLegend(legendIndex);
+
+            TileInstance instance;
+            TranslateAffine2d((x - beginX) * m_tileWidth, (y - beginY) * m_tileHeight, chunkWorldMtx, &instance.worldFromModelMtx);
+            instance.frame       = legend.sprite.GetCurrentFrame();
+            instance.sheet       = legend.sprite.GetSheet();
+            instance.legendIndex = legendIndex;
+            chunk.instances.push_back(instance);
+
+            chunk.legends.push_back(legendIndex);
+        }
+    }
+
+    std::sort(chunk.legends.begin(), chunk.legends.end());
+    chunk.legends.erase(std::unique(chunk.legends.begin(), chunk.legends.end()), chunk.legends.end());
+
+    // Each bake takes a fresh stamp, so a chunk's stamp also tells whether
+    // it was rebaked since it was last looked at.
+    chunk.bakeStamp = ++m_stamp;
+    chunk.dirty     = false;
+
+}
+
+//==============================================================================
+void LevelTileBatch::UpdateHierarchy (const Transform & levelTransform, float tileWidth, float tileHeight) {
+
+    const Mtx44 & levelWorldFromModelMtx = levelTransform.GetWorldFromModelMtx();
+    if (!m_hasLevelMtx || memcmp(&m_levelWorldFromModelMtx, &levelWorldFromModelMtx, sizeof(Mtx44))) {
+        m_levelWorldFromModelMtx = levelWorldFromModelMtx;
+        m_hasLevelMtx            = true;
+        m_hierarchy.SetLocal(m_levelNode, levelTransform);
+    }
+
+    // Chunk offsets follow the tile size, which a reload may change.
+    if (tileWidth != m_tileWidth || tileHeight != m_tileHeight) {
+        m_tileWidth  = tileWidth;
+        m_tileHeight = tileHeight;
+        for (unsigned chunkY = 0; chunkY < m_chunksHigh; ++chunkY) {
+            for (unsigned chunkX = 0; chunkX < m_chunksWide; ++chunkX) {
+                m_hierarchy.SetLocalPosition(
+                    m_chunkNodes[chunkY * m_chunksWide + chunkX],
+                    float(chunkX * s_chunkTiles) * tileWidth,
+                    float(chunkY * s_chunkTiles) * tileHeight
+                );
+            }
+        }
+    }
+
+    // Still levels update nothing and skip the scan.
+    m_hierarchy.Update();
+    if (!m_hierarchy.GetLastUpdatedCount())
+        return;
+
+    for (unsigned chunkIndex = 0; chunkIndex < m_chunkNodes.size(); ++chunkIndex) {
+        if (m_hierarchy.WorldChanged(m_chunkNodes[chunkIndex]))
+            m_chunks[chunkIndex].dirty = true;
+    }
+
+}
+
+//==============================================================================
+void LevelTileBatch::Reset (unsigned chunksWide, unsigned chunksHigh) {
+
+    m_chunksWide = chunksWide;
+    m_chunksHigh = chunksHigh;
+
+    m_chunks.clear();
+    m_chunks.resize(m_chunksWide * m_chunksHigh);
+    m_resident.clear();
+    m_legendStamps.clear();
+
+    m_allDirtyStamp     = 0;
+    m_stamp             = 0;
+    m_hasLevelMtx       = false;
+    m_lastRebuiltChunks = 0;
+
+    m_hierarchy.Clear();
+    m_levelNode = m_hierarchy.CreateNode();
+    m_chunkNodes.resize(m_chunks.size());
+    for (TransformHierarchy::NodeId & node : m_chunkNodes)
+        node = m_hierarchy.CreateNode(m_levelNode);
+    m_tileWidth  = 0.0f;
+    m_tileHeight = 0.0f;
+
+}
+
+//==============================================================================
+void LevelTileBatch::MarkTileDirty (unsigned x, unsigned y) {
+
+    const unsigned chunkX = x / s_chunkTiles;
+    const unsigned chunkY = y / s_chunkTiles;
+    ASSERT(chunkX < m_chunksWide && chunkY < m_chunksHigh);
+
+    m_chunks[chunkY * m_chunksWide + chunkX].dirty = true;
+
+}
+
+//==============================================================================
+void LevelTileBatch::MarkChunkDirty (unsigned chunkX, unsigned chunkY) {
+
+    ASSERT(chunkX < m_chunksWide && chunkY < m_chunksHigh);
+    m_chunks[chunkY * m_chunksWide + chunkX].dirty = true;
+
+}
+
+//==============================================================================
+void LevelTileBatch::MarkLegendDirty (unsigned legendIndex) {
+
+    // Stamped rather than pushed to chunks, so the cost doesn't depend on
+    // level size; chunks compare stamps when they're next in view.
+    if (m_legendStamps.size() <= legendIndex)
+        m_legendStamps.resize(legendIndex + 1, 0);
+    m_legendStamps[legendIndex] = ++m_stamp;
+
+}
+
+//==============================================================================
+void LevelTileBatch::MarkAllDirty () {
+    m_allDirtyStamp = ++m_stamp;
+}
+
+//==============================================================================
+unsigned LevelTileBatch::Rebuild (
+    const Level &           level,
+    const Transform &       levelTransform,
+    const LevelChunkRange & range
+) {
+
+    m_lastRebuiltChunks = 0;
+
+    // Release chunks that left the range
+    for (unsigned i = 0; i < m_resident.size(); ) {
+        const unsigned chunkIndex = m_resident[i];
+        if (range.Contains(chunkIndex % m_chunksWide, chunkIndex / m_chunksWide)) {
+            ++i;
+            continue;
+        }
+
+        Chunk & chunk = m_chunks[chunkIndex];
+        std::vector<TileInstance>().swap(chunk.instances);
+        chunk.dirty = true;
+
+        m_resident[i] = m_resident.back();
+        m_resident.pop_back();
+    }
+
+    float tileWidth;
+    float tileHeight;
+    if (range.IsEmpty() || !level.GetTileSize(&tileWidth, &tileHeight))
+        return 0;
+
+    // Records hold world matrices, so chunks whose node moved are rebaked.
+    UpdateHierarchy(levelTransform, tileWidth, tileHeight);
+
+    ASSERT(range.endX <= m_chunksWide && range.endY <= m_chunksHigh);
+    for (unsigned chunkY = range.beginY; chunkY < range.endY; ++chunkY) {
+        for (unsigned chunkX = range.beginX; chunkX < range.endX; ++chunkX) {
+            if (!level.IsChunkResident(chunkX, chunkY) || !NeedsRebuild(m_chunks[chunkY * m_chunksWide + chunkX]))
+                continue;
+
+            RebuildChunk(level, chunkX, chunkY);
+            ++m_lastRebuiltChunks;
+        }
+    }
+
+    return m_lastRebuiltChunks;
+
+}
+
+//==============================================================================
+const Mtx44 & LevelTileBatch::GetChunkWorldMtx (unsigned chunkX, unsigned chunkY) const {
+
+    ASSERT(chunkX < m_chunksWide && chunkY < m_chunksHigh);
+    return m_hierarchy.GetWorldMtx(m_chunkNodes[chunkY * m_chunksWide + chunkX]);
+
+}
@@ -0,0 +1,122 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Christopher Higgins Barrett
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include "../TransformHierarchy.h"
+
+class Level;
+
+// Half-open rectangle of chunk coordinates.
+struct LevelChunkRange {
+    unsigned beginX;
+    unsigned beginY;
+    unsigned endX;
+    unsigned endY;
+
+    bool IsEmpty () const                             { return beginX >= endX || beginY >= endY; }
+    bool Contains (unsigned chunkX, unsigned chunkY) const {
+        return chunkX >= beginX && chunkX < endX && chunkY >= beginY && chunkY < endY;
+    }
+};
+
+//==============================================================================
+// CPU-side instance data for a level's tile layer, baked per chunk.
+//
+// Each chunk holds one record per tile: world matrix, frame (UV source),
+// spritesheet (texture) and legend.  Only chunks inside the requested range
+// are baked, and a chunk is rebaked only after a tile edit, after a legend it
+// uses advances to a new frame, or after its world matrix changes.  Chunks are
+// nodes in a TransformHierarchy under the level's node, and tiles are offsets
+// within their chunk, so a still level costs one matrix compare per Rebuild.
+// Chunks that leave the range drop their records, so memory follows the view
+// rather than the level; chunks a streaming level hasn't loaded are skipped.
+// Nothing here touches the graphics device, so baking can be driven and
+// checked headless.
+class LevelTileBatch {
+public: // Types and Constants
+    static const unsigned s_chunkTiles = 32; // Chunk edge length, in tiles
+
+    struct TileInstance {
+        Mtx44                    worldFromModelMtx;
+        const SpritesheetFrame * frame;
+        const Spritesheet *      sheet;
+        unsigned                 legendIndex;
+    };
+
+    struct Chunk {
+        std::vector<TileInstance> instances;
+        std::vector<unsigned>     legends;   // Sorted, unique legends used
+        unsigned                  bakeStamp; // m_stamp taken by the last bake
+        bool                      dirty;
+
+        Chunk () : bakeStamp(0), dirty(true) {}
+    };
+
+private: // Data
+    std::vector<Chunk>    m_chunks;
+    unsigned              m_chunksWide;
+    unsigned              m_chunksHigh;
+    std::vector<unsigned> m_resident;       // Chunks currently holding records
+    std::vector<unsigned> m_legendStamps;   // m_stamp when each legend last changed frame
+    unsigned              m_allDirtyStamp;  // m_stamp when MarkAllDirty was last called
+    unsigned              m_stamp;
+    Mtx44                 m_levelWorldFromModelMtx;
+    bool                  m_hasLevelMtx;
+    unsigned              m_lastRebuiltChunks;
+
+    // Level node with one child per chunk, placed for the tile size below
+    TransformHierarchy                      m_hierarchy;
+    TransformHierarchy::NodeId              m_levelNode;
+    std::vector<TransformHierarchy::NodeId> m_chunkNodes;
+    float                                   m_tileWidth;
+    float                                   m_tileHeight;
+
+private: // Helpers
+    bool NeedsRebuild (const Chunk & chunk) const;
+    void RebuildChunk (const Level & level, unsigned chunkX, unsigned chunkY);
+    void UpdateHierarchy (const Transform & levelTransform, float tileWidth, float tileHeight);
+
+public:
+    LevelTileBatch ();
+
+    // Commands
+    void Reset (unsigned chunksWide, unsigned chunksHigh);
+    void MarkTileDirty (unsigned x, unsigned y);
+    void MarkChunkDirty (unsigned chunkX, unsigned chunkY);
+    void MarkLegendDirty (unsigned legendIndex);
+    void MarkAllDirty ();
+
+    // Bakes any stale chunks in range and releases chunks outside it.
+    // Returns how many chunks were rebuilt.
+    unsigned Rebuild (const Level & level, const Transform & levelTransform, const LevelChunkRange & range);
+
+    // Queries
+    unsigned      GetChunksWide () const             { return m_chunksWide; }
+    unsigned      GetChunksHigh () const             { return m_chunksHigh; }
+    const Chunk & GetChunk (unsigned chunkX, unsigned chunkY) const { return m_chunks[chunkY * m_chunksWide + chunkX]; }
+    const Mtx44 & GetChunkWorldMtx (unsigned chunkX, unsigned chunkY) const;
+    unsigned      GetResidentChunkCount () const     { return unsigned(m_resident.size()); }
+    unsigned      GetLastRebuiltChunkCount () const  { return m_lastRebuiltChunks; }
+};
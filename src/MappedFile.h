@@ -0,0 +1,61 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Christopher Higgins Barrett
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+namespace Core {
+
+//==============================================================================
+// Read-only view of a whole file, mapped into memory.  Pages are faulted in
+// by the OS as they're touched, so opening is cheap regardless of file size.
+// Implemented per platform in MappedFile_Windows.cpp / MappedFile_Posix.cpp.
+class MappedFile {
+private: // Data
+    const void * m_data;
+    size_t       m_size;
+    void *       m_fileHandle;    // Windows only
+    void *       m_mappingHandle; // Windows only
+
+private: // Not copyable
+    MappedFile (const MappedFile &);
+    MappedFile & operator= (const MappedFile &);
+
+public:
+    MappedFile ();
+    ~MappedFile ();
+
+    bool Open (const char * filepath);
+    void Close ();
+
+    // Queries
+    bool         IsOpen () const    { return m_data != nullptr; }
+    const void * GetData () const   { return m_data; }
+    size_t       GetSize () const   { return m_size; }
+    bool         Contains (const void * ptr) const {
+        const char * bytes = static_cast<const char *>(m_data);
+        return ptr >= m_data && static_cast<const char *>(ptr) < bytes + m_size;
+    }
+};
+
+} // namespace Core
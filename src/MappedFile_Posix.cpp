@@ -0,0 +1,88 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Christopher Higgins Barrett
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+// POSIX implementation of MappedFile.h
+#ifndef _MSC_VER
+
+#include "MappedFile.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Core {
+
+//==============================================================================
+MappedFile::MappedFile () :
+    m_data(nullptr),
+    m_size(0),
+    m_fileHandle(nullptr),
+    m_mappingHandle(nullptr)
+{}
+
+//==============================================================================
+MappedFile::~MappedFile () {
+    Close();
+}
+
+//==============================================================================
+bool MappedFile::Open (const char * filepath) {
+
+    Close();
+
+    const int fd = open(filepath, O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    // The mapping outlives the descriptor, so it's closed straight away.
+    struct stat info;
+    void *      data = MAP_FAILED;
+    if (!fstat(fd, &info) && info.st_size > 0)
+        data = mmap(nullptr, size_t(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if (data == MAP_FAILED)
+        return false;
+
+    m_data = data;
+    m_size = size_t(info.st_size);
+    return true;
+
+}
+
+//==============================================================================
+void MappedFile::Close () {
+
+    if (m_data)
+        munmap(const_cast<void *>(m_data), m_size);
+
+    m_data = nullptr;
+    m_size = 0;
+
+}
+
+} // namespace Core
+
+#endif
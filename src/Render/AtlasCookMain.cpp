@@ -0,0 +1,179 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Christopher Higgins Barrett
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+// Offline atlas cook: packs the frames of several spritesheets onto shared
+// atlas pages and writes each sheet's datafile rewritten to point at its page.
+//
+//   usage: <exe> [-page size] [-padding texels] -out prefix datafile...
+//
+// For every input "dir/name.json" this writes "<prefix>-name.json", whose
+// imageFile is "<prefix name>-<page>.png" next to it, and "<prefix>.layout",
+// which lists every copy the pages need, one per line:
+//
+//     page dstX dstY width height sourceImage srcX srcY
+//
+// Decoding and encoding images belongs to the graphics side, so the page
+// images themselves are built from the layout by CompositeAtlasPage (or any
+// image tool).  Sheets are read through SpritesheetFile::LoadDesc, so this
+// build needs their cooked files.
+//
+// Built by CMakeLists.txt at the repository root, not the Windows project.
+
+#include "AtlasPacker.h"
+#include "SpritesheetDesc.h"
+#include "SpritesheetFile.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+//==============================================================================
+// "a/b/c.json" -> "a/b/"; "c.json" -> "".
+std::string GetDirectory (const std::string & path) {
+
+    const size_t slash = path.find_last_of("/\\");
+    return slash == std::string::npos ? std::string() : path.substr(0, slash + 1);
+
+}
+
+//==============================================================================
+bool WriteLayout (
+    const char *                                filepath,
+    const std::vector<std::string> &            sourceImages,
+    const std::vector<AtlasPacker::Frame> &     frames,
+    const std::vector<AtlasPacker::Placement> & placements
+) {
+
+    FILE * file = Core::OpenFile(filepath, "wt");
+    if (!file)
+        return false;
+
+    // Duplicate frames share a placement; one copy covers them all.
+    for (unsigned i = 0; i < frames.size(); ++i) {
+        const AtlasPacker::Frame &     frame     = frames[i];
+        const AtlasPacker::Placement & placement = placements[i];
+        if (placement.page == AtlasPacker::s_unplaced)
+            continue;
+
+        bool copied = false;
+        for (unsigned j = 0; j < i && !copied; ++j) {
+            copied =
+                placements[j].page == placement.page &&
+                placements[j].x    == placement.x    &&
+                placements[j].y    == placement.y;
+        }
+        if (copied)
+            continue;
+
+        fprintf(
+            file,
+            "%u %u %u %u %u %s %u %u\n",
+            placement.page,
+            placement.x,
+            placement.y,
+            frame.width,
+            frame.height,
+            sourceImages[frame.source].c_str(),
+            frame.x,
+            frame.y
+        );
+    }
+
+    const bool ok = !ferror(file);
+    fclose(file);
+    return ok;
+
+}
+
+} // namespace
+
+//==============================================================================
+int main (int argc, char ** argv) {
+
+    AtlasPacker::Settings settings;
+    settings.keepSourcesTogether = true;
+
+    const char *             outPrefix = nullptr;
+    std::vector<std::string> datafilePaths;
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "-out") && i + 1 < argc)
+            outPrefix = argv[++i];
+        else if (!strcmp(argv[i], "-page") && i + 1 < argc)
+            settings.pageWidth = settings.pageHeight = unsigned(strtoul(argv[++i], nullptr, 10));
+        else if (!strcmp(argv[i], "-padding") && i + 1 < argc)
+            settings.padding = unsigned(strtoul(argv[++i], nullptr, 10));
+        else
+            datafilePaths.push_back(argv[i]);
+    }
+
+    if (!outPrefix || datafilePaths.empty() || !settings.pageWidth) {
+        fprintf(stderr, "usage: %s [-page size] [-padding texels] -out prefix datafile...\n", argv[0]);
+        return 1;
+    }
+
+    std::vector<SpritesheetDesc> descs(datafilePaths.size());
+    std::vector<std::string>     sourceImages;
+    for (unsigned d = 0; d < descs.size(); ++d) {
+        if (!SpritesheetFile::LoadDesc(datafilePaths[d].c_str(), &descs[d])) {
+            fprintf(stderr, "Can't load spritesheet %s\n", datafilePaths[d].c_str());
+            return 1;
+        }
+        sourceImages.push_back(GetDirectory(datafilePaths[d]) + descs[d].imageFile);
+    }
+
+    const std::string                   outDirectory = GetDirectory(outPrefix);
+    const std::string                   pagePrefix   = std::string(outPrefix).substr(outDirectory.size());
+    AtlasPacker                         packer(settings);
+    std::vector<AtlasPacker::Frame>     frames;
+    std::vector<AtlasPacker::Placement> placements;
+    const unsigned pageCount = PackSpritesheetDescs(&packer, descs.data(), unsigned(descs.size()), pagePrefix, &frames, &placements);
+    if (!pageCount) {
+        fprintf(stderr, "Some sheet doesn't fit on a %ux%u page\n", settings.pageWidth, settings.pageHeight);
+        return 1;
+    }
+
+    for (unsigned d = 0; d < descs.size(); ++d) {
+        const std::string & inPath  = datafilePaths[d];
+        const std::string   outPath = std::string(outPrefix) + "-" + inPath.substr(GetDirectory(inPath).size());
+        if (!WriteSpritesheetDatafile(outPath.c_str(), descs[d])) {
+            fprintf(stderr, "Can't write %s\n", outPath.c_str());
+            return 1;
+        }
+    }
+
+    const std::string layoutPath = std::string(outPrefix) + ".layout";
+    if (!WriteLayout(layoutPath.c_str(), sourceImages, frames, placements)) {
+        fprintf(stderr, "Can't write %s\n", layoutPath.c_str());
+        return 1;
+    }
+
+    printf("sheets %u  frames %u  pages %u\n", unsigned(descs.size()), unsigned(frames.size()), pageCount);
+    for (unsigned page = 0; page < pageCount; ++page)
+        printf("  page %u  %.1f%% used\n", page, packer.GetPageOccupancy(page) * 100.0f);
+
+    return 0;
+
+}
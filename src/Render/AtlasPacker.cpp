@@ -0,0 +1,359 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Christopher Higgins Barrett
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "AtlasPacker.h"
+
+#include <algorithm>
+
+//==============================================================================
+AtlasPacker::AtlasPacker (const Settings & settings) :
+    m_settings(settings)
+{
+    ASSERT(settings.pageWidth && settings.pageHeight);
+}
+
+//==============================================================================
+void AtlasPacker::AddPage () {
+
+    m_pages.push_back(Page());
+    Page & page = m_pages.back();
+
+    const SkylineNode root = { 0, 0, m_settings.pageWidth };
+    page.skyline.push_back(root);
+    page.usedArea = 0;
+
+}
+
+//==============================================================================
+// The lowest spot whose bottom-left sits on a skyline node.  Score is the
+// resulting top edge; lower is better.
+bool AtlasPacker::FindPosition (
+    const Page & page,
+    unsigned     width,
+    unsigned     height,
+    unsigned *   nodeOut,
+    unsigned *   xOut,
+    unsigned *   yOut,
+    unsigned *   scoreOut
+) const {
+
+    const std::vector<SkylineNode> & skyline   = page.skyline;
+    const unsigned                   nodeCount = unsigned(skyline.size());
+
+    bool     found     = false;
+    unsigned bestTop   = unsigned(-1);
+    unsigned bestWidth = unsigned(-1);
+
+    for (unsigned i = 0; i < nodeCount; ++i) {
+        const unsigned x = skyline[i].x;
+        if (x + width > m_settings.pageWidth)
+            break;
+
+        // Rest on the highest segment under the span.
+        unsigned y         = 0;
+        unsigned remaining = width;
+        for (unsigned j = i; remaining; ++j) {
+            ASSERT(j < nodeCount);
+            y = MAX(y, skyline[j].y);
+            if (y + height > m_settings.pageHeight)
+                break;
+            remaining -= MIN(remaining, skyline[j].width);
+        }
+        if (remaining || y + height > m_settings.pageHeight)
+            continue;
+
+        const unsigned top = y + height;
+        if (top < bestTop || (top == bestTop && skyline[i].width < bestWidth)) {
+            found     = true;
+            bestTop   = top;
+            bestWidth = skyline[i].width;
+            *nodeOut  = i;
+            *xOut     = x;
+            *yOut     = y;
+        }
+    }
+
+    *scoreOut = bestTop;
+    return found;
+
+}
+
+//==============================================================================
+void AtlasPacker::Place (Page * page, unsigned node, unsigned x, unsigned y, unsigned width, unsigned height) {
+
+    std::vector<SkylineNode> & skyline = page->skyline;
+
+    const SkylineNode placed = { x, y + height, width };
+    skyline.insert(skyline.begin() + node, placed);
+
+    // Trim or drop the segments the new one now covers.
+    const unsigned right = x + width;
+    for (unsigned i = node + 1; i < skyline.size(); ) {
+        SkylineNode & next = skyline[i];
+        if (next.x >= right)
+            break;
+
+        const unsigned nextRight = next.x + next.width;
+        if (nextRight <= right) {
+            skyline.erase(skyline.begin() + i);
+            continue;
+        }
+
+        next.width = nextRight - right;
+        next.x     = right;
+        break;
+    }
+
+    // Merge neighbours left at the same height.
+    for (unsigned i = 0; i + 1 < skyline.size(); ) {
+        if (skyline[i].y == skyline[i + 1].y) {
+            skyline[i].width += skyline[i + 1].width;
+            skyline.erase(skyline.begin() + i + 1);
+        }
+        else
+            ++i;
+    }
+
+    page->usedArea += width * height;
+
+}
+
+//==============================================================================
+bool AtlasPacker::PlaceOnPage (Page * page, const Frame & frame, Placement * placementOut) {
+
+    const unsigned width  = frame.width + m_settings.padding;
+    const unsigned height = frame.height + m_settings.padding;
+
+    unsigned node, x, y, score;
+    if (!FindPosition(*page, width, height, &node, &x, &y, &score))
+        return false;
+
+    Place(page, node, x, y, width, height);
+    placementOut->page = unsigned(page - m_pages.data());
+    placementOut->x    = x;
+    placementOut->y    = y;
+    return true;
+
+}
+
+//==============================================================================
+// Best spot across the open pages, then a fresh page if none fits.
+bool AtlasPacker::PlaceOnAnyPage (const Frame & frame, Placement * placementOut) {
+
+    const unsigned width  = frame.width + m_settings.padding;
+    const unsigned height = frame.height + m_settings.padding;
+
+    unsigned bestPage  = s_unplaced;
+    unsigned bestScore = unsigned(-1);
+    unsigned bestNode  = 0;
+    unsigned bestX     = 0;
+    unsigned bestY     = 0;
+    for (unsigned page = 0, pageCount = unsigned(m_pages.size()); page < pageCount; ++page) {
+        unsigned node, x, y, score;
+        if (FindPosition(m_pages[page], width, height, &node, &x, &y, &score) && score < bestScore) {
+            bestPage  = page;
+            bestScore = score;
+            bestNode  = node;
+            bestX     = x;
+            bestY     = y;
+        }
+    }
+
+    if (bestPage == s_unplaced) {
+        if (m_settings.maxPages && m_pages.size() >= m_settings.maxPages)
+            return false;
+        AddPage();
+        return PlaceOnPage(&m_pages.back(), frame, placementOut);
+    }
+
+    Place(&m_pages[bestPage], bestNode, bestX, bestY, width, height);
+    placementOut->page = bestPage;
+    placementOut->x    = bestX;
+    placementOut->y    = bestY;
+    return true;
+
+}
+
+//==============================================================================
+// Places one source's frames (already in packing order) on the first page
+// that takes all of them, trying each page on a copy so a miss leaves it
+// untouched.
+bool AtlasPacker::PlaceGroup (const Frame * frames, const unsigned * order, unsigned count, Placement * placementsOut) {
+
+    for (unsigned attempt = 0; ; ++attempt) {
+        if (attempt == m_pages.size()) {
+            if (m_settings.maxPages && m_pages.size() >= m_settings.maxPages)
+                return false;
+            AddPage();
+        }
+
+        const Page saved  = m_pages[attempt];
+        bool       placed = true;
+        for (unsigned i = 0; i < count && placed; ++i)
+            placed = PlaceOnPage(&m_pages[attempt], frames[order[i]], &placementsOut[order[i]]);
+
+        if (placed)
+            return true;
+
+        m_pages[attempt] = saved;
+
+        // Not even an empty page holds it.
+        if (attempt + 1 == m_pages.size() && saved.usedArea == 0) {
+            m_pages.pop_back();
+            return false;
+        }
+    }
+
+}
+
+//==============================================================================
+unsigned AtlasPacker::Pack (const Frame * frames, unsigned count, Placement * placementsOut) {
+
+    m_pages.clear();
+
+    const bool together = m_settings.keepSourcesTogether;
+
+    // Tallest first packs a skyline tightest; identical rects end up adjacent
+    // so only the first of each run is placed.  Grouped sources are ordered
+    // by total area, largest first.
+    std::vector<std::uint64_t> sourceArea;
+    if (together) {
+        for (unsigned i = 0; i < count; ++i) {
+            if (frames[i].source >= sourceArea.size())
+                sourceArea.resize(frames[i].source + 1, 0);
+            sourceArea[frames[i].source] += std::uint64_t(frames[i].width) * frames[i].height;
+        }
+    }
+
+    m_order.resize(count);
+    for (unsigned i = 0; i < count; ++i)
+        m_order[i] = i;
+    std::sort(m_order.begin(), m_order.end(), [frames, together, &sourceArea] (unsigned a, unsigned b) {
+        const Frame & fa = frames[a];
+        const Frame & fb = frames[b];
+        if (together && fa.source != fb.source) {
+            if (sourceArea[fa.source] != sourceArea[fb.source])
+                return sourceArea[fa.source] > sourceArea[fb.source];
+            return fa.source < fb.source;
+        }
+        if (fa.height != fb.height) return fa.height > fb.height;
+        if (fa.width != fb.width)   return fa.width > fb.width;
+        if (fa.source != fb.source) return fa.source < fb.source;
+        if (fa.x != fb.x)           return fa.x < fb.x;
+        if (fa.y != fb.y)           return fa.y < fb.y;
+        return a < b;
+    });
+
+    // Drop duplicates and frames no page could hold from the placing order;
+    // they're resolved once everything else is placed.
+    m_unique.clear();
+    for (unsigned i = 0; i < count; ++i) {
+        const unsigned index = m_order[i];
+        const Frame &  frame = frames[index];
+        Placement &    out   = placementsOut[index];
+        out.page = s_unplaced;
+        out.x    = 0;
+        out.y    = 0;
+
+        if (i) {
+            const Frame & prev = frames[m_order[i - 1]];
+            if (prev.source == frame.source && prev.x == frame.x && prev.y == frame.y && prev.width == frame.width && prev.height == frame.height)
+                continue;
+        }
+
+        if (!frame.width || !frame.height || frame.width + m_settings.padding > m_settings.pageWidth || frame.height + m_settings.padding > m_settings.pageHeight)
+            continue;
+
+        m_unique.push_back(index);
+    }
+
+    if (together) {
+        for (unsigned begin = 0, uniqueCount = unsigned(m_unique.size()); begin < uniqueCount; ) {
+            unsigned end = begin + 1;
+            while (end < uniqueCount && frames[m_unique[end]].source == frames[m_unique[begin]].source)
+                ++end;
+
+            if (!PlaceGroup(frames, &m_unique[begin], end - begin, placementsOut)) {
+                for (unsigned i = begin; i < end; ++i)
+                    placementsOut[m_unique[i]].page = s_unplaced;
+            }
+            begin = end;
+        }
+    }
+    else {
+        for (unsigned index : m_unique)
+            PlaceOnAnyPage(frames[index], &placementsOut[index]);
+    }
+
+    // Duplicates follow the frame placed for their run.
+    for (unsigned i = 1; i < count; ++i) {
+        const unsigned index = m_order[i];
+        const unsigned prev  = m_order[i - 1];
+        const Frame &  a     = frames[index];
+        const Frame &  b     = frames[prev];
+        if (a.source == b.source && a.x == b.x && a.y == b.y && a.width == b.width && a.height == b.height)
+            placementsOut[index] = placementsOut[prev];
+    }
+
+    return unsigned(m_pages.size());
+
+}
+
+//==============================================================================
+float AtlasPacker::GetPageOccupancy (unsigned page) const {
+
+    return float(double(m_pages[page].usedArea) / (double(m_settings.pageWidth) * double(m_settings.pageHeight)));
+
+}
+
+//==============================================================================
+void CompositeAtlasPage (
+    unsigned                       page,
+    const AtlasPacker::Frame *     frames,
+    const AtlasPacker::Placement * placements,
+    unsigned                       count,
+    const AtlasImage *             sources,
+    AtlasImage *                   pageImage
+) {
+
+    for (unsigned i = 0; i < count; ++i) {
+        const AtlasPacker::Placement & placement = placements[i];
+        if (placement.page != page)
+            continue;
+
+        const AtlasPacker::Frame & frame  = frames[i];
+        const AtlasImage &         source = sources[frame.source];
+        ASSERT(frame.x + frame.width <= source.width && frame.y + frame.height <= source.height);
+        ASSERT(placement.x + frame.width <= pageImage->width && placement.y + frame.height <= pageImage->height);
+
+        for (unsigned row = 0; row < frame.height; ++row) {
+            memcpy(
+                pageImage->texels + (placement.y + row) * pageImage->pitchTexels + placement.x,
+                source.texels + (frame.y + row) * source.pitchTexels + frame.x,
+                frame.width * sizeof(std::uint32_t)
+            );
+        }
+    }
+
+}
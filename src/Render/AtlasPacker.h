@@ -0,0 +1,137 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Christopher Higgins Barrett
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+//==============================================================================
+// Packs sprite frames from many sheets onto a few shared atlas pages, so a
+// scene's sprites can draw with a handful of texture binds.
+//
+// Placement uses a skyline: each page tracks the top edge of what's been
+// placed as a list of horizontal segments, and each frame goes where its top
+// ends lowest (ties to the tightest segment).  Frames are placed tallest
+// first.  Identical rects from the same source share one placement, which
+// covers the repeated frames sheets use for holds and ping-pong animations.
+// Cost is roughly frames x skyline segments, fast enough for load time.
+//
+// With keepSourcesTogether, all frames from one source land on the same page
+// (sources are placed largest first, each on the first page it fits whole),
+// so a spritesheet can be pointed at a single atlas page.
+//
+// Packing only decides where frames go.  CompositeAtlasPage copies the
+// pixels given decoded RGBA images; decoding and uploading belong to the
+// graphics side.
+class AtlasPacker {
+public: // Types and Constants
+    static const unsigned s_unplaced = unsigned(-1);
+
+    struct Frame {
+        unsigned source; // Which image the rect is in; any id the caller likes
+        unsigned x;
+        unsigned y;
+        unsigned width;
+        unsigned height;
+    };
+
+    struct Placement {
+        unsigned page; // s_unplaced if the frame can't fit on an empty page
+        unsigned x;
+        unsigned y;
+    };
+
+    struct Settings {
+        unsigned pageWidth;
+        unsigned pageHeight;
+        unsigned padding;  // Empty texels kept right of and below each frame
+        unsigned maxPages; // 0 for no limit
+        bool     keepSourcesTogether;
+
+        Settings () :
+            pageWidth(2048),
+            pageHeight(2048),
+            padding(1),
+            maxPages(0),
+            keepSourcesTogether(false)
+        {}
+    };
+
+private: // Types
+    struct SkylineNode {
+        unsigned x;
+        unsigned y;
+        unsigned width;
+    };
+
+    struct Page {
+        std::vector<SkylineNode> skyline;
+        unsigned                 usedArea;
+    };
+
+private: // Data
+    Settings              m_settings;
+    std::vector<Page>     m_pages;
+    std::vector<unsigned> m_order;
+    std::vector<unsigned> m_unique;
+
+private: // Helpers
+    bool FindPosition (const Page & page, unsigned width, unsigned height, unsigned * nodeOut, unsigned * xOut, unsigned * yOut, unsigned * scoreOut) const;
+    void Place (Page * page, unsigned node, unsigned x, unsigned y, unsigned width, unsigned height);
+    bool PlaceOnPage (Page * page, const Frame & frame, Placement * placementOut);
+    bool PlaceOnAnyPage (const Frame & frame, Placement * placementOut);
+    bool PlaceGroup (const Frame * frames, const unsigned * order, unsigned count, Placement * placementsOut);
+    void AddPage ();
+
+public:
+    explicit AtlasPacker (const Settings & settings = Settings());
+
+    // Places every frame; placementsOut runs parallel to frames.  Returns the
+    // number of pages used.  Each call starts from empty pages.
+    unsigned Pack (const Frame * frames, unsigned count, Placement * placementsOut);
+
+    // Queries
+    const Settings & GetSettings () const          { return m_settings; }
+    unsigned         GetPageCount () const         { return unsigned(m_pages.size()); }
+    float            GetPageOccupancy (unsigned page) const;
+};
+
+
+//==============================================================================
+// A decoded image: 32-bit texels, rows pitchTexels apart.
+struct AtlasImage {
+    std::uint32_t * texels;
+    unsigned        width;
+    unsigned        height;
+    unsigned        pitchTexels;
+};
+
+// Copies each frame placed on page from its source image (sources is indexed
+// by Frame::source).  The page should start cleared; padding is left alone.
+void CompositeAtlasPage (
+    unsigned                       page,
+    const AtlasPacker::Frame *     frames,
+    const AtlasPacker::Placement * placements,
+    unsigned                       count,
+    const AtlasImage *             sources,
+    AtlasImage *                   pageImage
+);
@@ -0,0 +1,78 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Christopher Higgins Barrett
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "RenderBackend.h"
+
+//==============================================================================
+CountingRenderBackend::CountingRenderBackend () :
+    m_boundSheet(nullptr)
+{}
+
+//==============================================================================
+void CountingRenderBackend::Reset () {
+
+    m_total.Clear();
+    m_lastFrame.Clear();
+    m_frame.Clear();
+    m_boundSheet = nullptr;
+
+}
+
+//==============================================================================
+void CountingRenderBackend::BeginFrame () {
+
+    m_frame.Clear();
+    m_frame.frames = 1;
+    m_boundSheet   = nullptr;
+
+}
+
+//==============================================================================
+void CountingRenderBackend::EndFrame () {
+
+    m_lastFrame = m_frame;
+
+    m_total.frames      += m_frame.frames;
+    m_total.batches     += m_frame.batches;
+    m_total.instances   += m_frame.instances;
+    m_total.sheetBinds  += m_frame.sheetBinds;
+    m_total.uploadBytes += m_frame.uploadBytes;
+
+}
+
+//==============================================================================
+void CountingRenderBackend::DrawBatch (const SpriteBatch & batch, const SpriteInstance * instances, SpriteAnimation * const * sources) {
+
+    ref(instances);
+    ref(sources);
+
+    ++m_frame.batches;
+    m_frame.instances   += batch.instanceCount;
+    m_frame.uploadBytes += std::uint64_t(batch.instanceCount) * sizeof(SpriteInstance);
+    if (batch.sheet != m_boundSheet) {
+        ++m_frame.sheetBinds;
+        m_boundSheet = batch.sheet;
+    }
+
+}
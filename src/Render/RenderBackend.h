@@ -0,0 +1,97 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Christopher Higgins Barrett
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include "SpriteBatcher.h"
+
+//==============================================================================
+// Executes a frame's sorted sprite batches.  Submit the batcher between
+// BeginFrame and EndFrame.
+class IRenderBackend : public ISpriteBatchSink {
+public:
+    virtual void BeginFrame () = 0;
+    virtual void EndFrame () = 0;
+};
+
+
+//==============================================================================
+// Draws nothing.  Render-prep cost measured against it is everything but the
+// graphics API.
+class NullRenderBackend final : public IRenderBackend {
+public:
+    void BeginFrame () override {}
+    void EndFrame () override   {}
+    void DrawBatch (const SpriteBatch & batch, const SpriteInstance * instances, SpriteAnimation * const * sources) override {
+        ref(batch);
+        ref(instances);
+        ref(sources);
+    }
+};
+
+
+//==============================================================================
+struct RenderStats {
+    unsigned      frames;
+    unsigned      batches;
+    unsigned      instances;
+    unsigned      sheetBinds;  // Batches whose sheet differs from the one before
+    std::uint64_t uploadBytes; // Instance data an instanced backend would upload
+
+    RenderStats () { Clear(); }
+
+    void Clear () {
+        frames      = 0;
+        batches     = 0;
+        instances   = 0;
+        sheetBinds  = 0;
+        uploadBytes = 0;
+    }
+};
+
+//==============================================================================
+// Tallies what a GPU backend would have been asked to do, for headless
+// profiling and for checking batching in CI.
+class CountingRenderBackend final : public IRenderBackend {
+private: // Data
+    RenderStats         m_total;
+    RenderStats         m_lastFrame;
+    RenderStats         m_frame;
+    const Spritesheet * m_boundSheet;
+
+public:
+    CountingRenderBackend ();
+
+    void Reset ();
+
+    // Queries
+    const RenderStats & GetTotals () const    { return m_total; }
+    const RenderStats & GetLastFrame () const { return m_lastFrame; }
+
+public: // IRenderBackend
+    void BeginFrame () override;
+    void EndFrame () override;
+    void DrawBatch (const SpriteBatch & batch, const SpriteInstance * instances, SpriteAnimation * const * sources) override;
+};
+
@@ -0,0 +1,267 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Christopher Higgins Barrett
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "RenderSnapshot.h"
+
+#include <algorithm>
+
+namespace {
+
+//==============================================================================
+float Lerp (float a, float b, float t) {
+    return a + (b - a) * t;
+}
+
+//==============================================================================
+bool SameHandedness (const SpriteInstance & a, const SpriteInstance & b) {
+
+    const float detA = a.axisX[0] * a.axisY[1] - a.axisX[1] * a.axisY[0];
+    const float detB = b.axisX[0] * b.axisY[1] - b.axisX[1] * b.axisY[0];
+    return (detA < 0.0f) == (detB < 0.0f);
+
+}
+
+} // namespace
+
+//==============================================================================
+RenderSnapshot::RenderSnapshot () :
+    m_hasCamera(false),
+    m_tick(0),
+    m_publishCount(0)
+{}
+
+//==============================================================================
+void RenderSnapshot::Capture (SpriteBatcher & batcher, const Vec3 * cameraPosition, unsigned tick) {
+
+    batcher.Finish();
+
+    m_instances = batcher.GetPackedInstances();
+    m_batches   = batcher.GetBatches();
+    m_tick      = tick;
+    m_hasCamera = cameraPosition != nullptr;
+    if (cameraPosition)
+        m_cameraPosition = *cameraPosition;
+
+    const std::vector<SpriteAnimation *> & sources = batcher.GetPackedSources();
+    const unsigned                         count   = unsigned(sources.size());
+
+    m_sprites.resize(count);
+    m_identities.clear();
+    for (unsigned i = 0; i < count; ++i) {
+        const SpriteAnimation * source = sources[i];
+        RenderSnapshotSprite &  sprite = m_sprites[i];
+        sprite.identity = source;
+        if (source) {
+            sprite.sheet      = source->GetSheet();
+            sprite.animIndex  = source->GetAnimationIndex();
+            sprite.frameIndex = source->GetFrameIndex();
+
+            const Identity identity = { source, i };
+            m_identities.push_back(identity);
+        }
+        else {
+            sprite.sheet      = nullptr;
+            sprite.animIndex  = 0;
+            sprite.frameIndex = 0;
+        }
+    }
+
+    // Keep only sources drawn once; shared ones can't be matched up.
+    std::sort(
+        m_identities.begin(),
+        m_identities.end(),
+        [] (const Identity & a, const Identity & b) { return a.identity < b.identity; }
+    );
+
+    unsigned kept = 0;
+    for (unsigned i = 0, identityCount = unsigned(m_identities.size()); i < identityCount; ) {
+        unsigned end = i + 1;
+        while (end < identityCount && m_identities[end].identity == m_identities[i].identity)
+            ++end;
+        if (end == i + 1)
+            m_identities[kept++] = m_identities[i];
+        i = end;
+    }
+    m_identities.resize(kept);
+
+}
+
+//==============================================================================
+void RenderSnapshot::Swap (RenderSnapshot & other) {
+
+    m_instances.swap(other.m_instances);
+    m_sprites.swap(other.m_sprites);
+    m_batches.swap(other.m_batches);
+    m_identities.swap(other.m_identities);
+    std::swap(m_cameraPosition, other.m_cameraPosition);
+    std::swap(m_hasCamera, other.m_hasCamera);
+    std::swap(m_tick, other.m_tick);
+    std::swap(m_publishCount, other.m_publishCount);
+
+}
+
+//==============================================================================
+bool RenderSnapshot::FindIdentity (const void * identity, unsigned * indexOut) const {
+
+    const Identity key = { identity, 0 };
+    std::vector<Identity>::const_iterator it = std::lower_bound(
+        m_identities.begin(),
+        m_identities.end(),
+        key,
+        [] (const Identity & a, const Identity & b) { return a.identity < b.identity; }
+    );
+
+    if (it == m_identities.end() || it->identity != identity)
+        return false;
+
+    *indexOut = it->index;
+    return true;
+
+}
+
+//==============================================================================
+RenderSnapshotExchange::RenderSnapshotExchange () :
+    m_writeIndex(0),
+    m_readIndex(1),
+    m_ready(2),
+    m_hasCurrent(false),
+    m_hasPrevious(false)
+{}
+
+//==============================================================================
+void RenderSnapshotExchange::Publish () {
+
+    m_slots[m_writeIndex].m_publishCount = Core::GetPerformanceCounter();
+    m_writeIndex = m_ready.exchange(m_writeIndex | s_freshBit) & s_indexMask;
+
+}
+
+//==============================================================================
+bool RenderSnapshotExchange::Acquire () {
+
+    if (!(m_ready.load() & s_freshBit))
+        return false;
+
+    // The slot going back to the writer carries the old previous snapshot;
+    // the writer overwrites it, reusing its buffers.
+    if (m_hasCurrent) {
+        m_previous.Swap(m_slots[m_readIndex]);
+        m_hasPrevious = true;
+    }
+
+    m_readIndex  = m_ready.exchange(m_readIndex) & s_indexMask;
+    m_hasCurrent = true;
+    return true;
+
+}
+
+//==============================================================================
+SnapshotRenderer::SnapshotRenderer () :
+    m_proxyCapacity(0),
+    m_current(nullptr),
+    m_cameraPosition(0.0f, 0.0f, 0.0f)
+{}
+
+//==============================================================================
+float SnapshotRenderer::ComputeAlpha (const RenderSnapshot * previous, const RenderSnapshot & current, std::uint64_t nowCount) {
+
+    if (!previous || current.GetPublishCount() <= previous->GetPublishCount() || nowCount <= current.GetPublishCount())
+        return previous ? 0.0f : 1.0f;
+
+    const double interval = double(current.GetPublishCount() - previous->GetPublishCount());
+    const double elapsed  = double(nowCount - current.GetPublishCount());
+    return float(MIN(elapsed / interval, 1.0));
+
+}
+
+//==============================================================================
+void SnapshotRenderer::Prepare (const RenderSnapshot * previous, const RenderSnapshot & current, float alpha) {
+
+    m_current = &current;
+
+    const std::vector<SpriteInstance> &       instances = current.GetInstances();
+    const std::vector<RenderSnapshotSprite> & sprites   = current.GetSprites();
+    const unsigned                            count     = unsigned(instances.size());
+
+    if (m_proxyCapacity < count) {
+        m_proxyCapacity = MAX(count, m_proxyCapacity * 2);
+        m_proxies.reset(new SpriteAnimation[m_proxyCapacity]);
+    }
+
+    m_instances.resize(count);
+    m_sources.resize(count);
+    for (unsigned i = 0; i < count; ++i) {
+        SpriteInstance &             instance = m_instances[i];
+        const RenderSnapshotSprite & sprite   = sprites[i];
+        instance = instances[i];
+
+        unsigned prevIndex;
+        if (previous && sprite.identity && previous->FindIdentity(sprite.identity, &prevIndex)) {
+            const SpriteInstance & from = previous->GetInstances()[prevIndex];
+            instance.origin[0] = Lerp(from.origin[0], instance.origin[0], alpha);
+            instance.origin[1] = Lerp(from.origin[1], instance.origin[1], alpha);
+
+            // A new frame size or a flip would morph through in-between
+            // shapes; those snap instead.
+            if (from.texRect[2] == instance.texRect[2] && from.texRect[3] == instance.texRect[3] && SameHandedness(from, instance)) {
+                for (unsigned axis = 0; axis < 2; ++axis) {
+                    instance.axisX[axis] = Lerp(from.axisX[axis], instance.axisX[axis], alpha);
+                    instance.axisY[axis] = Lerp(from.axisY[axis], instance.axisY[axis], alpha);
+                }
+            }
+        }
+
+        if (sprite.sheet) {
+            SpriteAnimation & proxy = m_proxies[i];
+            proxy.SetSheet(sprite.sheet);
+            proxy.SetAnimIndex(sprite.animIndex);
+            proxy.SetFrameIndex(sprite.frameIndex);
+            m_sources[i] = &proxy;
+        }
+        else
+            m_sources[i] = nullptr;
+    }
+
+    m_cameraPosition = current.GetCameraPosition();
+    if (previous && previous->HasCamera() && current.HasCamera()) {
+        const Vec3 & from = previous->GetCameraPosition();
+        m_cameraPosition.x = Lerp(from.x, m_cameraPosition.x, alpha);
+        m_cameraPosition.y = Lerp(from.y, m_cameraPosition.y, alpha);
+        m_cameraPosition.z = Lerp(from.z, m_cameraPosition.z, alpha);
+    }
+
+}
+
+//==============================================================================
+void SnapshotRenderer::Submit (IRenderBackend * backend) {
+
+    ASSERT(backend);
+    ASSERT(m_current && "Prepare a snapshot before submitting it.");
+
+    backend->BeginFrame();
+    for (const SpriteBatch & batch : m_current->GetBatches())
+        backend->DrawBatch(batch, &m_instances[batch.firstInstance], &m_sources[batch.firstInstance]);
+    backend->EndFrame();
+
+}
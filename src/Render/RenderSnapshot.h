@@ -0,0 +1,153 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Christopher Higgins Barrett
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include "RenderBackend.h"
+
+#include <atomic>
+#include <memory>
+
+//==============================================================================
+// What a sprite was showing when the snapshot was taken.  The source sprite
+// belongs to the simulation, so the render side only compares its address.
+struct RenderSnapshotSprite {
+    Spritesheet * sheet;      // Null if the instance had no source sprite
+    const void *  identity;   // Source sprite; matches sprites across snapshots
+    unsigned      animIndex;
+    unsigned      frameIndex;
+};
+
+//==============================================================================
+// An immutable picture of one simulation tick: the sorted, batched sprites
+// from a SpriteBatcher plus the camera.  Drawing one touches nothing the
+// simulation owns except the spritesheets, which are only read.
+class RenderSnapshot {
+private: // Types
+    struct Identity {
+        const void * identity;
+        unsigned     index;
+    };
+
+private: // Data
+    std::vector<SpriteInstance>       m_instances;  // Packed order
+    std::vector<RenderSnapshotSprite> m_sprites;    // Parallel to m_instances
+    std::vector<SpriteBatch>          m_batches;
+    std::vector<Identity>             m_identities; // Sorted; sources used once only
+    Vec3                              m_cameraPosition;
+    bool                              m_hasCamera;
+    unsigned                          m_tick;
+    std::uint64_t                     m_publishCount; // Performance counter at publish
+
+    friend class RenderSnapshotExchange;
+
+public:
+    RenderSnapshot ();
+
+    // Finishes the batcher and copies its output.  cameraPosition may be null.
+    void Capture (SpriteBatcher & batcher, const Vec3 * cameraPosition, unsigned tick);
+    void Swap (RenderSnapshot & other);
+
+    // Queries
+    bool FindIdentity (const void * identity, unsigned * indexOut) const;
+
+    const std::vector<SpriteInstance> &       GetInstances () const      { return m_instances; }
+    const std::vector<RenderSnapshotSprite> & GetSprites () const        { return m_sprites; }
+    const std::vector<SpriteBatch> &          GetBatches () const        { return m_batches; }
+    bool                                      HasCamera () const         { return m_hasCamera; }
+    const Vec3 &                              GetCameraPosition () const { return m_cameraPosition; }
+    unsigned                                  GetTick () const           { return m_tick; }
+    std::uint64_t                             GetPublishCount () const   { return m_publishCount; }
+};
+
+
+//==============================================================================
+// Hands snapshots from the simulation thread to the render thread without
+// either waiting on the other.  Three slots rotate: one being written, one
+// being read, one holding the newest published.  Publishing faster than the
+// reader reads just replaces the newest; the reader always gets the latest.
+//
+// The reader also keeps the snapshot before its current one, swapped out of
+// the slot it gives back, so it can interpolate without copying.
+class RenderSnapshotExchange {
+private: // Constants
+    static const unsigned s_indexMask = 3;
+    static const unsigned s_freshBit  = 4; // Set on m_ready when the reader hasn't seen it
+
+private: // Data
+    RenderSnapshot        m_slots[3];
+    RenderSnapshot        m_previous;
+    unsigned              m_writeIndex; // Simulation thread only
+    unsigned              m_readIndex;  // Render thread only
+    std::atomic<unsigned> m_ready;
+    bool                  m_hasCurrent;
+    bool                  m_hasPrevious;
+
+public:
+    RenderSnapshotExchange ();
+
+    // Simulation thread
+    RenderSnapshot & GetWriteSlot () { return m_slots[m_writeIndex]; }
+    void             Publish ();
+
+    // Render thread.  Acquire returns true if a newer snapshot became current.
+    bool                   Acquire ();
+    const RenderSnapshot * GetCurrent () const  { return m_hasCurrent ? &m_slots[m_readIndex] : nullptr; }
+    const RenderSnapshot * GetPrevious () const { return m_hasPrevious ? &m_previous : nullptr; }
+};
+
+
+//==============================================================================
+// Draws a snapshot, blended toward it from the one before.
+//
+// Sprites are matched between snapshots by their source sprite; matched ones
+// have their placement interpolated, and unmatched ones (new sprites, and
+// level tiles, which share a source per legend) draw where the current
+// snapshot has them.  Each drawn sprite gets a render-side SpriteAnimation
+// set to the snapshot's animation and frame, so backends that draw through
+// sprites never read simulation state.
+class SnapshotRenderer {
+private: // Data
+    std::vector<SpriteInstance>        m_instances;
+    std::vector<SpriteAnimation *>     m_sources;
+    std::unique_ptr<SpriteAnimation[]> m_proxies;
+    unsigned                           m_proxyCapacity;
+    const RenderSnapshot *             m_current;
+    Vec3                               m_cameraPosition;
+
+public:
+    SnapshotRenderer ();
+
+    // How far to blend from previous to current at nowCount: the render side
+    // runs one publish interval behind, so the result is in [0, 1].
+    static float ComputeAlpha (const RenderSnapshot * previous, const RenderSnapshot & current, std::uint64_t nowCount);
+
+    // Interpolates placements and the camera; current must stay valid
+    // through Submit.
+    void Prepare (const RenderSnapshot * previous, const RenderSnapshot & current, float alpha);
+    void Submit (IRenderBackend * backend);
+
+    // Queries
+    const Vec3 & GetCameraPosition () const { return m_cameraPosition; } // After Prepare
+};
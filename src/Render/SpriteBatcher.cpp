@@ -0,0 +1,272 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Christopher Higgins Barrett
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "SpriteBatcher.h"
+
+namespace {
+
+//==============================================================================
+// Maps floats to unsigned ints that sort in the same order.
+std::uint32_t SortableDepth (float depth) {
+
+    std::uint32_t bits;
+    memcpy(&bits, &depth, sizeof(bits));
+    return (bits & 0x80000000u) ? ~bits : bits | 0x80000000u;
+
+}
+
+} // namespace
+
+//==============================================================================
+SpriteBatcher::SpriteBatcher (unsigned maxBatchInstances) :
+    m_maxBatchInstances(maxBatchInstances ? maxBatchInstances : 1),
+    m_lastSheetId(0),
+    m_finished(false)
+{}
+
+//==============================================================================
+// Bakes the frame size (already in texRect) into the axes, the way
+// Spritesheet.fx scales its quad before applying the world matrix.
+void SpriteBatcher::BakeAxes (const Mtx44 & worldFromModelMtx, SpriteInstance * instance) {
+
+    const float * m = reinterpret_cast<const float *>(&worldFromModelMtx);
+    instance->axisX[0]  = m[0] * instance->texRect[2];
+    instance->axisX[1]  = m[1] * instance->texRect[2];
+    instance->axisY[0]  = m[4] * instance->texRect[3];
+    instance->axisY[1]  = m[5] * instance->texRect[3];
+    instance->origin[0] = m[12];
+    instance->origin[1] = m[13];
+
+}
+
+//==============================================================================
+SpriteBatcher *& SpriteBatcher::ActiveSlot () {
+    static SpriteBatcher * s_active = nullptr;
+    return s_active;
+}
+
+//==============================================================================
+// Frames rarely use more than a handful of sheets, and consecutive sprites
+// usually share one, so a remembered last hit and a linear scan beat a map.
+unsigned SpriteBatcher::FindSheetId (const Spritesheet * sheet) {
+
+    if (m_lastSheetId < m_sheets.size() && m_sheets[m_lastSheetId] == sheet)
+        return m_lastSheetId;
+
+    for (unsigned i = 0, count = unsigned(m_sheets.size()); i < count; ++i) {
+        if (m_sheets[i] == sheet)
+            return m_lastSheetId = i;
+    }
+
+    ASSERT(m_sheets.size() < 0x10000);
+    m_sheets.push_back(sheet);
+    return m_lastSheetId = unsigned(m_sheets.size() - 1);
+
+}
+
+//==============================================================================
+// Stable LSD radix sort, a byte at a time.  Passes whose byte is the same for
+// every key (usually the high bytes of layer and sheet id, and all of depth
+// when nothing sets it) are skipped.
+void SpriteBatcher::SortEntries () {
+
+    const unsigned count = unsigned(m_entries.size());
+    m_scratch.resize(count);
+
+    for (unsigned shift = 0; shift < 64; shift += 8) {
+        unsigned offsets[256] = {};
+        for (const SortEntry & entry : m_entries)
+            ++offsets[(entry.key >> shift) & 0xff];
+
+        if (offsets[(m_entries[0].key >> shift) & 0xff] == count)
+            continue;
+
+        unsigned sum = 0;
+        for (unsigned & offset : offsets) {
+            const unsigned bucketCount = offset;
+            offset  = sum;
+            sum    += bucketCount;
+        }
+
+        for (const SortEntry & entry : m_entries)
+            m_scratch[offsets[(entry.key >> shift) & 0xff]++] = entry;
+
+        m_entries.swap(m_scratch);
+    }
+
+}
+
+//==============================================================================
+void SpriteBatcher::FlushTransforms () {
+
+    const unsigned count = unsigned(m_pending.size());
+    ASSERT(count <= s_transformBatchSize);
+
+    const Transform * transforms[s_transformBatchSize];
+    Mtx44             matrices[s_transformBatchSize];
+    for (unsigned i = 0; i < count; ++i)
+        transforms[i] = m_pending[i].transform;
+
+    Transform::BuildWorldFromModelMtxBatch(transforms, count, matrices);
+    for (unsigned i = 0; i < count; ++i)
+        BakeAxes(matrices[i], &m_instances[m_pending[i].index]);
+
+    m_pending.clear();
+
+}
+
+//==============================================================================
+void SpriteBatcher::Begin () {
+
+    m_instances.clear();
+    m_sources.clear();
+    m_entries.clear();
+    m_sheets.clear();
+    m_packed.clear();
+    m_packedSources.clear();
+    m_batches.clear();
+    m_pending.clear();
+    m_lastSheetId = 0;
+    m_finished    = false;
+
+}
+
+//==============================================================================
+void SpriteBatcher::Add (const Spritesheet * sheet, unsigned layer, float depth, const SpriteInstance & instance, SpriteAnimation * source) {
+
+    ASSERT(layer < s_maxLayers);
+    ASSERT(!m_finished && "Begin a new frame before adding more sprites.");
+
+    const SortEntry entry = {
+        std::uint64_t(layer) << 48 | std::uint64_t(FindSheetId(sheet)) << 32 | SortableDepth(depth),
+        unsigned(m_instances.size())
+    };
+    m_entries.push_back(entry);
+    m_instances.push_back(instance);
+    m_sources.push_back(source);
+
+}
+
+//==============================================================================
+void SpriteBatcher::Add (const Spritesheet * sheet, unsigned layer, float depth, const Mtx44 & worldFromModelMtx, const SpritesheetFrame & frame, SpriteAnimation * source) {
+
+    SpriteInstance instance;
+    instance.texRect[0] = float(frame.x);
+    instance.texRect[1] = float(frame.y);
+    instance.texRect[2] = float(frame.width);
+    instance.texRect[3] = float(frame.height);
+    BakeAxes(worldFromModelMtx, &instance);
+
+    Add(sheet, layer, depth, instance, source);
+
+}
+
+//==============================================================================
+// Takes the instance's slot now, so the sort still sees submission order, and
+// fills in its placement when a batch of transforms is ready.
+void SpriteBatcher::Add (const Spritesheet * sheet, unsigned layer, float depth, const Transform & transform, const SpritesheetFrame & frame, SpriteAnimation * source) {
+
+    SpriteInstance instance = SpriteInstance();
+    instance.texRect[0] = float(frame.x);
+    instance.texRect[1] = float(frame.y);
+    instance.texRect[2] = float(frame.width);
+    instance.texRect[3] = float(frame.height);
+
+    const PendingTransform pending = { &transform, unsigned(m_instances.size()) };
+    Add(sheet, layer, depth, instance, source);
+    m_pending.push_back(pending);
+
+    if (m_pending.size() >= s_transformBatchSize)
+        FlushTransforms();
+
+}
+
+//==============================================================================
+void SpriteBatcher::Finish () {
+
+    if (m_finished)
+        return;
+    m_finished = true;
+
+    FlushTransforms();
+
+    const unsigned count = unsigned(m_entries.size());
+    if (!count)
+        return;
+
+    SortEntries();
+
+    m_packed.resize(count);
+    m_packedSources.resize(count);
+    for (unsigned i = 0; i < count; ++i) {
+        m_packed[i]        = m_instances[m_entries[i].index];
+        m_packedSources[i] = m_sources[m_entries[i].index];
+    }
+
+    // Cut a batch wherever the layer or sheet changes or the current one is
+    // full; depth only orders sprites inside a batch.
+    for (unsigned begin = 0; begin < count; ) {
+        const std::uint32_t layerSheet = std::uint32_t(m_entries[begin].key >> 32);
+        const unsigned      limit      = MIN(count, begin + m_maxBatchInstances);
+
+        unsigned end = begin + 1;
+        while (end < limit && std::uint32_t(m_entries[end].key >> 32) == layerSheet)
+            ++end;
+
+        const SpriteBatch batch = {
+            m_sheets[layerSheet & 0xffff],
+            layerSheet >> 16,
+            begin,
+            end - begin
+        };
+        m_batches.push_back(batch);
+        begin = end;
+    }
+
+}
+
+//==============================================================================
+void SpriteBatcher::Submit (ISpriteBatchSink * sink) {
+
+    ASSERT(sink);
+    Finish();
+
+    for (const SpriteBatch & batch : m_batches)
+        sink->DrawBatch(batch, &m_packed[batch.firstInstance], &m_packedSources[batch.firstInstance]);
+
+}
+
+//==============================================================================
+void SpriteBatcher::BuildWorldFromModelMtx (const SpriteInstance & instance, Mtx44 * matrixOut) {
+
+    const float invWidth  = instance.texRect[2] > 0.0f ? 1.0f / instance.texRect[2] : 0.0f;
+    const float invHeight = instance.texRect[3] > 0.0f ? 1.0f / instance.texRect[3] : 0.0f;
+
+    float * m = reinterpret_cast<float *>(matrixOut);
+    m[0]  = instance.axisX[0] * invWidth;  m[1]  = instance.axisX[1] * invWidth;  m[2]  = 0.0f; m[3]  = 0.0f;
+    m[4]  = instance.axisY[0] * invHeight; m[5]  = instance.axisY[1] * invHeight; m[6]  = 0.0f; m[7]  = 0.0f;
+    m[8]  = 0.0f;                          m[9]  = 0.0f;                          m[10] = 1.0f; m[11] = 0.0f;
+    m[12] = instance.origin[0];            m[13] = instance.origin[1];            m[14] = 0.0f; m[15] = 1.0f;
+
+}
@@ -0,0 +1,141 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Christopher Higgins Barrett
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+//==============================================================================
+// One sprite as an instanced draw would read it: the frame-sized quad's
+// placement in world space, and the frame's rectangle in the sheet.  A model
+// corner (u, v) in [0, 1] lands at origin + u * axisX + v * axisY.
+struct SpriteInstance {
+    float axisX[2];   // World-space span of the frame's width
+    float axisY[2];   // World-space span of the frame's height
+    float origin[2];  // World-space position of model (0, 0)
+    float texRect[4]; // Frame x, y, width, height in texels
+};
+static_assert(sizeof(SpriteInstance) == 10 * sizeof(float), "SpriteInstance is uploaded as packed floats.");
+
+// A run of packed instances that share a sheet (texture) and layer.
+struct SpriteBatch {
+    const Spritesheet * sheet;
+    unsigned            layer;
+    unsigned            firstInstance;
+    unsigned            instanceCount;
+};
+
+//==============================================================================
+// Receives a finished frame of batches, in draw order.  sources runs parallel
+// to instances and holds the sprite each came from (or null).  There is no
+// instanced backend yet: the sheets don't expose their textures, so
+// ImmediateRenderBackend still draws each source sprite itself, and batching
+// only buys the sorted order and the counts CountingRenderBackend reports.
+class ISpriteBatchSink {
+public:
+    virtual ~ISpriteBatchSink () {}
+
+    virtual void DrawBatch (const SpriteBatch & batch, const SpriteInstance * instances, SpriteAnimation * const * sources) = 0;
+};
+
+
+//==============================================================================
+// The frame's render command buffer: collects sprites, sorts them by layer,
+// sheet, then depth, and packs them into batches of one sheet each.
+//
+// Lower layers draw first, and lower depths first within a sheet.  The sort
+// is stable, so sprites with equal keys keep submission order, but sprites
+// from different sheets may swap; anything that must overlap in a set order
+// belongs on its own layer.  Nothing here touches the graphics device.
+class SpriteBatcher {
+public: // Types and Constants
+    static const unsigned s_maxLayers                = 0x10000;
+    static const unsigned s_defaultMaxBatchInstances = 4096;
+
+private: // Types
+    struct SortEntry {
+        std::uint64_t key;   // layer << 48 | sheet id << 32 | depth bits
+        unsigned      index; // Into m_instances
+    };
+
+    // A sprite added by Transform whose axes and origin wait for the next
+    // batched matrix build.
+    struct PendingTransform {
+        const Transform * transform;
+        unsigned          index; // Into m_instances
+    };
+
+    static const unsigned s_transformBatchSize = 64;
+
+private: // Data
+    std::vector<SpriteInstance>      m_instances; // Submission order
+    std::vector<SpriteAnimation *>   m_sources;
+    std::vector<SortEntry>           m_entries;
+    std::vector<SortEntry>           m_scratch;
+    std::vector<const Spritesheet *> m_sheets;    // Sheet id -> sheet, this frame
+    std::vector<SpriteInstance>      m_packed;    // Sorted order
+    std::vector<SpriteAnimation *>   m_packedSources;
+    std::vector<SpriteBatch>         m_batches;
+    std::vector<PendingTransform>    m_pending;
+    unsigned                         m_maxBatchInstances;
+    unsigned                         m_lastSheetId;
+    bool                             m_finished;
+
+private: // Helpers
+    static SpriteBatcher *& ActiveSlot ();
+
+    static void BakeAxes (const Mtx44 & worldFromModelMtx, SpriteInstance * instance);
+
+    unsigned FindSheetId (const Spritesheet * sheet);
+    void     SortEntries ();
+    void     FlushTransforms ();
+
+public:
+    explicit SpriteBatcher (unsigned maxBatchInstances = s_defaultMaxBatchInstances);
+
+    // Commands
+    void Begin ();
+    void Add (const Spritesheet * sheet, unsigned layer, float depth, const SpriteInstance & instance, SpriteAnimation * source = nullptr);
+    void Add (const Spritesheet * sheet, unsigned layer, float depth, const Mtx44 & worldFromModelMtx, const SpritesheetFrame & frame, SpriteAnimation * source = nullptr);
+
+    // Same as the matrix form, but the world matrices are built in batches
+    // with Transform::BuildWorldFromModelMtxBatch.  The transform is read at
+    // the next batch or at Finish, so it must stay put until then.
+    void Add (const Spritesheet * sheet, unsigned layer, float depth, const Transform & transform, const SpritesheetFrame & frame, SpriteAnimation * source = nullptr);
+    void Finish (); // Sorts and packs; Submit calls it if needed
+    void Submit (ISpriteBatchSink * sink);
+
+    // Where GocSprite and Level send sprites instead of drawing them one at a
+    // time.  May be null, in which case they draw immediately.
+    static void            SetActive (SpriteBatcher * batcher) { ActiveSlot() = batcher; }
+    static SpriteBatcher * GetActive ()                        { return ActiveSlot(); }
+
+    // Queries
+    unsigned                               GetInstanceCount () const   { return unsigned(m_instances.size()); }
+    unsigned                               GetSheetCount () const      { return unsigned(m_sheets.size()); }
+    const std::vector<SpriteBatch> &       GetBatches () const         { return m_batches; }       // After Finish
+    const std::vector<SpriteInstance> &    GetPackedInstances () const { return m_packed; }        // After Finish
+    const std::vector<SpriteAnimation *> & GetPackedSources () const   { return m_packedSources; } // After Finish
+
+    // Inverse of the matrix Add bakes into an instance, less any z terms.
+    static void BuildWorldFromModelMtx (const SpriteInstance & instance, Mtx44 * matrixOut);
+};
@@ -0,0 +1,118 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Christopher Higgins Barrett
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+// The JSON side of SpritesheetDesc, kept apart so builds without the JSON
+// parser (the headless runner) can link everything else.
+
+#include "SpritesheetDesc.h"
+
+#include <DataMap.hpp>
+#include <JsonParserCallbackForDataMap.hpp>
+
+namespace {
+
+//==============================================================================
+bool ReadChildString (const CSaruContainer::DataMapReader & parent, const char * name, std::string * valueOut) {
+
+    CSaruContainer::DataMapReader reader(parent);
+    reader.ToChild(name);
+    if (!reader.IsValid())
+        return false;
+
+    char tempStr[512];
+    if (!reader.ReadStringSafe(tempStr, arrsize(tempStr)))
+        return false;
+
+    *valueOut = tempStr;
+    return true;
+
+}
+
+//==============================================================================
+unsigned ReadChildUnsigned (const CSaruContainer::DataMapReader & parent, const char * name) {
+
+    CSaruContainer::DataMapReader reader(parent);
+    reader.ToChild(name);
+    return reader.IsValid() ? unsigned(MAX(reader.ReadInt(), 0)) : 0;
+
+}
+
+} // namespace
+
+//==============================================================================
+bool ParseSpritesheetDatafile (const char * filepath, SpritesheetDesc * descOut) {
+
+    CSaruContainer::DataMap                 dataMap;
+    CSaruJson::JsonParserCallbackForDataMap callback(dataMap.GetMutator());
+
+    FILE * file = Core::OpenFile(filepath, "rt");
+    if (!file)
+        return false;
+
+    CSaruJson::JsonParser parser;
+    const bool parsed = parser.ParseEntireFile(file, NULL, 0, &callback);
+    fclose(file);
+    if (!parsed)
+        return false;
+
+    CSaruContainer::DataMapReader reader = dataMap.GetReader();
+    reader.ToChild("spritesheet");
+    if (!reader.IsValid())
+        return false;
+
+    if (!ReadChildString(reader, "name", &descOut->name) || !ReadChildString(reader, "imageFile", &descOut->imageFile))
+        return false;
+
+    descOut->animations.clear();
+
+    CSaruContainer::DataMapReader animReader(reader);
+    animReader.ToChild("animations");
+    if (!animReader.IsValid())
+        return false;
+
+    for (animReader.ToFirstChild(); animReader.IsValid(); animReader.ToNextSibling()) {
+        descOut->animations.push_back(SpritesheetAnimDesc());
+        SpritesheetAnimDesc & anim = descOut->animations.back();
+        ReadChildString(animReader, "name", &anim.name);
+
+        CSaruContainer::DataMapReader frameReader(animReader);
+        frameReader.ToChild("frames");
+        if (!frameReader.IsValid())
+            continue;
+
+        for (frameReader.ToFirstChild(); frameReader.IsValid(); frameReader.ToNextSibling()) {
+            SpritesheetFrameDesc frame;
+            frame.x          = ReadChildUnsigned(frameReader, "x");
+            frame.y          = ReadChildUnsigned(frameReader, "y");
+            frame.width      = ReadChildUnsigned(frameReader, "width");
+            frame.height     = ReadChildUnsigned(frameReader, "height");
+            frame.durationMs = ReadChildUnsigned(frameReader, "durationMs");
+
+            anim.frames.push_back(frame);
+        }
+    }
+
+    return true;
+
+}
@@ -0,0 +1,157 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Christopher Higgins Barrett
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "SpritesheetDesc.h"
+
+namespace {
+
+//==============================================================================
+void WriteEscapedString (FILE * file, const std::string & str) {
+
+    fputc('"', file);
+    for (char c : str) {
+        if (c == '"' || c == '\\')
+            fputc('\\', file);
+        fputc(c, file);
+    }
+    fputc('"', file);
+
+}
+
+} // namespace
+
+//==============================================================================
+unsigned SpritesheetDesc::GetFrameCount () const {
+
+    unsigned count = 0;
+    for (const SpritesheetAnimDesc & anim : animations)
+        count += unsigned(anim.frames.size());
+    return count;
+
+}
+
+//==============================================================================
+// Same layout the hand-written datafiles use, so output diffs cleanly.
+bool WriteSpritesheetDatafile (const char * filepath, const SpritesheetDesc & desc) {
+
+    FILE * file = Core::OpenFile(filepath, "wt");
+    if (!file)
+        return false;
+
+    fprintf(file, "{\n\t\"spritesheet\": {\n\t\t\"name\": ");
+    WriteEscapedString(file, desc.name);
+    fprintf(file, ",\n\t\t\"imageFile\": ");
+    WriteEscapedString(file, desc.imageFile);
+    fprintf(file, ",\n\t\t\"animations\": [");
+
+    for (unsigned a = 0, animCount = unsigned(desc.animations.size()); a < animCount; ++a) {
+        const SpritesheetAnimDesc & anim = desc.animations[a];
+        fprintf(file, "%s\n\t\t\t{\n\t\t\t\t\"name\": ", a ? "," : "");
+        WriteEscapedString(file, anim.name);
+        fprintf(file, ",\n\t\t\t\t\"frames\": [");
+
+        for (unsigned f = 0, frameCount = unsigned(anim.frames.size()); f < frameCount; ++f) {
+            const SpritesheetFrameDesc & frame = anim.frames[f];
+            fprintf(
+                file,
+                "%s\n\t\t\t\t\t{\n\t\t\t\t\t\t\"x\": %u,\n\t\t\t\t\t\t\"y\": %u,\n\t\t\t\t\t\t\"width\": %u,\n\t\t\t\t\t\t\"height\": %u",
+                f ? "," : "",
+                frame.x,
+                frame.y,
+                frame.width,
+                frame.height
+            );
+            if (frame.durationMs)
+                fprintf(file, ",\n\t\t\t\t\t\t\"durationMs\": %u", frame.durationMs);
+            fprintf(file, "\n\t\t\t\t\t}");
+        }
+        fprintf(file, "\n\t\t\t\t]\n\t\t\t}");
+    }
+
+    fprintf(file, "\n\t\t]\n\t}\n}\n");
+    const bool ok = !ferror(file);
+    fclose(file);
+    return ok;
+
+}
+
+//==============================================================================
+unsigned PackSpritesheetDescs (
+    AtlasPacker *                         packer,
+    SpritesheetDesc *                     descs,
+    unsigned                              count,
+    const std::string &                   pagePrefix,
+    std::vector<AtlasPacker::Frame> *     framesOut,
+    std::vector<AtlasPacker::Placement> * placementsOut
+) {
+
+    ASSERT(packer->GetSettings().keepSourcesTogether);
+
+    framesOut->clear();
+    for (unsigned d = 0; d < count; ++d) {
+        for (const SpritesheetAnimDesc & anim : descs[d].animations) {
+            for (const SpritesheetFrameDesc & frameDesc : anim.frames) {
+                const AtlasPacker::Frame frame = { d, frameDesc.x, frameDesc.y, frameDesc.width, frameDesc.height };
+                framesOut->push_back(frame);
+            }
+        }
+    }
+
+    placementsOut->resize(framesOut->size());
+    if (framesOut->empty())
+        return 0;
+
+    // The packer never places empty frames; they have no texels to move.
+    const unsigned pageCount = packer->Pack(framesOut->data(), unsigned(framesOut->size()), placementsOut->data());
+    for (unsigned i = 0; i < framesOut->size(); ++i) {
+        const AtlasPacker::Frame & frame = (*framesOut)[i];
+        if ((*placementsOut)[i].page == AtlasPacker::s_unplaced && frame.width && frame.height)
+            return 0;
+    }
+
+    const AtlasPacker::Placement * placement = placementsOut->data();
+    for (unsigned d = 0; d < count; ++d) {
+        bool pageSet = false;
+        for (SpritesheetAnimDesc & anim : descs[d].animations) {
+            for (SpritesheetFrameDesc & frameDesc : anim.frames) {
+                if (placement->page == AtlasPacker::s_unplaced) {
+                    frameDesc.x = 0;
+                    frameDesc.y = 0;
+                }
+                else {
+                    if (!pageSet) {
+                        descs[d].imageFile = pagePrefix + "-" + std::to_string(placement->page) + ".png";
+                        pageSet            = true;
+                    }
+                    frameDesc.x = placement->x;
+                    frameDesc.y = placement->y;
+                }
+                ++placement;
+            }
+        }
+    }
+
+    return pageCount;
+
+}
@@ -0,0 +1,71 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Christopher Higgins Barrett
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include "AtlasPacker.h"
+
+//==============================================================================
+// A spritesheet datafile as plain data, without loading its image.  Mirrors
+// the JSON: { "spritesheet": { name, imageFile, animations: [ { name,
+// frames: [ { x, y, width, height, durationMs } ] } ] } }.
+struct SpritesheetFrameDesc {
+    unsigned x;
+    unsigned y;
+    unsigned width;
+    unsigned height;
+    unsigned durationMs; // 0 where the file leaves it out
+};
+
+struct SpritesheetAnimDesc {
+    std::string                       name;
+    std::vector<SpritesheetFrameDesc> frames;
+};
+
+struct SpritesheetDesc {
+    std::string                      name;
+    std::string                      imageFile; // Relative to the datafile
+    std::vector<SpritesheetAnimDesc> animations;
+
+    unsigned GetFrameCount () const;
+};
+
+bool ParseSpritesheetDatafile (const char * filepath, SpritesheetDesc * descOut);
+bool WriteSpritesheetDatafile (const char * filepath, const SpritesheetDesc & desc);
+
+// Packs the frames of several sheets onto shared atlas pages and points each
+// desc at its page: frame x/y are moved and imageFile becomes
+// "<pagePrefix>-<page>.png".  The packer must keep sources together, since a
+// sheet names one image.  framesOut/placementsOut (source = desc index) are
+// what CompositeAtlasPage needs to build the page images.  Frames with no
+// width or height stay unplaced and move to 0, 0.  Returns the page count, or
+// 0 if some frame didn't fit; the descs are left alone then.
+unsigned PackSpritesheetDescs (
+    AtlasPacker *                        packer,
+    SpritesheetDesc *                    descs,
+    unsigned                             count,
+    const std::string &                  pagePrefix,
+    std::vector<AtlasPacker::Frame> *     framesOut,
+    std::vector<AtlasPacker::Placement> * placementsOut
+);
@@ -0,0 +1,367 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Christopher Higgins Barrett
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "SpritesheetFile.h"
+#include "../AnimName.h"
+
+namespace SpritesheetFile {
+
+namespace {
+
+static_assert(sizeof(Header) % 4 == 0 && sizeof(Anim) % 4 == 0 && sizeof(Frame) % 4 == 0, "Tables must start 4-byte aligned; Validate checks their offsets.");
+
+//==============================================================================
+class StringTable {
+private: // Data
+    std::vector<char>                    m_bytes;
+    std::map<std::string, std::uint32_t> m_offsets;
+
+public:
+    StringTable () : m_bytes(1, '\0') {}
+
+    std::uint32_t Add (const std::string & str) {
+        if (str.empty())
+            return 0;
+
+        std::map<std::string, std::uint32_t>::const_iterator it = m_offsets.find(str);
+        if (it != m_offsets.end())
+            return it->second;
+
+        const std::uint32_t offset = std::uint32_t(m_bytes.size());
+        m_bytes.insert(m_bytes.end(), str.begin(), str.end());
+        m_bytes.push_back('\0');
+        m_offsets[str] = offset;
+        return offset;
+    }
+
+    const std::vector<char> & GetBytes () const { return m_bytes; }
+};
+
+//==============================================================================
+template <typename T>
+const T * At (const void * data, std::uint32_t offset) {
+    return reinterpret_cast<const T *>(static_cast<const char *>(data) + offset);
+}
+
+//==============================================================================
+bool RangeInside (size_t fileSize, std::uint32_t offset, size_t count, size_t elementSize) {
+    return offset <= fileSize && count <= (fileSize - offset) / elementSize;
+}
+
+} // namespace
+
+//==============================================================================
+bool Write (const char * filepath, const SpritesheetDesc & desc, std::uint64_t contentHash) {
+
+    StringTable strings;
+
+    std::vector<Anim>  anims(desc.animations.size());
+    std::vector<Frame> frames;
+    frames.reserve(desc.GetFrameCount());
+    for (unsigned i = 0; i < anims.size(); ++i) {
+        const SpritesheetAnimDesc & animDesc = desc.animations[i];
+        anims[i].nameId     = Core::Djb2Hash(animDesc.name.c_str());
+        anims[i].nameString = strings.Add(animDesc.name);
+        anims[i].firstFrame = std::uint32_t(frames.size());
+        anims[i].frameCount = std::uint32_t(animDesc.frames.size());
+
+        for (const SpritesheetFrameDesc & frameDesc : animDesc.frames) {
+            const Frame frame = { frameDesc.x, frameDesc.y, frameDesc.width, frameDesc.height, frameDesc.durationMs };
+            frames.push_back(frame);
+        }
+    }
+
+    Header header;
+    header.magic             = s_magic;
+    header.version           = s_version;
+    header.contentHash       = contentHash;
+    header.nameString        = strings.Add(desc.name);
+    header.imageFileString   = strings.Add(desc.imageFile);
+    header.animCount         = std::uint32_t(anims.size());
+    header.animOffset        = sizeof(Header);
+    header.frameCount        = std::uint32_t(frames.size());
+    header.frameOffset       = header.animOffset + std::uint32_t(anims.size() * sizeof(Anim));
+    header.stringTableOffset = header.frameOffset + std::uint32_t(frames.size() * sizeof(Frame));
+    header.stringTableSize   = std::uint32_t(strings.GetBytes().size());
+
+    std::vector<char> file(header.stringTableOffset + header.stringTableSize, '\0');
+    memcpy(&file[0], &header, sizeof(header));
+    if (!anims.empty())
+        memcpy(&file[header.animOffset], &anims[0], anims.size() * sizeof(Anim));
+    if (!frames.empty())
+        memcpy(&file[header.frameOffset], &frames[0], frames.size() * sizeof(Frame));
+    memcpy(&file[header.stringTableOffset], &strings.GetBytes()[0], header.stringTableSize);
+
+    FILE * out = Core::OpenFile(filepath, "wb");
+    if (!out)
+        return false;
+    const bool ok = fwrite(&file[0], 1, file.size(), out) == file.size();
+    fclose(out);
+
+    return ok;
+
+}
+
+//==============================================================================
+const Header * Validate (const void * data, size_t size) {
+
+    if (!data || size < sizeof(Header))
+        return nullptr;
+
+    const Header * header = At<Header>(data, 0);
+    if (header->magic != s_magic || header->version != s_version)
+        return nullptr;
+    if (header->animOffset % 4 || header->frameOffset % 4)
+        return nullptr;
+
+    if (!RangeInside(size, header->animOffset,        header->animCount,       sizeof(Anim))  ||
+        !RangeInside(size, header->frameOffset,       header->frameCount,      sizeof(Frame)) ||
+        !RangeInside(size, header->stringTableOffset, header->stringTableSize, 1)             ||
+        !header->stringTableSize)
+        return nullptr;
+
+    const char * strings = At<char>(data, header->stringTableOffset);
+    if (strings[header->stringTableSize - 1] != '\0'        ||
+        header->nameString      >= header->stringTableSize ||
+        header->imageFileString >= header->stringTableSize)
+        return nullptr;
+
+    const Anim * anims = At<Anim>(data, header->animOffset);
+    for (std::uint32_t i = 0; i < header->animCount; ++i) {
+        if (anims[i].nameString >= header->stringTableSize ||
+            anims[i].firstFrame > header->frameCount       ||
+            anims[i].frameCount > header->frameCount - anims[i].firstFrame)
+            return nullptr;
+    }
+
+    return header;
+
+}
+
+//==============================================================================
+void ReadDesc (const void * data, SpritesheetDesc * descOut) {
+
+    const Header * header = At<Header>(data, 0);
+    const Anim *   anims  = GetAnims(data);
+    const Frame *  frames = GetFrames(data);
+
+    descOut->name      = GetString(data, header->nameString);
+    descOut->imageFile = GetString(data, header->imageFileString);
+
+    descOut->animations.resize(header->animCount);
+    for (std::uint32_t i = 0; i < header->animCount; ++i) {
+        SpritesheetAnimDesc & animDesc = descOut->animations[i];
+        animDesc.name = GetString(data, anims[i].nameString);
+        animDesc.frames.resize(anims[i].frameCount);
+        for (std::uint32_t f = 0; f < anims[i].frameCount; ++f) {
+            const Frame &          frame     = frames[anims[i].firstFrame + f];
+            SpritesheetFrameDesc & frameDesc = animDesc.frames[f];
+            frameDesc.x          = frame.x;
+            frameDesc.y          = frame.y;
+            frameDesc.width      = frame.width;
+            frameDesc.height     = frame.height;
+            frameDesc.durationMs = frame.durationMs;
+        }
+    }
+
+}
+
+//==============================================================================
+const Anim * GetAnims (const void * data) {
+    return At<Anim>(data, At<Header>(data, 0)->animOffset);
+}
+
+//==============================================================================
+const Frame * GetFrames (const void * data) {
+    return At<Frame>(data, At<Header>(data, 0)->frameOffset);
+}
+
+//==============================================================================
+const char * GetString (const void * data, std::uint32_t stringOffset) {
+    return At<char>(data, At<Header>(data, 0)->stringTableOffset) + stringOffset;
+}
+
+//==============================================================================
+bool Cook (const char * datafilePath, const char * cookedPath, bool * upToDateOut) {
+
+    if (upToDateOut)
+        *upToDateOut = false;
+
+    // Hashing the datafile is a single pass over its bytes, far cheaper than
+    // parsing it.
+    std::uint64_t contentHash;
+    {
+        Core::MappedFile datafile;
+        if (!datafile.Open(datafilePath))
+            return false;
+        contentHash = Core::Fnv1aHash64(datafile.GetData(), datafile.GetSize());
+    }
+
+    {
+        Core::MappedFile cooked;
+        if (cooked.Open(cookedPath)) {
+            const Header * header = Validate(cooked.GetData(), cooked.GetSize());
+            if (header && header->contentHash == contentHash) {
+                if (upToDateOut)
+                    *upToDateOut = true;
+                return true;
+            }
+        }
+        // Closed here; Windows won't let a mapped file be rewritten.
+    }
+
+    SpritesheetDesc desc;
+    if (!ParseSpritesheetDatafile(datafilePath, &desc))
+        return false;
+
+    return Write(cookedPath, desc, contentHash);
+
+}
+
+//==============================================================================
+std::string GetCookedPath (const char * datafilePath) {
+
+    std::string path = datafilePath;
+
+    const size_t dot   = path.find_last_of('.');
+    const size_t slash = path.find_last_of("/\\");
+    if (dot != std::string::npos && (slash == std::string::npos || dot > slash))
+        path.erase(dot);
+
+    return path + s_extension;
+
+}
+
+//==============================================================================
+bool LoadDesc (const char * datafilePath, SpritesheetDesc * descOut) {
+
+    const std::string cookedPath = GetCookedPath(datafilePath);
+    Cook(datafilePath, cookedPath.c_str());
+
+    Core::MappedFile cooked;
+    if (!cooked.Open(cookedPath.c_str()) || !Validate(cooked.GetData(), cooked.GetSize()))
+        return false;
+
+    ReadDesc(cooked.GetData(), descOut);
+    return true;
+
+}
+
+} // namespace SpritesheetFile
+
+
+//==============================================================================
+// CookedSpritesheet
+//==============================================================================
+
+//==============================================================================
+CookedSpritesheet::CookedSpritesheet () :
+    m_header(nullptr),
+    m_anims(nullptr),
+    m_frames(nullptr)
+{}
+
+//==============================================================================
+bool CookedSpritesheet::Open (const char * cookedPath) {
+
+    Close();
+
+    if (!m_file.Open(cookedPath))
+        return false;
+
+    m_header = SpritesheetFile::Validate(m_file.GetData(), m_file.GetSize());
+    if (!m_header) {
+        m_file.Close();
+        return false;
+    }
+
+    m_anims  = SpritesheetFile::GetAnims(m_file.GetData());
+    m_frames = SpritesheetFile::GetFrames(m_file.GetData());
+    return true;
+
+}
+
+//==============================================================================
+void CookedSpritesheet::Close () {
+
+    m_file.Close();
+    m_header = nullptr;
+    m_anims  = nullptr;
+    m_frames = nullptr;
+
+}
+
+//==============================================================================
+bool CookedSpritesheet::OpenFromDatafile (const char * datafilePath) {
+
+    // Our own mapping would keep Cook from replacing the file.
+    Close();
+
+    const std::string cookedPath = SpritesheetFile::GetCookedPath(datafilePath);
+    if (!SpritesheetFile::Cook(datafilePath, cookedPath.c_str()))
+        return false;
+
+    return Open(cookedPath.c_str());
+
+}
+
+//==============================================================================
+const char * CookedSpritesheet::GetName () const {
+    return m_header ? SpritesheetFile::GetString(m_file.GetData(), m_header->nameString) : "";
+}
+
+//==============================================================================
+const char * CookedSpritesheet::GetImageFile () const {
+    return m_header ? SpritesheetFile::GetString(m_file.GetData(), m_header->imageFileString) : "";
+}
+
+//==============================================================================
+const char * CookedSpritesheet::GetAnimName (unsigned animIndex) const {
+
+    ASSERT(animIndex < GetAnimCount());
+    return SpritesheetFile::GetString(m_file.GetData(), m_anims[animIndex].nameString);
+
+}
+
+//==============================================================================
+// Ids are 32-bit hashes, so a hit is confirmed against the stored name.
+unsigned CookedSpritesheet::FindAnimIndex (const AnimName & name) const {
+
+    for (unsigned i = 0, count = GetAnimCount(); i < count; ++i) {
+        if (m_anims[i].nameId == name.id && !strcmp(GetAnimName(i), name.text))
+            return i;
+    }
+
+    return SpritesheetFile::s_noAnim;
+
+}
+
+//==============================================================================
+const SpritesheetFile::Frame * CookedSpritesheet::GetFrames (unsigned animIndex, unsigned * countOut) const {
+
+    ASSERT(animIndex < GetAnimCount());
+    *countOut = m_anims[animIndex].frameCount;
+    return m_frames + m_anims[animIndex].firstFrame;
+
+}
@@ -0,0 +1,145 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Christopher Higgins Barrett
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include "SpritesheetDesc.h"
+#include "../MappedFile.h"
+
+struct AnimName;
+
+//==============================================================================
+// Cooked (binary) spritesheet files, so loading a sheet is a mapping and a
+// header check instead of a JSON parse.
+//
+// Layout, all little-endian, all offsets in bytes from the start of the file:
+//
+//     Header
+//     Anim animTable[animCount]       in datafile order, so anim indices match
+//                                     the sheet's
+//     Frame frames[frameCount]        every animation's frames back to back
+//     string table                    NUL-terminated; offset 0 is ""
+//
+// contentHash is Core::Fnv1aHash64 of the source datafile's bytes.  Cook compares it to
+// skip sheets whose datafile hasn't changed since they were last cooked.
+namespace SpritesheetFile {
+
+const std::uint32_t s_magic       = 'C' | 'S' << 8 | 'P' << 16 | 'R' << 24; // "CSPR"
+const std::uint32_t s_version     = 1;
+const unsigned      s_noAnim      = unsigned(-1);
+const char          s_extension[] = ".cspr";
+
+struct Header {
+    std::uint32_t magic;
+    std::uint32_t version;
+    std::uint64_t contentHash;
+    std::uint32_t nameString;
+    std::uint32_t imageFileString;
+    std::uint32_t animCount;
+    std::uint32_t animOffset;
+    std::uint32_t frameCount;
+    std::uint32_t frameOffset;
+    std::uint32_t stringTableOffset;
+    std::uint32_t stringTableSize;
+};
+
+struct Anim {
+    std::uint32_t nameId;     // Core::Djb2Hash of the name; see AnimName
+    std::uint32_t nameString;
+    std::uint32_t firstFrame;
+    std::uint32_t frameCount;
+};
+
+struct Frame {
+    std::uint32_t x;
+    std::uint32_t y;
+    std::uint32_t width;
+    std::uint32_t height;
+    std::uint32_t durationMs;
+};
+
+bool Write (const char * filepath, const SpritesheetDesc & desc, std::uint64_t contentHash);
+
+// Checks the header and that every table lies inside the data.  Returns the
+// header, or null if the data isn't a usable spritesheet file.
+const Header * Validate (const void * data, size_t size);
+
+// All expect data that passed Validate.
+void          ReadDesc (const void * data, SpritesheetDesc * descOut);
+const Anim *  GetAnims (const void * data);
+const Frame * GetFrames (const void * data);
+const char *  GetString (const void * data, std::uint32_t stringOffset);
+
+// Writes cookedPath from datafilePath unless cookedPath is already valid and
+// was cooked from identical contents.  Returns whether cookedPath is now up
+// to date; upToDateOut says whether that took no work.
+bool Cook (const char * datafilePath, const char * cookedPath, bool * upToDateOut = nullptr);
+
+// "sprites/kirby.json" -> "sprites/kirby.cspr"
+std::string GetCookedPath (const char * datafilePath);
+
+// The datafile's description, read back from its cooked file after cooking
+// it where this build can parse it.  A cooked file shipped without its
+// datafile is used as is.
+bool LoadDesc (const char * datafilePath, SpritesheetDesc * descOut);
+
+} // namespace SpritesheetFile
+
+
+//==============================================================================
+// A cooked spritesheet, mapped and read in place.  Animation lookups go by
+// AnimName id, so finding one is a scan of a small table with no string
+// compares.
+class CookedSpritesheet {
+private: // Data
+    Core::MappedFile                m_file;
+    const SpritesheetFile::Header * m_header;
+    const SpritesheetFile::Anim *   m_anims;
+    const SpritesheetFile::Frame *  m_frames;
+
+private: // Not copyable
+    CookedSpritesheet (const CookedSpritesheet &);
+    CookedSpritesheet & operator= (const CookedSpritesheet &);
+
+public:
+    CookedSpritesheet ();
+
+    // Commands
+    bool Open (const char * cookedPath);
+    void Close ();
+
+    // Recooks the datafile if it changed, then opens the cooked file next to
+    // it.  Also the hot reload path: an unchanged datafile costs one hash.
+    bool OpenFromDatafile (const char * datafilePath);
+
+    // Queries
+    bool         IsOpen () const       { return m_header != nullptr; }
+    const char * GetName () const;
+    const char * GetImageFile () const; // Relative to the datafile
+    unsigned     GetAnimCount () const { return m_header ? m_header->animCount : 0; }
+    const char * GetAnimName (unsigned animIndex) const;
+
+    unsigned                       FindAnimIndex (const AnimName & name) const; // SpritesheetFile::s_noAnim if missing
+    const SpritesheetFile::Frame * GetFrames (unsigned animIndex, unsigned * countOut) const;
+};
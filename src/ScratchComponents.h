@@ -28,10 +28,16 @@ SOFTWARE.
 #include <SpriteAnimation.h>
 #include <Spritesheet.h>
 #include <Camera.h>
-#include <XInputGamepad.h>
 //#include "graphics/DebugLine.hpp"
 
-#include "Levels\Level.hpp"
+#include "Levels/Level.hpp"
+#include "Levels/LevelStreamer.hpp"
+#include "Levels/LevelFile.hpp"
+#include "Levels/LevelCollision.hpp"
+#include "Collision/Broadphase.h"
+#include "Input/GamepadInput.h"
+#include "AnimName.h"
+#include "Render/SpriteBatcher.h"
 
 
 enum EScratchGocType : unsigned {
@@ -42,13 +48,27 @@ enum EScratchGocType : unsigned {
     GOC_TYPE_DEBUG_LINES = 1 << 16 | 4,
     GOC_TYPE_LEVEL       = 1 << 16 | 5,
     GOC_TYPE_CAMERA      = 1 << 16 | 6,
+    GOC_TYPE_BROADPHASE  = 1 << 16 | 7,
 };
 
 //==============================================================================
 class GocCamera : public GameObjectComponent {
+public:
+    static const GlobalTypeId s_typeId = GOC_TYPE_CAMERA;
+    static const unsigned     s_reads  = COMPONENT_DATA_TRANSFORM_POSITION;
+    static const unsigned     s_writes = COMPONENT_DATA_CAMERA;
 
+private:
     Camera m_camera;
+    float  m_viewWidth;  // World units visible, centered on the camera
+    float  m_viewHeight;
+
+    static GocCamera *& ActiveCameraSlot () {
+        static GocCamera * s_activeCamera = nullptr;
+        return s_activeCamera;
+    }
 
+public: // GameObjectComponent
     void Update (float dt) override {
         ref(dt);
         Vec3 pos = m_camera.GetPosition();
@@ -61,60 +81,171 @@ class GocCamera : public GameObjectComponent {
     }
 
 public:
-    GocCamera () : GameObjectComponent(GOC_TYPE_CAMERA)
+    GocCamera () :
+        GameObjectComponent(s_typeId),
+        m_viewWidth(640.0f),
+        m_viewHeight(480.0f)
     {}
 
+    ~GocCamera () {
+        if (ActiveCameraSlot() == this)
+            ActiveCameraSlot() = nullptr;
+    }
+
     Camera & GetCamera () { return m_camera; }
 
     void SetAsActiveCamera () {
         g_graphicsMgr->SetActiveCamera(&m_camera);
+        ActiveCameraSlot() = this;
+    }
+
+    static GocCamera * GetActiveCamera () { return ActiveCameraSlot(); }
+
+    void SetViewExtents (float width, float height) {
+        m_viewWidth  = width;
+        m_viewHeight = height;
+    }
+
+    WorldRect GetViewRect () const {
+        const Vec3 & pos = m_camera.GetPosition();
+        WorldRect    rect = {
+            pos.x - 0.5f * m_viewWidth,
+            pos.y - 0.5f * m_viewHeight,
+            pos.x + 0.5f * m_viewWidth,
+            pos.y + 0.5f * m_viewHeight,
+        };
+        return rect;
     }
 
 };
 
 
 //==============================================================================
+// Input as gameplay reads it, one GamepadState a frame from the source: the
+// pad (XInputGamepadSource), a replay or synthetic play.  Without a source
+// the state stays neutral.
 class GocGamepad : public GameObjectComponent {
+public:
+    static const GlobalTypeId s_typeId = GOC_TYPE_GAMEPAD;
+    static const unsigned     s_reads  = COMPONENT_DATA_NONE;
+    static const unsigned     s_writes = COMPONENT_DATA_INPUT;
+
 protected:
-    XInputGamepad m_gamepad;
+    IGamepadSource * m_source;
+    GamepadLog *     m_recordLog; // Every frame's state is appended when set
+    GamepadState     m_state;
 
+public: // GameObjectComponent
     void Update (float dt) override {
         ref(dt);
-        m_gamepad.Update();
+
+        if (m_source)
+            m_source->NextState(&m_state);
+        else
+            m_state = GamepadState();
+
+        if (m_recordLog)
+            m_recordLog->Append(m_state);
     }
 
 public:
-    GocGamepad () : GameObjectComponent(GOC_TYPE_GAMEPAD)
+    GocGamepad () :
+        GameObjectComponent(s_typeId),
+        m_source(nullptr),
+        m_recordLog(nullptr)
     {}
 
-    bool  IsConnected () const                                                 { return m_gamepad.IsConnected(); }
-    bool  AreButtonsPressed (XInputGamepad::EButtonFlags buttonFlags) const    { return m_gamepad.AreButtonsPressed(buttonFlags); }
-    float GetAnalogValueAsFloat (XInputGamepad::EAnalogTypes analogType) const { return m_gamepad.GetAnalogValueAsFloat(analogType); }
-    float GetLeftStickXAsFloat () const                                        { return m_gamepad.GetLeftStickXAsFloat(); }
-    //float GetLeftStickYAsFloat () const;
-    //float GetLeftTriggerAsFloat () const;
-    //float GetRightStickXAsFloat () const;
-    //float GetRightStickYAsFloat () const;
-    //float GetRightTriggerAsFloat () const;
+    // Neither is owned; pass null to disconnect / stop recording.
+    void SetSource (IGamepadSource * source) { m_source = source; }
+    void SetRecordLog (GamepadLog * log)     { m_recordLog = log; }
+
+    const GamepadState & GetState () const { return m_state; }
+
+    bool  HasSource () const                                  { return m_source != nullptr; }
+    bool  AreButtonsPressed (std::uint16_t buttonFlags) const { return (m_state.buttons & buttonFlags) == buttonFlags; }
+    float GetLeftStickXAsFloat () const                       { return GamepadState::AxisToFloat(m_state.leftStickX); }
 };
 
 
 //==============================================================================
 class GocSprite : public GameObjectComponent {
+public:
+    static const GlobalTypeId s_typeId = GOC_TYPE_SPRITE;
+    static const unsigned     s_reads  = COMPONENT_DATA_NONE;
+    static const unsigned     s_writes = COMPONENT_DATA_SPRITE;
+
+private: // Types
+    struct AnimState {
+        unsigned animIndex;
+        unsigned frameIndex;
+        float    timeOnFrameSeconds;
+    };
+
+    // Sheet index for an interned name; misses are cached too.
+    struct AnimLookup {
+        std::uint32_t nameId;
+        unsigned      animIndex;
+    };
+
+public: // Constants
+    static const unsigned s_defaultBatchLayer = 1; // Over level tiles
+
 private:
-    SpriteAnimation m_sprite;
+    SpriteAnimation         m_sprite;
+    std::vector<AnimLookup> m_animLookups; // Valid for the current sheet only
+    unsigned                m_lookupReload; // SheetReloadCount() when m_animLookups was filled
+    unsigned                m_batchLayer;
+
+private: // Helpers
+    // Sheets are shared through g_graphicsMgr's cache, so a reload through
+    // any sprite can renumber the animations under every other sprite on the
+    // sheet.  Each reload bumps this, and lookups cached before it are
+    // dropped on their next use.
+    static unsigned & SheetReloadCount () {
+        static unsigned s_reloadCount = 0;
+        return s_reloadCount;
+    }
+
+    unsigned FindAnimIndex (const AnimName & name) {
+        if (m_lookupReload != SheetReloadCount()) {
+            m_animLookups.clear();
+            m_lookupReload = SheetReloadCount();
+        }
+
+        for (const AnimLookup & lookup : m_animLookups) {
+            if (lookup.nameId == name.id)
+                return lookup.animIndex;
+        }
+
+        const std::string narrow(name.text);
+        const AnimLookup  lookup = {
+            name.id,
+            m_sprite.GetSheet()->GetAnimationIndex(std::wstring(narrow.begin(), narrow.end()))
+        };
+        m_animLookups.push_back(lookup);
+        return lookup.animIndex;
+    }
 
 public:
-    GocSprite () : GameObjectComponent(GOC_TYPE_SPRITE)
+    GocSprite () :
+        GameObjectComponent(s_typeId),
+        m_lookupReload(SheetReloadCount()),
+        m_batchLayer(s_defaultBatchLayer)
     {}
 
-private:
+public: // GameObjectComponent
     void Render () override {
 
-        Mtx44 worldFromModelMtx;
-        m_owner->GetTransform().GetWorldFromModelMtx(&worldFromModelMtx);
-
-        m_sprite.Render(worldFromModelMtx);
+        // Batched sprites leave the world matrix to the batcher, which builds
+        // them a run at a time.
+        const Transform &        transform = m_owner->GetTransform();
+        const SpritesheetFrame * frame     = m_sprite.GetCurrentFrame();
+        if (SpriteBatcher * batcher = SpriteBatcher::GetActive()) {
+            if (frame)
+                batcher->Add(m_sprite.GetSheet(), m_batchLayer, transform.GetPosition().z, transform, *frame, &m_sprite);
+        }
+        else
+            m_sprite.Render(transform.GetWorldFromModelMtx());
 
     }
 
@@ -122,15 +253,66 @@ private:
         m_sprite.Update(dt);
     }
 
+    unsigned GetStateSize () const override { return sizeof(AnimState); }
+
+    void SaveState (void * state) const override {
+        AnimState anim;
+        anim.animIndex          = m_sprite.GetAnimationIndex();
+        anim.frameIndex         = m_sprite.GetFrameIndex();
+        anim.timeOnFrameSeconds = m_sprite.GetTimeOnFrameSeconds();
+        memcpy(state, &anim, sizeof(anim));
+    }
+
+    void LoadState (const void * state) override {
+        AnimState anim;
+        memcpy(&anim, state, sizeof(anim));
+        m_sprite.SetAnimIndex(anim.animIndex);
+        m_sprite.SetFrameIndex(anim.frameIndex);
+        m_sprite.SetTimeOnFrameSeconds(anim.timeOnFrameSeconds);
+    }
+
 public:
     // Commands
     bool BuildFromDatafile (const char * filepath)  {
         Spritesheet * sheet = g_graphicsMgr->LoadSpritesheet(filepath);
         m_sprite.SetSheet(sheet);
+        m_animLookups.clear();
         return sheet;
     }
 
-    bool RebuildFromDatafile ()      { return m_sprite.GetSheet()->RebuildFromDatafile(); }
+    // Invalidates the anim lookups of every GocSprite, not just this one.
+    bool RebuildFromDatafile () {
+        ++SheetReloadCount();
+        return m_sprite.GetSheet()->RebuildFromDatafile();
+    }
+
+    // Layer used when a SpriteBatcher is active; lower layers draw first.
+    void SetBatchLayer (unsigned layer) { m_batchLayer = layer; }
+
+    // Call after changing the sheet through GetSprite().
+    void ClearAnimLookups () { m_animLookups.clear(); }
+
+    bool TrySetAnim (const AnimName & name) {
+        const unsigned animIndex = FindAnimIndex(name);
+        if (animIndex >= unsigned(-1))
+            return false;
+
+        m_sprite.SetAnimIndex(animIndex);
+        return true;
+    }
+
+    bool TrySetAnim (const AnimName & name, unsigned frameIndexIfAnimChanges) {
+        const unsigned animIndex = FindAnimIndex(name);
+        if (animIndex >= unsigned(-1))
+            return false;
+
+        const unsigned oldIndex = m_sprite.GetAnimationIndex();
+        m_sprite.SetAnimIndex(animIndex);
+        if (oldIndex != animIndex)
+            SetFrameIndex(frameIndexIfAnimChanges);
+
+        return true;
+    }
 
     bool TrySetAnim (const std::wstring & name) {
         unsigned animIndex = m_sprite.GetSheet()->GetAnimationIndex(name);
@@ -158,10 +340,33 @@ public:
     }
 
     // Queries
+    bool IsAnim (const AnimName & name) {
+        const unsigned animIndex = FindAnimIndex(name);
+        return animIndex < unsigned(-1) && animIndex == m_sprite.GetAnimationIndex();
+    }
+
     const SpritesheetFrame * GetCurrentFrame () const    { return m_sprite.GetCurrentFrame(); }
     const SpriteAnimation &  GetSprite () const          { return m_sprite; }
     SpriteAnimation &        GetSprite ()                { return m_sprite; }
 
+    // World-space box under the current frame.  Uses the scale's magnitude so
+    // flipping the sprite doesn't move the box; rotation is ignored.
+    WorldRect GetWorldRect () const {
+        const SpritesheetFrame * frame = m_sprite.GetCurrentFrame();
+        ASSERT(frame);
+
+        const Transform & transform = m_owner->GetTransform();
+        const Vec3        pos       = transform.GetPosition();
+        const Vec3        scale     = transform.GetScale();
+        const WorldRect   rect      = {
+            pos.x,
+            pos.y - float(frame->height) * fabsf(scale.y),
+            pos.x + float(frame->width)  * fabsf(scale.x),
+            pos.y
+        };
+        return rect;
+    }
+
 };
 
 
@@ -207,54 +412,208 @@ private:
 
 //==============================================================================
 class GocLevel : public GameObjectComponent {
+public:
+    static const GlobalTypeId s_typeId = GOC_TYPE_LEVEL;
+    // Streaming follows the active camera relative to the level's transform.
+    // Binding the active LevelCollision writes process-wide state that every
+    // actor reads, so the level always updates alone.
+    static const unsigned     s_reads  = COMPONENT_DATA_TRANSFORM_POSITION | COMPONENT_DATA_CAMERA;
+    static const unsigned     s_writes = COMPONENT_DATA_LEVEL | COMPONENT_DATA_GLOBAL;
 
-    Level m_level;
+private:
+    Level          m_level;
+    LevelCollision m_collision;
+    std::string    m_datafilePath;
+    std::string    m_cookedPath;
 
+public: // GameObjectComponent
     void Update (float dt) override {
         m_level.Update(dt);
+
+        // Actors collide with the most recently updated level.
+        m_collision.Bind(m_level, m_owner->GetTransform());
+        if (m_collision.IsBound())
+            LevelCollision::SetActive(&m_collision);
+        else if (LevelCollision::GetActive() == &m_collision)
+            LevelCollision::SetActive(nullptr);
+
+        if (!m_level.IsStreaming())
+            return;
+
+        const GocCamera * camera = GocCamera::GetActiveCamera();
+        if (!camera) {
+            m_level.UpdateStreaming(m_owner->GetTransform(), nullptr);
+            return;
+        }
+
+        const WorldRect viewRect = camera->GetViewRect();
+        m_level.UpdateStreaming(m_owner->GetTransform(), &viewRect);
     }
 
     void Render () override {
-        m_level.Render(m_owner->GetTransform());
+        // Cull to the active camera's view when there is one.
+        const GocCamera * camera = GocCamera::GetActiveCamera();
+        if (!camera) {
+            m_level.Render(m_owner->GetTransform());
+            return;
+        }
+
+        const WorldRect viewRect = camera->GetViewRect();
+        m_level.Render(m_owner->GetTransform(), &viewRect);
     }
 
 public:
-    GocLevel () : GameObjectComponent(GOC_TYPE_LEVEL)
+    GocLevel () : GameObjectComponent(s_typeId)
     {}
 
+    ~GocLevel () {
+        if (LevelCollision::GetActive() == &m_collision)
+            LevelCollision::SetActive(nullptr);
+    }
+
+    // Loads the cooked version of a datafile, recooking it first if the
+    // datafile changed since.  A cooked file without its datafile is used as
+    // is; failing both, the datafile itself is loaded.
     bool LoadLevel (const char * filepath) {
+        m_datafilePath = filepath;
+        m_cookedPath   = LevelFile::GetCookedPath(filepath);
+
+        Level::CookDatafile(filepath, m_cookedPath.c_str());
+        if (m_level.BuildFromCookedFile(m_cookedPath.c_str()))
+            return true;
+
         return m_level.BuildFromDatafile(filepath);
     }
 
+    const LevelCollision & GetCollision () const { return m_collision; }
+
+    void StreamLevel (const char * filepath, const LevelStreamSettings & settings = LevelStreamSettings()) {
+        m_level.BeginStreamingFromDatafile(filepath, settings);
+    }
+
+    // Reloads from the datafile (the file being edited) and recooks it.  The
+    // level is rebuilt first so the old cooked file is no longer mapped.
     void Reload () {
-        m_level.Reload();
+        if (m_datafilePath.empty() || m_level.IsStreaming()) {
+            m_level.Reload();
+            return;
+        }
+
+        m_level.BuildFromDatafile(m_datafilePath.c_str());
+        Level::CookDatafile(m_datafilePath.c_str(), m_cookedPath.c_str());
     }
 
 };
 
 
+//==============================================================================
+// Keeps a Broadphase proxy over the object's sprite.  Only the proxy's own
+// slot is written, so objects may update in parallel; whoever owns the
+// Broadphase calls Rebuild() once they're done.
+class GocBroadphaseProxy : public GameObjectComponent {
+public:
+    static const GlobalTypeId s_typeId = GOC_TYPE_BROADPHASE;
+    static const unsigned     s_reads  =
+        COMPONENT_DATA_TRANSFORM_POSITION |
+        COMPONENT_DATA_TRANSFORM_SHAPE |
+        COMPONENT_DATA_SPRITE;
+    static const unsigned     s_writes = COMPONENT_DATA_BROADPHASE_PROXY;
+
+private:
+    Broadphase *        m_broadphase;
+    Broadphase::ProxyId m_proxy;
+    GocSprite *         m_spriteComp;
+
+private: // Helpers
+    WorldRect GetBounds () const {
+        if (m_spriteComp && m_spriteComp->GetCurrentFrame())
+            return m_spriteComp->GetWorldRect();
+
+        const Vec3      pos    = m_owner->GetTransform().GetPosition();
+        const WorldRect bounds = { pos.x, pos.y, pos.x, pos.y };
+        return bounds;
+    }
+
+public: // GameObjectComponent
+    void Update (float dt) override {
+        ref(dt);
+
+        if (m_broadphase)
+            m_broadphase->MoveProxy(m_proxy, GetBounds());
+    }
+
+    void OnSiblingsChanged () override {
+        m_spriteComp = m_owner->GetComponent<GocSprite>();
+    }
+
+public:
+    GocBroadphaseProxy () :
+        GameObjectComponent(s_typeId),
+        m_broadphase(nullptr),
+        m_proxy(Broadphase::s_invalidProxy),
+        m_spriteComp(nullptr)
+    {}
+
+    ~GocBroadphaseProxy () {
+        SetBroadphase(nullptr);
+    }
+
+    // Must be called with the component attached to its object; user data is
+    // the owning GameObject.
+    void SetBroadphase (Broadphase * broadphase) {
+        ASSERT(!broadphase || m_owner);
+        if (m_broadphase)
+            m_broadphase->DestroyProxy(m_proxy);
+
+        m_broadphase = broadphase;
+        m_proxy      = broadphase ? broadphase->CreateProxy(GetBounds(), m_owner) : Broadphase::s_invalidProxy;
+    }
+
+    Broadphase::ProxyId GetProxy () const { return m_proxy; }
+
+};
+
+
 //==============================================================================
 class GocTest : public GameObjectComponent {
+public:
+    static const GlobalTypeId s_typeId = GOC_TYPE_COMP_TEST;
+    // Hot reloading touches shared spritesheets and graphics resources.
+    static const unsigned     s_reads  = COMPONENT_DATA_GLOBAL;
+    static const unsigned     s_writes = COMPONENT_DATA_GLOBAL;
+
+private:
+    GocGamepad * m_gamepad;
+    GocSprite *  m_sprite;
+    GocLevel *   m_level;
 
+public: // GameObjectComponent
     void Update (float dt) override {
         ref(dt);
 
-        GocGamepad * gamepad = dynamic_cast<GocGamepad *>(m_owner->GetComponent(GOC_TYPE_GAMEPAD));
-        if (!gamepad || !gamepad->AreButtonsPressed(XInputGamepad::BUTTON_FLAG_START))
+        if (!m_gamepad || !m_gamepad->AreButtonsPressed(GamepadState::BUTTON_START))
             return;
 
-        GocSprite * sprite = dynamic_cast<GocSprite *>(m_owner->GetComponent(GOC_TYPE_SPRITE));
-        if (sprite)
-            sprite->RebuildFromDatafile();
+        if (m_sprite)
+            m_sprite->RebuildFromDatafile();
+
+        if (m_level)
+            m_level->Reload();
 
-        GocLevel * level = dynamic_cast<GocLevel *>(m_owner->GetComponent(GOC_TYPE_LEVEL));
-        if (level)
-            level->Reload();
+    }
 
+    void OnSiblingsChanged () override {
+        m_gamepad = m_owner->GetComponent<GocGamepad>();
+        m_sprite  = m_owner->GetComponent<GocSprite>();
+        m_level   = m_owner->GetComponent<GocLevel>();
     }
 
 public:
-    GocTest () : GameObjectComponent(GOC_TYPE_COMP_TEST)
+    GocTest () :
+        GameObjectComponent(s_typeId),
+        m_gamepad(nullptr),
+        m_sprite(nullptr),
+        m_level(nullptr)
     {}
 
 };
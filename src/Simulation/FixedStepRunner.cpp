@@ -0,0 +1,91 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Christopher Higgins Barrett
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "FixedStepRunner.h"
+
+//==============================================================================
+FixedStepRunner::FixedStepRunner (ISimulation * simulation, float stepSeconds, unsigned maxStepsPerAdvance) :
+    m_simulation(simulation),
+    m_stepSeconds(stepSeconds),
+    m_maxStepsPerAdvance(maxStepsPerAdvance),
+    m_accumulator(0.0),
+    m_secondsPerCount(1.0 / double(Core::GetPerformanceFrequency()))
+{
+    ASSERT(m_stepSeconds > 0.0f);
+}
+
+//==============================================================================
+unsigned FixedStepRunner::Advance (float elapsedSeconds) {
+
+    if (elapsedSeconds > 0.0f)
+        m_accumulator += elapsedSeconds;
+    m_stats.wallSeconds += elapsedSeconds;
+
+    unsigned steps = 0;
+    while (m_accumulator >= m_stepSeconds) {
+        if (m_maxStepsPerAdvance && steps >= m_maxStepsPerAdvance) {
+            // Too far behind; drop whole steps but keep the fractional part so
+            // interpolation stays smooth.
+            const unsigned dropped = unsigned(m_accumulator / m_stepSeconds);
+            m_stats.droppedSteps += dropped;
+            m_accumulator        -= dropped * double(m_stepSeconds);
+            break;
+        }
+
+        StepOnce();
+        m_accumulator -= m_stepSeconds;
+        ++steps;
+    }
+
+    return steps;
+
+}
+
+//==============================================================================
+void FixedStepRunner::RunSteps (unsigned stepCount) {
+
+    const std::uint64_t startCount = Core::GetPerformanceCounter();
+
+    for (unsigned i = 0; i < stepCount; ++i)
+        StepOnce();
+
+    m_stats.wallSeconds += (Core::GetPerformanceCounter() - startCount) * m_secondsPerCount;
+
+}
+
+//==============================================================================
+void FixedStepRunner::StepOnce () {
+
+    ASSERT(m_simulation);
+
+    const std::uint64_t startCount = Core::GetPerformanceCounter();
+    m_simulation->Step(m_stepSeconds);
+    const double stepSeconds = (Core::GetPerformanceCounter() - startCount) * m_secondsPerCount;
+
+    ++m_stats.steps;
+    m_stats.updateSeconds += stepSeconds;
+    if (stepSeconds > m_stats.maxStepSeconds)
+        m_stats.maxStepSeconds = stepSeconds;
+
+}
@@ -0,0 +1,95 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Christopher Higgins Barrett
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+class GameObject;
+
+//==============================================================================
+// Anything that can be advanced by a fixed amount of simulated time.
+class ISimulation {
+public:
+    virtual ~ISimulation () {}
+
+    virtual void Step (float dt) = 0;
+};
+
+
+//==============================================================================
+struct FixedStepStats {
+    unsigned steps;          // Fixed steps simulated
+    unsigned droppedSteps;   // Steps discarded by the catch-up clamp
+    double   updateSeconds;  // Wall time spent inside ISimulation::Step
+    double   maxStepSeconds; // Worst single step
+    double   wallSeconds;    // Wall time covered by Advance/RunSteps calls
+
+    FixedStepStats () :
+        steps(0),
+        droppedSteps(0),
+        updateSeconds(0.0),
+        maxStepSeconds(0.0),
+        wallSeconds(0.0)
+    {}
+
+    double StepsPerSecond () const { return wallSeconds > 0.0 ? steps / wallSeconds : 0.0; }
+    double AvgStepMs () const      { return steps ? updateSeconds * 1000.0 / steps : 0.0; }
+    double MaxStepMs () const      { return maxStepSeconds * 1000.0; }
+};
+
+
+//==============================================================================
+// Drives an ISimulation at a fixed timestep.  Real elapsed time is fed through
+// an accumulator; when the simulation falls behind, at most
+// m_maxStepsPerAdvance steps are taken and the remainder is dropped so a slow
+// frame can't snowball.  Needs no window or graphics device, so it can run
+// headless for soak and throughput testing.
+class FixedStepRunner {
+private: // Data
+    ISimulation *  m_simulation;
+    float          m_stepSeconds;
+    unsigned       m_maxStepsPerAdvance;
+    double         m_accumulator;
+    double         m_secondsPerCount;
+    FixedStepStats m_stats;
+
+private: // Helpers
+    void StepOnce ();
+
+public:
+    FixedStepRunner (ISimulation * simulation, float stepSeconds = 1.0f / 60.0f, unsigned maxStepsPerAdvance = 5);
+
+    // Commands
+    unsigned Advance (float elapsedSeconds); // Returns number of steps taken
+    void     RunSteps (unsigned stepCount);  // As fast as possible, ignoring real time
+    void     ResetStats ()                   { m_stats = FixedStepStats(); }
+
+    void SetSimulation (ISimulation * simulation)        { m_simulation = simulation; }
+    void SetStepSeconds (float stepSeconds)              { m_stepSeconds = stepSeconds; }
+    void SetMaxStepsPerAdvance (unsigned maxSteps)       { m_maxStepsPerAdvance = maxSteps; }
+
+    // Queries
+    float                  GetStepSeconds () const        { return m_stepSeconds; }
+    float                  GetInterpolationAlpha () const { return float(m_accumulator / m_stepSeconds); }
+    const FixedStepStats & GetStats () const              { return m_stats; }
+};
@@ -0,0 +1,69 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Christopher Higgins Barrett
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "GameObjectSimulation.h"
+#include "../GameObject.h"
+#include "../Components/ComponentStore.h"
+#include "../Jobs/JobSystem.h"
+
+#include <algorithm>
+
+//==============================================================================
+void GameObjectSimulation::AddObject (GameObject * object) {
+
+    ASSERT(object);
+    m_objects.push_back(object);
+
+}
+
+//==============================================================================
+void GameObjectSimulation::RemoveObject (GameObject * object) {
+
+    m_objects.erase(std::remove(m_objects.begin(), m_objects.end(), object), m_objects.end());
+
+}
+
+//==============================================================================
+void GameObjectSimulation::Step (float dt) {
+
+    if (m_jobSystem) {
+        GameObject ** objects = m_objects.data();
+        auto updateRange = [objects, dt](unsigned begin, unsigned end) {
+            for (unsigned i = begin; i < end; ++i)
+                objects[i]->Update(dt);
+        };
+        m_jobSystem->ParallelFor(unsigned(m_objects.size()), m_objectsPerBatch, updateRange);
+
+        if (m_componentStore)
+            m_componentStore->UpdateParallel(*m_jobSystem, dt);
+        return;
+    }
+
+    for (GameObject * object : m_objects)
+        object->Update(dt);
+
+    if (m_componentStore)
+        m_componentStore->UpdateAll(dt);
+
+}
@@ -0,0 +1,68 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Christopher Higgins Barrett
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include "FixedStepRunner.h"
+
+class ComponentStore;
+class JobSystem;
+
+//==============================================================================
+// Ticks a set of GameObjects in order, then any pooled components.  Objects,
+// the store and the job system aren't owned and must outlive their
+// registration.
+//
+// With a JobSystem set, objects are updated in parallel batches.  That's only
+// valid while each object's unpooled components touch nothing but their own
+// object; anything that touches shared state should be pooled so the store can
+// schedule it by its declared access.
+class GameObjectSimulation : public ISimulation {
+private: // Data
+    std::vector<GameObject *> m_objects;
+    ComponentStore *          m_componentStore;
+    JobSystem *               m_jobSystem;
+    unsigned                  m_objectsPerBatch;
+
+public:
+    GameObjectSimulation () :
+        m_componentStore(nullptr),
+        m_jobSystem(nullptr),
+        m_objectsPerBatch(64)
+    {}
+
+    // Commands
+    void AddObject (GameObject * object);
+    void RemoveObject (GameObject * object);
+    void RemoveAllObjects ()                   { m_objects.clear(); }
+    void SetComponentStore (ComponentStore * store) { m_componentStore = store; }
+    void SetJobSystem (JobSystem * jobs)            { m_jobSystem = jobs; }
+    void SetObjectsPerBatch (unsigned count)        { m_objectsPerBatch = count ? count : 1; }
+
+    void Step (float dt) override;
+
+    // Queries
+    unsigned     GetObjectCount () const       { return unsigned(m_objects.size()); }
+    GameObject * GetObject (unsigned index)    { return m_objects[index]; }
+};
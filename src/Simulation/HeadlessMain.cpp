@@ -0,0 +1,410 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Christopher Higgins Barrett
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+// Headless entry point for soak and throughput runs on POSIX build boxes.  No
+// window or graphics device is created; GameObjects are ticked through a
+// FixedStepRunner as fast as the CPU allows.
+//
+//   usage: <exe> [-objects N] [-steps N] [-hz N] [-report N] [-pooled 0|1] [-jobs workerCount] [-sprites sheetCount]
+//                [-particles lifetimeSteps] [-synthetic seed | -replay file] [-record file] [-rollback frames]
+//
+// With -sprites, every report also times one frame of render prep (collect,
+// sort, pack, submit to a counting backend) over the objects, spread across
+// that many sheets.
+//
+// With -particles, every object also emits one particle per step into a
+// shared CPagedObjectCollection, and despawns each one lifetimeSteps steps
+// later.  With -jobs those spawns and despawns come from every worker at once.
+//
+// With -synthetic (a non-zero seed) or -replay, the objects are AGAM players
+// instead: GocGamepad, GocSprite, GocAgamBody, GocJumpMan and GocLeverDashMan,
+// always pooled, with every gamepad fed seeded synthetic play or the replayed
+// log.  -record saves the first object's input to replay later.  Each report
+// then also prints a hash of every body's state; runs that agree on it moved
+// identically.
+//
+// With -rollback, every step also captures a WorldSnapshot of the objects
+// into a SnapshotRing holding that many frames, as a rollback netcode loop
+// would, and each report prints the snapshot size and capture cost.
+//
+// Built by CMakeLists.txt at the repository root, not the Windows project.
+
+#include "FixedStepRunner.h"
+#include "GameObjectSimulation.h"
+#include "WorldSnapshot.h"
+#include "../GameObject.h"
+#include "../GameObjectComponent.h"
+#include "../Collections/PagedObjectCollection.h"
+#include "../Components/ComponentStore.h"
+#include "../Headless/HeadlessAgam.h"
+#include "../Jobs/JobSystem.h"
+#include "../Render/RenderBackend.h"
+#include "../ScratchComponents.h"
+#include "../ActionGameAlgorithmManiaxComponents.h"
+
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <cstdlib>
+
+namespace {
+
+//==============================================================================
+// Stand-in load: ballistic motion with a floor bounce, touching the Transform
+// the same way the gameplay controllers do.
+class GocSoakMover final : public GameObjectComponent {
+public:
+    static const unsigned s_reads  = COMPONENT_DATA_NONE;
+    static const unsigned s_writes = COMPONENT_DATA_TRANSFORM_POSITION | COMPONENT_DATA_TRANSFORM_VELOCITY;
+
+    GocSoakMover () : GameObjectComponent(0xFFFF, 1)
+    {}
+
+    void Update (float dt) override {
+        Transform & transform = m_owner->GetTransform();
+        Vec3        pos       = transform.GetPosition();
+        Vec3        vel       = transform.GetVelocity();
+
+        vel.y -= 6.0f * dt;
+        pos.x += vel.x;
+        pos.y += vel.y;
+        if (pos.y < 0.0f) {
+            pos.y = 0.0f;
+            vel.y = -vel.y * 0.9f;
+        }
+
+        transform.SetPosition(pos);
+        transform.SetVelocity(vel);
+    }
+};
+
+//==============================================================================
+struct SoakParticle {
+    float x;
+    float y;
+    float velY;
+};
+
+typedef CSaru::CPagedObjectCollection<SoakParticle, 4096> SoakParticleCollection;
+
+//==============================================================================
+// Spawner burst stand-in.  Each emitter keeps a ring of handles to its live
+// particles: every step it despawns the oldest, spawns a new one at its owner
+// and moves the rest.  The collection is safe to share across workers, so it
+// isn't declared as component data.
+class GocSoakEmitter final : public GameObjectComponent {
+public:
+    static const unsigned s_reads  = COMPONENT_DATA_TRANSFORM_POSITION;
+    static const unsigned s_writes = COMPONENT_DATA_NONE;
+
+private: // Types
+    typedef CSaru::IObjectCollection::Handle Handle;
+
+private: // Data
+    SoakParticleCollection * m_particles;
+    std::vector<Handle>      m_live;
+    unsigned                 m_next;
+
+public:
+    GocSoakEmitter (SoakParticleCollection * particles, unsigned lifetimeSteps) :
+        GameObjectComponent(0xFFFF, 2),
+        m_particles(particles),
+        m_live(lifetimeSteps ? lifetimeSteps : 1),
+        m_next(0)
+    {}
+
+    ~GocSoakEmitter () {
+        for (const Handle & handle : m_live)
+            m_particles->Remove(handle);
+    }
+
+    void Update (float dt) override {
+        m_particles->Remove(m_live[m_next]);
+
+        SoakParticle * particle = new SoakParticle;
+        particle->x    = m_owner->GetTransform().GetPosition().x;
+        particle->y    = m_owner->GetTransform().GetPosition().y;
+        particle->velY = 0.0f;
+        m_live[m_next] = m_particles->Add(particle);
+        m_next         = (m_next + 1) % unsigned(m_live.size());
+
+        for (const Handle & handle : m_live) {
+            if (SoakParticle * live = m_particles->Get(handle)) {
+                live->velY -= 6.0f * dt;
+                live->y    += live->velY;
+            }
+        }
+    }
+};
+
+//==============================================================================
+// Steps the wrapped simulation, then captures the world into a ring.
+class RollbackRecorder final : public ISimulation {
+private: // Data
+    ISimulation *             m_simulation;
+    std::vector<GameObject *> m_objects;
+    WorldSnapshot             m_snapshot;
+    SnapshotRing              m_ring;
+    unsigned                  m_frame;
+    std::uint64_t             m_captureCounts;
+
+public:
+    RollbackRecorder (ISimulation * simulation, std::vector<GameObject> * objects, unsigned frames) :
+        m_simulation(simulation),
+        m_ring(frames),
+        m_frame(0),
+        m_captureCounts(0)
+    {
+        for (GameObject & object : *objects)
+            m_objects.push_back(&object);
+    }
+
+    void Step (float dt) override {
+        m_simulation->Step(dt);
+
+        const std::uint64_t startCount = Core::GetPerformanceCounter();
+        m_snapshot.Capture(m_objects.data(), unsigned(m_objects.size()), nullptr);
+        m_ring.Push(m_snapshot, ++m_frame);
+        m_captureCounts += Core::GetPerformanceCounter() - startCount;
+    }
+
+    const SnapshotRing & GetRing () const          { return m_ring; }
+    unsigned             GetSnapshotBytes () const { return m_snapshot.GetByteSize(); }
+    double               AvgCaptureMs () const {
+        return m_frame ? double(m_captureCounts) * 1000.0 / double(Core::GetPerformanceFrequency()) / m_frame : 0.0;
+    }
+};
+
+//==============================================================================
+unsigned HashAgamBodies (std::vector<GameObject> & objects) {
+
+    unsigned hash = 2166136261u;
+    for (GameObject & object : objects) {
+        const GocAgamBody * body = object.GetComponent<GocAgamBody>();
+        hash = (hash ^ (body ? body->GetStateHash() : 0)) * 16777619u;
+    }
+
+    return hash;
+
+}
+
+//==============================================================================
+unsigned ReadArg (int argc, char ** argv, const char * name, unsigned defaultValue) {
+
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (!strcmp(argv[i], name))
+            return unsigned(strtoul(argv[i + 1], nullptr, 10));
+    }
+
+    return defaultValue;
+
+}
+
+//==============================================================================
+const char * ReadStringArg (int argc, char ** argv, const char * name) {
+
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (!strcmp(argv[i], name))
+            return argv[i + 1];
+    }
+
+    return nullptr;
+
+}
+
+} // namespace
+
+//==============================================================================
+int main (int argc, char ** argv) {
+
+    const unsigned objectCount = ReadArg(argc, argv, "-objects", 10000);
+    const unsigned stepCount   = ReadArg(argc, argv, "-steps",   10000);
+    const unsigned hz          = ReadArg(argc, argv, "-hz",      60);
+    const unsigned reportEvery = ReadArg(argc, argv, "-report",  0);
+    const bool     pooled      = ReadArg(argc, argv, "-pooled",  0) != 0;
+    const unsigned workerCount = ReadArg(argc, argv, "-jobs",    0);
+    const unsigned sheetCount  = ReadArg(argc, argv, "-sprites", 0);
+    const unsigned lifetime    = ReadArg(argc, argv, "-particles", 0);
+    const unsigned seed        = ReadArg(argc, argv, "-synthetic", 0);
+    const char *   replayPath  = ReadStringArg(argc, argv, "-replay");
+    const char *   recordPath  = ReadStringArg(argc, argv, "-record");
+    const unsigned rollback    = ReadArg(argc, argv, "-rollback", 0);
+    const bool     agam        = seed || replayPath;
+    const bool     usePools    = pooled || agam;
+
+    if (!objectCount || !hz)
+        return 1;
+
+    GamepadLog replayLog;
+    GamepadLog recordLog;
+    if (replayPath && !replayLog.Load(replayPath)) {
+        fprintf(stderr, "Can't load gamepad log %s\n", replayPath);
+        return 1;
+    }
+
+    Spritesheet agamSheet;
+    if (agam)
+        BuildAgamSheet(&agamSheet);
+
+    std::vector<std::unique_ptr<IGamepadSource>> gamepadSources;
+    std::vector<GameObject>                      objects(objectCount);
+    std::vector<GocSoakMover>                    movers;
+    SoakParticleCollection                       particles;
+    std::vector<GocSoakEmitter>                  emitters;
+    ComponentStore                               store;
+    GameObjectSimulation                         simulation;
+
+    std::unique_ptr<JobSystem> jobs;
+    if (workerCount) {
+        jobs.reset(new JobSystem(workerCount));
+        simulation.SetJobSystem(jobs.get());
+    }
+
+    if (usePools) {
+        if (agam)
+            RegisterAgamPools(&store);
+        else
+            store.RegisterPool<GocSoakMover>();
+        if (lifetime)
+            store.RegisterPool<GocSoakEmitter>();
+        simulation.SetComponentStore(&store);
+    }
+    else {
+        movers.resize(objectCount);
+        if (lifetime)
+            emitters.resize(objectCount, GocSoakEmitter(&particles, lifetime));
+    }
+
+    for (unsigned i = 0; i < objectCount; ++i) {
+        if (agam) {
+            if (replayPath)
+                gamepadSources.emplace_back(new GamepadReplaySource(&replayLog));
+            else
+                gamepadSources.emplace_back(new SyntheticGamepadSource(seed + i));
+
+            GocGamepad * gamepad = CreateAgamPlayer(&store, &objects[i], &agamSheet, gamepadSources.back().get());
+            if (recordPath && !i)
+                gamepad->SetRecordLog(&recordLog);
+            if (lifetime)
+                store.Create<GocSoakEmitter>(&objects[i], &particles, lifetime);
+        }
+        else if (pooled) {
+            store.Create<GocSoakMover>(&objects[i]);
+            if (lifetime)
+                store.Create<GocSoakEmitter>(&objects[i], &particles, lifetime);
+        }
+        else {
+            objects[i].AddComponent(&movers[i]);
+            if (lifetime)
+                objects[i].AddComponent(&emitters[i]);
+        }
+        objects[i].GetTransform().SetPosition(Vec3(float(i % 1000), float(i % 97) * 4.0f, 0.0f));
+        objects[i].GetTransform().SetVelocity(float(i % 7) * 0.25f - 0.75f, 0.0f);
+        // Pooled components are ticked by the store; the objects have
+        // nothing else to update.
+        if (!usePools)
+            simulation.AddObject(&objects[i]);
+    }
+
+    std::unique_ptr<RollbackRecorder> recorder;
+    if (rollback)
+        recorder.reset(new RollbackRecorder(&simulation, &objects, rollback));
+
+    FixedStepRunner runner(recorder ? static_cast<ISimulation *>(recorder.get()) : &simulation, 1.0f / float(hz));
+
+    // Sheets are only compared by address, so any distinct pointers will do.
+    SpriteBatcher         batcher;
+    CountingRenderBackend backend;
+    std::vector<char>     fakeSheets(sheetCount);
+    SpritesheetFrame  spriteFrame = SpritesheetFrame();
+    spriteFrame.width  = 16;
+    spriteFrame.height = 16;
+
+    unsigned remaining = stepCount;
+    while (remaining) {
+        const unsigned batch = reportEvery ? MIN(reportEvery, remaining) : remaining;
+        runner.RunSteps(batch);
+        remaining -= batch;
+
+        const FixedStepStats & stats = runner.GetStats();
+        printf(
+            "steps %u  objects %u%s  workers %u  %.1f steps/s  avg %.4f ms  max %.4f ms\n",
+            stats.steps,
+            objectCount,
+            usePools ? " (pooled)" : "",
+            jobs ? jobs->GetWorkerCount() : 0,
+            stats.StepsPerSecond(),
+            stats.AvgStepMs(),
+            stats.MaxStepMs()
+        );
+
+        if (lifetime)
+            printf("  particles %u  capacity %u\n", particles.Count(), particles.Capacity());
+
+        if (agam)
+            printf("  agam state %08x\n", HashAgamBodies(objects));
+
+        if (recorder) {
+            printf(
+                "  rollback frames %u  snapshot %u bytes  capture %.4f ms\n",
+                recorder->GetRing().GetFrameCount(),
+                recorder->GetSnapshotBytes(),
+                recorder->AvgCaptureMs()
+            );
+        }
+
+        if (sheetCount) {
+            const std::uint64_t startCount = Core::GetPerformanceCounter();
+
+            // Depth by height, as a top-down game would order its sprites.
+            batcher.Begin();
+            for (unsigned i = 0; i < objectCount; ++i) {
+                const Spritesheet * sheet     = reinterpret_cast<const Spritesheet *>(&fakeSheets[i % sheetCount]);
+                const Transform &   transform = objects[i].GetTransform();
+                batcher.Add(sheet, i & 1, -transform.GetPosition().y, transform, spriteFrame);
+            }
+            backend.BeginFrame();
+            batcher.Submit(&backend);
+            backend.EndFrame();
+
+            const double prepMs = double(Core::GetPerformanceCounter() - startCount) * 1000.0 / double(Core::GetPerformanceFrequency());
+            printf(
+                "  sprites %u  sheet binds %u  batches %u  upload %u KB  render prep %.4f ms\n",
+                backend.GetLastFrame().instances,
+                backend.GetLastFrame().sheetBinds,
+                backend.GetLastFrame().batches,
+                unsigned(backend.GetLastFrame().uploadBytes / 1024),
+                prepMs
+            );
+        }
+    }
+
+    if (recordPath && !recordLog.Save(recordPath)) {
+        fprintf(stderr, "Can't save gamepad log %s\n", recordPath);
+        return 1;
+    }
+
+    return 0;
+
+}
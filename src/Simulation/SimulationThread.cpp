@@ -0,0 +1,101 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Christopher Higgins Barrett
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "SimulationThread.h"
+#include "../Render/RenderSnapshot.h"
+
+#include <chrono>
+
+//==============================================================================
+SimulationThread::SimulationThread (ISimulation * simulation, IRenderRecorder * recorder, RenderSnapshotExchange * exchange, float stepSeconds) :
+    m_runner(simulation, stepSeconds),
+    m_recorder(recorder),
+    m_exchange(exchange),
+    m_quit(false),
+    m_tick(0)
+{
+    ASSERT(recorder);
+    ASSERT(exchange);
+}
+
+//==============================================================================
+SimulationThread::~SimulationThread () {
+    Stop();
+}
+
+//==============================================================================
+void SimulationThread::Start () {
+
+    if (IsRunning())
+        return;
+
+    m_quit   = false;
+    m_thread = std::thread(&SimulationThread::ThreadMain, this);
+
+}
+
+//==============================================================================
+void SimulationThread::Stop () {
+
+    if (!IsRunning())
+        return;
+
+    m_quit = true;
+    m_thread.join();
+
+}
+
+//==============================================================================
+void SimulationThread::PublishSnapshot () {
+
+    m_recorder->RecordRender(m_tick, &m_exchange->GetWriteSlot());
+    m_exchange->Publish();
+
+}
+
+//==============================================================================
+void SimulationThread::ThreadMain () {
+
+    const double secondsPerCount = 1.0 / double(Core::GetPerformanceFrequency());
+
+    // Something to draw before the first step lands.
+    PublishSnapshot();
+
+    std::uint64_t lastCount = Core::GetPerformanceCounter();
+    while (!m_quit) {
+        const std::uint64_t nowCount = Core::GetPerformanceCounter();
+        const unsigned      steps    = m_runner.Advance(float(double(nowCount - lastCount) * secondsPerCount));
+        lastCount = nowCount;
+
+        if (steps) {
+            m_tick += steps;
+            PublishSnapshot();
+        }
+        else {
+            // Nothing due yet; sleep off part of the wait rather than spin.
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+}
@@ -0,0 +1,78 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Christopher Higgins Barrett
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include "FixedStepRunner.h"
+
+#include <atomic>
+#include <thread>
+
+class RenderSnapshot;
+class RenderSnapshotExchange;
+
+//==============================================================================
+// Describes the simulation's current look.  Called on the simulation thread
+// between steps, so it may read simulation state freely.
+class IRenderRecorder {
+public:
+    virtual ~IRenderRecorder () {}
+
+    virtual void RecordRender (unsigned tick, RenderSnapshot * snapshotOut) = 0;
+};
+
+
+//==============================================================================
+// Runs an ISimulation at a fixed step on its own thread, publishing a render
+// snapshot after every advance that stepped.  The render thread picks the
+// newest one up through the exchange, so neither side waits on the other and
+// a slow frame on one side doesn't stall the other.
+//
+// Between Start and Stop the simulation, the recorder and everything they
+// touch belong to the simulation thread.
+class SimulationThread {
+private: // Data
+    FixedStepRunner          m_runner;
+    IRenderRecorder *        m_recorder;
+    RenderSnapshotExchange * m_exchange;
+    std::thread              m_thread;
+    std::atomic<bool>        m_quit;
+    unsigned                 m_tick;
+
+private: // Helpers
+    void ThreadMain ();
+    void PublishSnapshot ();
+
+public:
+    SimulationThread (ISimulation * simulation, IRenderRecorder * recorder, RenderSnapshotExchange * exchange, float stepSeconds = 1.0f / 60.0f);
+    ~SimulationThread ();
+
+    // Commands
+    void Start ();
+    void Stop (); // Waits for the step in progress to finish
+
+    // Queries
+    bool     IsRunning () const { return m_thread.joinable(); }
+    unsigned GetTick () const   { return m_tick; } // Only meaningful while stopped
+};
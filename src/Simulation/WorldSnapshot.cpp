@@ -0,0 +1,301 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Christopher Higgins Barrett
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "WorldSnapshot.h"
+#include "../GameObject.h"
+#include "../Levels/Level.hpp"
+
+#include <cstring>
+
+namespace {
+
+// Header words: object count, whether there's a level, its edit sequence.
+const unsigned s_headerWords = 3;
+
+//==============================================================================
+unsigned GetStateByteSize (GameObject * const * objects, unsigned count) {
+
+    unsigned size = s_headerWords * sizeof(std::uint32_t);
+    for (unsigned i = 0; i < count; ++i)
+        size += objects[i]->GetStateSize();
+
+    return size;
+
+}
+
+//==============================================================================
+void WriteVarint (unsigned value, std::vector<unsigned char> * bytesOut) {
+
+    while (value >= 0x80) {
+        bytesOut->push_back((unsigned char)(value | 0x80));
+        value >>= 7;
+    }
+    bytesOut->push_back((unsigned char)value);
+
+}
+
+//==============================================================================
+unsigned ReadVarint (const unsigned char ** cursorInOut, const unsigned char * end) {
+
+    unsigned value = 0;
+    for (unsigned shift = 0; *cursorInOut < end; shift += 7) {
+        const unsigned char byte = *(*cursorInOut)++;
+        value |= unsigned(byte & 0x7f) << shift;
+        if (!(byte & 0x80))
+            break;
+    }
+
+    return value;
+
+}
+
+} // namespace
+
+//==============================================================================
+void WorldSnapshot::Capture (GameObject * const * objects, unsigned count, const Level * level) {
+
+    m_byteSize = GetStateByteSize(objects, count);
+    m_words.resize((m_byteSize + sizeof(std::uint32_t) - 1) / sizeof(std::uint32_t));
+    m_words.back() = 0; // Padding past m_byteSize must compare equal between snapshots
+
+    m_words[0] = count;
+    m_words[1] = level != nullptr;
+    m_words[2] = level ? level->GetEditSequence() : 0;
+
+    unsigned char * state = reinterpret_cast<unsigned char *>(m_words.data() + s_headerWords);
+    for (unsigned i = 0; i < count; ++i) {
+        objects[i]->SaveState(state);
+        state += objects[i]->GetStateSize();
+    }
+
+}
+
+//==============================================================================
+bool WorldSnapshot::Restore (GameObject * const * objects, unsigned count, Level * level) const {
+
+    if (m_words.size() < s_headerWords || m_words[0] != count || GetStateByteSize(objects, count) != m_byteSize)
+        return false;
+
+    if (m_words[1]) {
+        const unsigned editSequence = m_words[2];
+        if (!level || editSequence > level->GetEditSequence() || editSequence < level->GetOldestEditSequence())
+            return false;
+
+        level->RevertEditsTo(editSequence);
+    }
+
+    const unsigned char * state = reinterpret_cast<const unsigned char *>(m_words.data() + s_headerWords);
+    for (unsigned i = 0; i < count; ++i) {
+        objects[i]->LoadState(state);
+        state += objects[i]->GetStateSize();
+    }
+
+    return true;
+
+}
+
+//==============================================================================
+void WorldSnapshot::CopyFrom (const WorldSnapshot & other) {
+
+    m_words.assign(other.m_words.begin(), other.m_words.end());
+    m_byteSize = other.m_byteSize;
+
+}
+
+//==============================================================================
+bool WorldSnapshot::HasLevel () const {
+    return m_words.size() >= s_headerWords && m_words[1] != 0;
+}
+
+//==============================================================================
+unsigned WorldSnapshot::GetEditSequence () const {
+    return HasLevel() ? m_words[2] : 0;
+}
+
+//==============================================================================
+void SnapshotDelta::Encode (const WorldSnapshot & from, const WorldSnapshot & to, std::vector<unsigned char> * deltaOut) {
+
+    ASSERT(from.GetWordCount() == to.GetWordCount());
+
+    deltaOut->clear();
+
+    const std::uint32_t * a         = from.GetWords();
+    const std::uint32_t * b         = to.GetWords();
+    const unsigned        wordCount = from.GetWordCount();
+    unsigned              i         = 0;
+    while (i < wordCount) {
+        const unsigned zeroBegin = i;
+        while (i < wordCount && a[i] == b[i])
+            ++i;
+
+        const unsigned literalBegin = i;
+        while (i < wordCount && a[i] != b[i])
+            ++i;
+
+        WriteVarint(literalBegin - zeroBegin, deltaOut);
+        WriteVarint(i - literalBegin, deltaOut);
+        for (unsigned j = literalBegin; j < i; ++j) {
+            const std::uint32_t word = a[j] ^ b[j];
+            deltaOut->push_back((unsigned char)(word));
+            deltaOut->push_back((unsigned char)(word >> 8));
+            deltaOut->push_back((unsigned char)(word >> 16));
+            deltaOut->push_back((unsigned char)(word >> 24));
+        }
+    }
+
+}
+
+//==============================================================================
+void SnapshotDelta::Apply (const std::vector<unsigned char> & delta, WorldSnapshot * snapshotInOut) {
+
+    std::uint32_t *       words     = snapshotInOut->GetWords();
+    const unsigned        wordCount = snapshotInOut->GetWordCount();
+    const unsigned char * cursor    = delta.data();
+    const unsigned char * end       = cursor + delta.size();
+    unsigned              i         = 0;
+    while (cursor < end) {
+        i += ReadVarint(&cursor, end);
+
+        const unsigned literalCount = ReadVarint(&cursor, end);
+        ASSERT(i + literalCount <= wordCount && cursor + literalCount * 4 <= end);
+        if (i + literalCount > wordCount || cursor + literalCount * 4 > end)
+            return;
+
+        for (unsigned j = 0; j < literalCount; ++j, ++i, cursor += 4)
+            words[i] ^= std::uint32_t(cursor[0]) | std::uint32_t(cursor[1]) << 8 | std::uint32_t(cursor[2]) << 16 | std::uint32_t(cursor[3]) << 24;
+    }
+
+}
+
+//==============================================================================
+SnapshotRing::SnapshotRing (unsigned capacity) :
+    m_older(capacity > 1 ? capacity - 1 : 0),
+    m_nextOlder(0),
+    m_olderCount(0),
+    m_newestFrame(0),
+    m_hasNewest(false)
+{}
+
+//==============================================================================
+// Slot of the frame framesBack + 1 pushes before the newest.
+unsigned SnapshotRing::OlderSlot (unsigned framesBack) const {
+
+    const unsigned size = unsigned(m_older.size());
+    return (m_nextOlder + size - 1 - framesBack) % size;
+
+}
+
+//==============================================================================
+void SnapshotRing::Push (const WorldSnapshot & snapshot, unsigned frame, Level * level) {
+
+    if (m_hasNewest && !m_older.empty() && snapshot.GetByteSize() == m_newest.GetByteSize()) {
+        OlderFrame & older = m_older[m_nextOlder];
+        SnapshotDelta::Encode(snapshot, m_newest, &older.delta);
+        older.frame        = m_newestFrame;
+        older.editSequence = m_newest.GetEditSequence();
+        m_nextOlder        = (m_nextOlder + 1) % unsigned(m_older.size());
+        m_olderCount       = MIN(m_olderCount + 1, unsigned(m_older.size()));
+    }
+    else {
+        m_olderCount = 0;
+    }
+
+    m_newest.CopyFrom(snapshot);
+    m_newestFrame = frame;
+    m_hasNewest   = true;
+
+    // Edit sequences only grow between rewinds, so the oldest frame's is the
+    // lowest any held frame can revert to.
+    if (level && snapshot.HasLevel())
+        level->DiscardEditsBefore(GetOldestEditSequence());
+
+}
+
+//==============================================================================
+void SnapshotRing::Clear () {
+
+    m_nextOlder  = 0;
+    m_olderCount = 0;
+    m_hasNewest  = false;
+
+}
+
+//==============================================================================
+bool SnapshotRing::Find (unsigned frame, WorldSnapshot * snapshotOut) const {
+
+    if (!m_hasNewest)
+        return false;
+
+    unsigned framesBack = 0;
+    if (frame != m_newestFrame) {
+        while (framesBack < m_olderCount && m_older[OlderSlot(framesBack)].frame != frame)
+            ++framesBack;
+        if (framesBack == m_olderCount)
+            return false;
+        ++framesBack;
+    }
+
+    snapshotOut->CopyFrom(m_newest);
+    for (unsigned i = 0; i < framesBack; ++i)
+        SnapshotDelta::Apply(m_older[OlderSlot(i)].delta, snapshotOut);
+
+    return true;
+
+}
+
+//==============================================================================
+bool SnapshotRing::Rewind (unsigned frame, WorldSnapshot * snapshotOut) {
+
+    if (!Find(frame, snapshotOut))
+        return false;
+
+    if (frame == m_newestFrame)
+        return true;
+
+    // Every older slot from the found frame on is now in the future.
+    unsigned framesBack = 0;
+    while (m_older[OlderSlot(framesBack)].frame != frame)
+        ++framesBack;
+
+    m_nextOlder   = OlderSlot(framesBack);
+    m_olderCount -= framesBack + 1;
+    m_newest.CopyFrom(*snapshotOut);
+    m_newestFrame = frame;
+    return true;
+
+}
+
+//==============================================================================
+unsigned SnapshotRing::GetOldestFrame () const {
+
+    return m_olderCount ? m_older[OlderSlot(m_olderCount - 1)].frame : m_newestFrame;
+
+}
+
+//==============================================================================
+unsigned SnapshotRing::GetOldestEditSequence () const {
+
+    return m_olderCount ? m_older[OlderSlot(m_olderCount - 1)].editSequence : m_newest.GetEditSequence();
+
+}
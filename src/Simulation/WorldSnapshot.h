@@ -0,0 +1,130 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Christopher Higgins Barrett
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include <cstdint>
+
+class GameObject;
+class Level;
+
+//==============================================================================
+// The whole simulation's state in one flat, word-aligned buffer: a small
+// header, then each object's GameObject::SaveState in order.  Tiles aren't
+// copied; the header holds the level's edit sequence and restoring reverts
+// the level's edits back to it.
+//
+// The buffer keeps its capacity, so capturing the same world every frame
+// allocates nothing after the first.  Snapshots of the same objects with the
+// same components always have the same size, which SnapshotDelta relies on.
+class WorldSnapshot {
+private: // Data
+    std::vector<std::uint32_t> m_words;
+    unsigned                   m_byteSize;
+
+public:
+    WorldSnapshot () : m_byteSize(0) {}
+
+    // Commands
+    void Capture (GameObject * const * objects, unsigned count, const Level * level);
+
+    // The objects must be the ones captured, with the same components.  Fails
+    // if they don't fit the snapshot, or if the level has discarded edits
+    // made since it was captured.
+    bool Restore (GameObject * const * objects, unsigned count, Level * level) const;
+
+    void CopyFrom (const WorldSnapshot & other);
+
+    // Queries
+    bool                    HasLevel () const;
+    unsigned                GetEditSequence () const; // The level's, as captured
+    unsigned                GetByteSize () const  { return m_byteSize; }
+    unsigned                GetWordCount () const { return unsigned(m_words.size()); }
+    const std::uint32_t *   GetWords () const     { return m_words.data(); }
+    std::uint32_t *         GetWords ()           { return m_words.data(); }
+};
+
+
+//==============================================================================
+// Deltas between two same-sized snapshots: their XOR, run-length encoded as
+// alternating runs of zero and literal words.  Consecutive frames differ in a
+// small fraction of words, so deltas are small; and XOR is its own inverse,
+// so one delta turns either snapshot into the other.
+namespace SnapshotDelta {
+
+    void Encode (const WorldSnapshot & from, const WorldSnapshot & to, std::vector<unsigned char> * deltaOut);
+
+    // Applies a delta made from or to a snapshot of this size, in place.
+    void Apply (const std::vector<unsigned char> & delta, WorldSnapshot * snapshotInOut);
+
+} // namespace SnapshotDelta
+
+
+//==============================================================================
+// The last few frames' snapshots for rollback and instant replay.  Only the
+// newest is stored whole; each older frame is a delta to the frame after it,
+// so looking a frame up costs one delta per frame back.  A snapshot of a
+// different size (objects or components added or removed) starts the history
+// over.
+//
+// Pushing with the level trims its edit history to what the oldest frame
+// held still needs, so the log stays as short as the ring.
+class SnapshotRing {
+private: // Types
+    struct OlderFrame {
+        unsigned                   frame;
+        unsigned                   editSequence;
+        std::vector<unsigned char> delta; // To the next newer frame
+    };
+
+private: // Data
+    std::vector<OlderFrame> m_older;      // Ring; m_nextOlder is the next slot to write
+    unsigned                m_nextOlder;
+    unsigned                m_olderCount;
+    WorldSnapshot           m_newest;
+    unsigned                m_newestFrame;
+    bool                    m_hasNewest;
+
+private: // Helpers
+    unsigned OlderSlot (unsigned framesBack) const;
+
+public:
+    // Holds capacity frames, counting the newest.
+    explicit SnapshotRing (unsigned capacity);
+
+    // Commands
+    void Push (const WorldSnapshot & snapshot, unsigned frame, Level * level = nullptr);
+    void Clear ();
+
+    // Rebuilds frame into snapshotOut and drops every frame after it, so the
+    // simulation can resume from there and push its new future.
+    bool Rewind (unsigned frame, WorldSnapshot * snapshotOut);
+
+    // Queries
+    bool     Find (unsigned frame, WorldSnapshot * snapshotOut) const;
+    unsigned GetFrameCount () const    { return m_hasNewest ? m_olderCount + 1 : 0; }
+    unsigned GetNewestFrame () const   { return m_newestFrame; }
+    unsigned GetOldestFrame () const;
+    unsigned GetOldestEditSequence () const;
+};
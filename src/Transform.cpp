@@ -1,7 +1,81 @@
 #include "Transform.h"
+#include "TransformBatch.h"
+
+#include <cstring>
+
+namespace {
+
+const unsigned s_batchGatherSize = 64;
+
+//==============================================================================
+template <typename T_GetTransform>
+void GatherAndBuild (unsigned count, Mtx44 * worldMatricesOut, T_GetTransform getTransform) {
+
+    float posX[s_batchGatherSize];
+    float posY[s_batchGatherSize];
+    float rotation[s_batchGatherSize];
+    float scaleX[s_batchGatherSize];
+    float scaleY[s_batchGatherSize];
+    const Affine2dBatch batch = { posX, posY, rotation, scaleX, scaleY };
+
+    for (unsigned first = 0; first < count; first += s_batchGatherSize) {
+        const unsigned gatherCount = MIN(s_batchGatherSize, count - first);
+        for (unsigned i = 0; i < gatherCount; ++i) {
+            const Transform & transform = getTransform(first + i);
+            posX[i]     = transform.GetPosition().x;
+            posY[i]     = transform.GetPosition().y;
+            rotation[i] = transform.GetRotation();
+            scaleX[i]   = transform.GetScale().x;
+            scaleY[i]   = transform.GetScale().y;
+        }
+
+        BuildAffine2dMatrices(batch, gatherCount, worldMatricesOut + first);
+    }
+
+}
+
+#if defined(_DEBUG)
+//==============================================================================
+// The general product the closed form replaces; used to validate it.
+void BuildWorldFromModelMtxReference (const Transform & transform, Mtx44 * worldMatrixOut) {
+
+    Mtx44 translation;
+    Mtx44 rotationZ;
+    Mtx44 scale;
+
+    Mtx44::BuildTranslate(transform.GetPosition().x, transform.GetPosition().y, 0.0f, &translation);
+    Mtx44::BuildRotateZ(transform.GetRotation(), &rotationZ);
+    Mtx44::BuildScale(transform.GetScale().x, transform.GetScale().y, 1.0f, &scale);
+
+    *worldMatrixOut = scale * rotationZ * translation;
+
+}
+
+//==============================================================================
+bool MatchesReference (const Transform & transform, const Mtx44 & worldMatrix) {
+
+    Mtx44 reference;
+    BuildWorldFromModelMtxReference(transform, &reference);
+
+    const float * a = reinterpret_cast<const float *>(&reference);
+    const float * b = reinterpret_cast<const float *>(&worldMatrix);
+    for (unsigned i = 0; i < 16; ++i) {
+        if (fabs(a[i] - b[i]) > 1e-3f * (1.0f + fabs(a[i])))
+            return false;
+    }
+
+    return true;
+
+}
+#endif
+
+} // namespace
 
 //==============================================================================
-Transform::Transform () : m_rotation(0.0f) {
+Transform::Transform () :
+    m_rotation(0.0f),
+    m_worldFromModelDirty(true)
+{
 
   m_position.x = m_position.y = 0.0f;
   m_scale.x    = m_scale.y    = 1.0f;
@@ -13,35 +87,64 @@ Transform::Transform () : m_rotation(0.0f) {
 Transform::~Transform () {
 }
 
+//==============================================================================
+void Transform::BuildWorldFromModelMtxBatch (const Transform * transforms, unsigned count, Mtx44 * worldMatricesOut) {
+
+    GatherAndBuild(count, worldMatricesOut, [transforms](unsigned i) -> const Transform & { return transforms[i]; });
+#if defined(_DEBUG)
+    ASSERT(!count || MatchesReference(transforms[0], worldMatricesOut[0]));
+#endif
+
+}
+
+//==============================================================================
+void Transform::BuildWorldFromModelMtxBatch (const Transform * const * transforms, unsigned count, Mtx44 * worldMatricesOut) {
+
+    GatherAndBuild(count, worldMatricesOut, [transforms](unsigned i) -> const Transform & { return *transforms[i]; });
+#if defined(_DEBUG)
+    ASSERT(!count || MatchesReference(*transforms[0], worldMatricesOut[0]));
+#endif
+
+}
+
 //==============================================================================
 void Transform::GetWorldFromModelMtx (Mtx44 * worldMatrixOut) const {
+    *worldMatrixOut = GetWorldFromModelMtx();
+}
 
-    Mtx44 translation;
-    Mtx44 rotationZ;
-    Mtx44 scale;
+//==============================================================================
+const Mtx44 & Transform::GetWorldFromModelMtx () const {
 
-    Mtx44::BuildTranslate(m_position.x, m_position.y, 0.0f, &translation);
-    Mtx44::BuildRotateZ(m_rotation, &rotationZ);
-    Mtx44::BuildScale(m_scale.x, m_scale.y, 1.0f, &scale);
+    if (!m_worldFromModelDirty)
+        return m_worldFromModelMtx;
 
-    //*worldMatrixOut = translation * rotationZ * scale;
-    *worldMatrixOut = scale * rotationZ * translation;
+    // Closed form of scale * rotationZ * translation; see TransformBatch.h.
+    BuildAffine2dMatrix(m_position.x, m_position.y, m_rotation, m_scale.x, m_scale.y, &m_worldFromModelMtx);
+#if defined(_DEBUG)
+    ASSERT(MatchesReference(*this, m_worldFromModelMtx));
+#endif
+    m_worldFromModelDirty = false;
+
+    return m_worldFromModelMtx;
 
 }
 
 //==============================================================================
 void Transform::SetPosition (const Vec3 & position) {
-    m_position = position;
+    m_position            = position;
+    m_worldFromModelDirty = true;
 }
 
 //==============================================================================
 void Transform::SetRotation (float rotation) {
-    m_rotation = rotation;
+    m_rotation            = rotation;
+    m_worldFromModelDirty = true;
 }
 
 //==============================================================================
 void Transform::SetScale (const Vec3 & scale) {
-    m_scale = scale;
+    m_scale               = scale;
+    m_worldFromModelDirty = true;
 }
 
 //==============================================================================
@@ -54,3 +157,36 @@ void Transform::SetVelocity (float x, float y) {
     m_velocity.x = x;
     m_velocity.y = y;
 }
+
+//==============================================================================
+void Transform::SaveState (float * state) const {
+
+    state[0] = m_position.x;
+    state[1] = m_position.y;
+    state[2] = m_position.z;
+    state[3] = m_rotation;
+    state[4] = m_scale.x;
+    state[5] = m_scale.y;
+    state[6] = m_scale.z;
+    state[7] = m_velocity.x;
+    state[8] = m_velocity.y;
+    state[9] = m_velocity.z;
+
+}
+
+//==============================================================================
+void Transform::LoadState (const float * state) {
+
+    // Position, rotation and scale feed the world matrix.
+    float current[s_stateFloats];
+    SaveState(current);
+    if (memcmp(current, state, 7 * sizeof(float))) {
+        m_position            = Vec3(state[0], state[1], state[2]);
+        m_rotation            = state[3];
+        m_scale               = Vec3(state[4], state[5], state[6]);
+        m_worldFromModelDirty = true;
+    }
+
+    m_velocity = Vec3(state[7], state[8], state[9]);
+
+}
@@ -1,5 +1,13 @@
 #pragma once
 
+// Axis-aligned world-space rectangle (camera views, query bounds).
+struct WorldRect {
+    float minX;
+    float minY;
+    float maxX;
+    float maxY;
+};
+
 class Transform {
 
 private: // Data
@@ -10,6 +18,13 @@ private: // Data
     
     Vec3  m_velocity; // Hacks! (?)
 
+    // World matrix cache; rebuilt on demand after SetPosition/Rotation/Scale.
+    mutable Mtx44 m_worldFromModelMtx;
+    mutable bool  m_worldFromModelDirty;
+
+public: // Constants
+    static const unsigned s_stateFloats = 10; // See SaveState
+
 public:
     // Construction
     Transform(void);
@@ -17,11 +32,18 @@ public:
     
     // Queries
     void         GetWorldFromModelMtx (Mtx44 * worldMatrixOut) const;
+    const Mtx44 & GetWorldFromModelMtx () const;
+    bool         IsWorldFromModelDirty () const { return m_worldFromModelDirty; }
     const Vec3 & GetPosition () const     { return m_position; }
     float        GetRotation () const     { return m_rotation; }
     const Vec3 & GetScale () const        { return m_scale; }
     const Vec3 & GetVelocity () const     { return m_velocity; }
 
+    // Builds world matrices for many transforms at once (SIMD where
+    // available).  Same results as calling GetWorldFromModelMtx on each.
+    static void BuildWorldFromModelMtxBatch (const Transform * transforms, unsigned count, Mtx44 * worldMatricesOut);
+    static void BuildWorldFromModelMtxBatch (const Transform * const * transforms, unsigned count, Mtx44 * worldMatricesOut);
+
     // Commands
     void SetPosition (const Vec3 & position);
     void SetRotation (float rotation);
@@ -30,4 +52,9 @@ public:
     void SetVelocity (const Vec3 & velocity);
     void SetVelocity (float x, float y);
 
+    // Rollback: position, rotation, scale and velocity as s_stateFloats
+    // floats.  Loading only invalidates the world matrix if it changed.
+    void SaveState (float * state) const;
+    void LoadState (const float * state);
+
 };
@@ -0,0 +1,180 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Christopher Higgins Barrett
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "TransformBatch.h"
+
+#include <cmath>
+
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#   define CSARU_TRANSFORM_BATCH_SSE 1
+#   include <xmmintrin.h>
+#else
+#   define CSARU_TRANSFORM_BATCH_SSE 0
+#endif
+
+static_assert(sizeof(Mtx44) == 16 * sizeof(float), "TransformBatch writes Mtx44 as 16 packed floats.");
+
+//==============================================================================
+void BuildAffine2dMatrix (float posX, float posY, float rotation, float scaleX, float scaleY, Mtx44 * matrixOut) {
+
+    const float c = cosf(rotation);
+    const float s = sinf(rotation);
+
+    float * m = reinterpret_cast<float *>(matrixOut);
+    m[0]  =  scaleX * c; m[1]  = scaleX * s; m[2]  = 0.0f; m[3]  = 0.0f;
+    m[4]  = -scaleY * s; m[5]  = scaleY * c; m[6]  = 0.0f; m[7]  = 0.0f;
+    m[8]  =  0.0f;       m[9]  = 0.0f;       m[10] = 1.0f; m[11] = 0.0f;
+    m[12] =  posX;       m[13] = posY;       m[14] = 0.0f; m[15] = 1.0f;
+
+}
+
+//==============================================================================
+void BuildAffine2dMatricesScalar (const Affine2dBatch & batch, unsigned count, Mtx44 * matricesOut) {
+
+    for (unsigned i = 0; i < count; ++i) {
+        BuildAffine2dMatrix(
+            batch.posX[i],
+            batch.posY[i],
+            batch.rotation[i],
+            batch.scaleX[i],
+            batch.scaleY[i],
+            &matricesOut[i]
+        );
+    }
+
+}
+
+//==============================================================================
+void BuildAffine2dMatrices (const Affine2dBatch & batch, unsigned count, Mtx44 * matricesOut) {
+
+#if CSARU_TRANSFORM_BATCH_SSE
+
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 row2 = _mm_set_ps(0.0f, 1.0f, 0.0f, 0.0f);
+
+    unsigned i = 0;
+    for (; i + 4 <= count; i += 4) {
+        // No SSE sin/cos; the trig is scalar, everything else is 4-wide.
+        float c[4];
+        float s[4];
+        for (unsigned lane = 0; lane < 4; ++lane) {
+            c[lane] = cosf(batch.rotation[i + lane]);
+            s[lane] = sinf(batch.rotation[i + lane]);
+        }
+
+        const __m128 cosv = _mm_loadu_ps(c);
+        const __m128 sinv = _mm_loadu_ps(s);
+        const __m128 sx   = _mm_loadu_ps(batch.scaleX + i);
+        const __m128 sy   = _mm_loadu_ps(batch.scaleY + i);
+
+        __m128 m00 = _mm_mul_ps(sx, cosv);
+        __m128 m01 = _mm_mul_ps(sx, sinv);
+        __m128 m10 = _mm_sub_ps(zero, _mm_mul_ps(sy, sinv));
+        __m128 m11 = _mm_mul_ps(sy, cosv);
+        _MM_TRANSPOSE4_PS(m00, m01, m10, m11); // Now one register per transform
+
+        __m128 tx  = _mm_loadu_ps(batch.posX + i);
+        __m128 ty  = _mm_loadu_ps(batch.posY + i);
+        __m128 tz  = zero;
+        __m128 tw  = _mm_set1_ps(1.0f);
+        _MM_TRANSPOSE4_PS(tx, ty, tz, tw);
+
+        const __m128 upper[4]       = { m00, m01, m10, m11 };
+        const __m128 translation[4] = { tx, ty, tz, tw };
+        for (unsigned lane = 0; lane < 4; ++lane) {
+            float * m = reinterpret_cast<float *>(&matricesOut[i + lane]);
+            _mm_storeu_ps(m + 0,  _mm_movelh_ps(upper[lane], zero));
+            _mm_storeu_ps(m + 4,  _mm_movehl_ps(zero, upper[lane]));
+            _mm_storeu_ps(m + 8,  row2);
+            _mm_storeu_ps(m + 12, translation[lane]);
+        }
+    }
+
+    if (i < count) {
+        Affine2dBatch tail = {
+            batch.posX + i,
+            batch.posY + i,
+            batch.rotation + i,
+            batch.scaleX + i,
+            batch.scaleY + i,
+        };
+        BuildAffine2dMatricesScalar(tail, count - i, matricesOut + i);
+    }
+
+#else
+
+    BuildAffine2dMatricesScalar(batch, count, matricesOut);
+
+#endif
+
+}
+
+//==============================================================================
+void TranslateAffine2d (float x, float y, const Mtx44 & parent, Mtx44 * matrixOut) {
+
+    if (matrixOut != &parent)
+        *matrixOut = parent;
+
+    const float * b = reinterpret_cast<const float *>(&parent);
+    float *       m = reinterpret_cast<float *>(matrixOut);
+    m[12] = x * b[0] + y * b[4] + b[12];
+    m[13] = x * b[1] + y * b[5] + b[13];
+
+}
+
+//==============================================================================
+bool InvertAffine2d (const Mtx44 & matrix, Mtx44 * matrixOut) {
+
+    const float * a = reinterpret_cast<const float *>(&matrix);
+
+    const float det = a[0] * a[5] - a[1] * a[4];
+    if (fabs(det) < 1e-12f)
+        return false;
+    const float invDet = 1.0f / det;
+
+    const float m00 =  a[5] * invDet;
+    const float m01 = -a[1] * invDet;
+    const float m10 = -a[4] * invDet;
+    const float m11 =  a[0] * invDet;
+    const float m30 = -(a[12] * m00 + a[13] * m10);
+    const float m31 = -(a[12] * m01 + a[13] * m11);
+
+    float * m = reinterpret_cast<float *>(matrixOut);
+    m[0]  = m00;  m[1]  = m01;  m[2]  = 0.0f; m[3]  = 0.0f;
+    m[4]  = m10;  m[5]  = m11;  m[6]  = 0.0f; m[7]  = 0.0f;
+    m[8]  = 0.0f; m[9]  = 0.0f; m[10] = 1.0f; m[11] = 0.0f;
+    m[12] = m30;  m[13] = m31;  m[14] = 0.0f; m[15] = 1.0f;
+
+    return true;
+
+}
+
+//==============================================================================
+void TransformPointAffine2d (const Mtx44 & matrix, float x, float y, float * xOut, float * yOut) {
+
+    const float * m = reinterpret_cast<const float *>(&matrix);
+    *xOut = x * m[0] + y * m[4] + m[12];
+    *yOut = x * m[1] + y * m[5] + m[13];
+
+}
@@ -0,0 +1,60 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Christopher Higgins Barrett
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+//==============================================================================
+// Closed-form 2D scale/rotate/translate matrices, built in bulk.
+//
+// Output matches Transform::GetWorldFromModelMtx, i.e. the row-vector product
+// scale * rotationZ * translation:
+//
+//     [  sx*cos   sx*sin  0  0 ]
+//     [ -sy*sin   sy*cos  0  0 ]
+//     [  0        0       1  0 ]
+//     [  tx       ty      0  1 ]
+//
+// Inputs are structure-of-arrays so four transforms fill one SSE register.
+struct Affine2dBatch {
+    const float * posX;
+    const float * posY;
+    const float * rotation;
+    const float * scaleX;
+    const float * scaleY;
+};
+
+void BuildAffine2dMatrices (const Affine2dBatch & batch, unsigned count, Mtx44 * matricesOut);
+void BuildAffine2dMatricesScalar (const Affine2dBatch & batch, unsigned count, Mtx44 * matricesOut);
+void BuildAffine2dMatrix (float posX, float posY, float rotation, float scaleX, float scaleY, Mtx44 * matrixOut);
+
+// Product of a pure translation (x, y), applied first, and parent, skipping
+// the constant third column/row.
+void TranslateAffine2d (float x, float y, const Mtx44 & parent, Mtx44 * matrixOut);
+
+// Inverse of an affine 2D matrix.  Returns false (leaving matrixOut alone) if
+// the matrix is singular, e.g. a zero scale.
+bool InvertAffine2d (const Mtx44 & matrix, Mtx44 * matrixOut);
+
+// Applies an affine 2D matrix to a point (row-vector convention).
+void TransformPointAffine2d (const Mtx44 & matrix, float x, float y, float * xOut, float * yOut);
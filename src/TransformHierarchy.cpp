@@ -0,0 +1,373 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Christopher Higgins Barrett
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "TransformHierarchy.h"
+#include "TransformBatch.h"
+
+namespace {
+
+//==============================================================================
+template <typename T>
+void Permute (std::vector<T> & values, const std::vector<unsigned> & order) {
+
+    std::vector<T> permuted;
+    permuted.reserve(order.size());
+    for (unsigned oldSlot : order)
+        permuted.push_back(values[oldSlot]);
+    values.swap(permuted);
+
+}
+
+//==============================================================================
+// Row-vector product of two affine 2D matrices (child applied first), skipping
+// the constant third column/row.
+void MultiplyAffine2d (const Mtx44 & child, const Mtx44 & parent, Mtx44 * matrixOut) {
+
+    const float * a = reinterpret_cast<const float *>(&child);
+    const float * b = reinterpret_cast<const float *>(&parent);
+
+    // Computed fully before writing so matrixOut may alias either input.
+    const float m00 = a[0]  * b[0] + a[1]  * b[4];
+    const float m01 = a[0]  * b[1] + a[1]  * b[5];
+    const float m10 = a[4]  * b[0] + a[5]  * b[4];
+    const float m11 = a[4]  * b[1] + a[5]  * b[5];
+    const float m30 = a[12] * b[0] + a[13] * b[4] + b[12];
+    const float m31 = a[12] * b[1] + a[13] * b[5] + b[13];
+
+    float * m = reinterpret_cast<float *>(matrixOut);
+    m[0]  = m00;  m[1]  = m01;  m[2]  = 0.0f; m[3]  = 0.0f;
+    m[4]  = m10;  m[5]  = m11;  m[6]  = 0.0f; m[7]  = 0.0f;
+    m[8]  = 0.0f; m[9]  = 0.0f; m[10] = 1.0f; m[11] = 0.0f;
+    m[12] = m30;  m[13] = m31;  m[14] = 0.0f; m[15] = 1.0f;
+
+}
+
+} // namespace
+
+const TransformHierarchy::NodeId TransformHierarchy::s_invalidNode;
+const unsigned                   TransformHierarchy::s_invalidSlot;
+
+//==============================================================================
+TransformHierarchy::TransformHierarchy () :
+    m_orderDirty(false),
+    m_lastUpdatedCount(0)
+{}
+
+//==============================================================================
+unsigned TransformHierarchy::SlotOf (NodeId node) const {
+
+    ASSERT(IsValid(node));
+    return m_nodeSlot[node];
+
+}
+
+//==============================================================================
+void TransformHierarchy::Reorder () {
+
+    const unsigned slotCount = unsigned(m_slotNode.size());
+
+    // Bucket each live slot's children (counting sort on parent slot)
+    std::vector<unsigned> childStart(slotCount + 1, 0);
+    std::vector<unsigned> roots;
+    for (unsigned slot = 0; slot < slotCount; ++slot) {
+        if (m_flags[slot] & NODE_FLAG_DEAD)
+            continue;
+        if (m_parentSlot[slot] == s_invalidSlot)
+            roots.push_back(slot);
+        else
+            ++childStart[m_parentSlot[slot] + 1];
+    }
+    for (unsigned slot = 0; slot < slotCount; ++slot)
+        childStart[slot + 1] += childStart[slot];
+
+    std::vector<unsigned> children(childStart[slotCount]);
+    std::vector<unsigned> childFill(childStart.begin(), childStart.end() - 1);
+    for (unsigned slot = 0; slot < slotCount; ++slot) {
+        if (!(m_flags[slot] & NODE_FLAG_DEAD) && m_parentSlot[slot] != s_invalidSlot)
+            children[childFill[m_parentSlot[slot]]++] = slot;
+    }
+
+    // Breadth-first walk gives the new slot order (new slot -> old slot)
+    std::vector<unsigned> order(roots);
+    order.reserve(roots.size() + children.size());
+    for (unsigned head = 0; head < order.size(); ++head) {
+        const unsigned parent = order[head];
+        order.insert(order.end(), children.begin() + childStart[parent], children.begin() + childStart[parent + 1]);
+    }
+
+    std::vector<unsigned> newSlotOf(slotCount, s_invalidSlot);
+    for (unsigned newSlot = 0; newSlot < order.size(); ++newSlot)
+        newSlotOf[order[newSlot]] = newSlot;
+
+    Permute(m_slotNode,   order);
+    Permute(m_parentSlot, order);
+    Permute(m_flags,      order);
+    Permute(m_posX,       order);
+    Permute(m_posY,       order);
+    Permute(m_rotation,   order);
+    Permute(m_scaleX,     order);
+    Permute(m_scaleY,     order);
+    Permute(m_localMtx,   order);
+    Permute(m_worldMtx,   order);
+
+    for (unsigned newSlot = 0; newSlot < order.size(); ++newSlot) {
+        unsigned & parentSlot = m_parentSlot[newSlot];
+        if (parentSlot != s_invalidSlot)
+            parentSlot = newSlotOf[parentSlot];
+        m_nodeSlot[m_slotNode[newSlot]] = newSlot;
+    }
+
+    m_orderDirty = false;
+
+}
+
+//==============================================================================
+void TransformHierarchy::BuildDirtyLocals () {
+
+    // Consecutive dirty nodes are already SoA, so rebuild them in runs.
+    const unsigned slotCount = unsigned(m_slotNode.size());
+    for (unsigned slot = 0; slot < slotCount; ) {
+        if (!(m_flags[slot] & NODE_FLAG_LOCAL_DIRTY)) {
+            ++slot;
+            continue;
+        }
+
+        unsigned runEnd = slot + 1;
+        while (runEnd < slotCount && (m_flags[runEnd] & NODE_FLAG_LOCAL_DIRTY))
+            ++runEnd;
+
+        const Affine2dBatch batch = {
+            &m_posX[slot],
+            &m_posY[slot],
+            &m_rotation[slot],
+            &m_scaleX[slot],
+            &m_scaleY[slot],
+        };
+        BuildAffine2dMatrices(batch, runEnd - slot, &m_localMtx[slot]);
+
+        slot = runEnd;
+    }
+
+}
+
+//==============================================================================
+TransformHierarchy::NodeId TransformHierarchy::CreateNode (NodeId parent) {
+
+    NodeId node;
+    if (!m_freeNodes.empty()) {
+        node = m_freeNodes.back();
+        m_freeNodes.pop_back();
+    }
+    else {
+        node = NodeId(m_nodeSlot.size());
+        m_nodeSlot.push_back(s_invalidSlot);
+    }
+
+    const unsigned slot       = unsigned(m_slotNode.size());
+    const unsigned parentSlot = parent == s_invalidNode ? s_invalidSlot : SlotOf(parent);
+    m_nodeSlot[node] = slot;
+
+    // Appending keeps parents ahead of children; the re-sort only restores
+    // sibling locality.
+    m_slotNode.push_back(node);
+    m_parentSlot.push_back(parentSlot);
+    m_flags.push_back(NODE_FLAG_LOCAL_DIRTY);
+    m_posX.push_back(0.0f);
+    m_posY.push_back(0.0f);
+    m_rotation.push_back(0.0f);
+    m_scaleX.push_back(1.0f);
+    m_scaleY.push_back(1.0f);
+    m_localMtx.push_back(Mtx44());
+    m_worldMtx.push_back(Mtx44());
+    BuildAffine2dMatrix(0.0f, 0.0f, 0.0f, 1.0f, 1.0f, &m_worldMtx.back());
+
+    m_orderDirty = true;
+
+    return node;
+
+}
+
+//==============================================================================
+void TransformHierarchy::DestroyNode (NodeId node) {
+
+    // Descendants are found in one forward pass, which needs parents first.
+    if (m_orderDirty)
+        Reorder();
+
+    const unsigned root      = SlotOf(node);
+    const unsigned slotCount = unsigned(m_slotNode.size());
+    for (unsigned slot = root; slot < slotCount; ++slot) {
+        if (m_flags[slot] & NODE_FLAG_DEAD)
+            continue;
+        if (slot != root) {
+            const unsigned parentSlot = m_parentSlot[slot];
+            if (parentSlot == s_invalidSlot || !(m_flags[parentSlot] & NODE_FLAG_DEAD))
+                continue;
+        }
+
+        m_flags[slot] = NODE_FLAG_DEAD;
+        m_nodeSlot[m_slotNode[slot]] = s_invalidSlot;
+        m_freeNodes.push_back(m_slotNode[slot]);
+    }
+
+    m_orderDirty = true;
+
+}
+
+//==============================================================================
+void TransformHierarchy::SetParent (NodeId node, NodeId parent) {
+
+    const unsigned slot       = SlotOf(node);
+    const unsigned parentSlot = parent == s_invalidNode ? s_invalidSlot : SlotOf(parent);
+
+    for (unsigned ancestor = parentSlot; ancestor != s_invalidSlot; ancestor = m_parentSlot[ancestor])
+        ASSERT(ancestor != slot && "SetParent would create a cycle.");
+
+    if (m_parentSlot[slot] == parentSlot)
+        return;
+
+    m_parentSlot[slot]  = parentSlot;
+    m_flags[slot]      |= NODE_FLAG_WORLD_DIRTY;
+    m_orderDirty        = true;
+
+}
+
+//==============================================================================
+void TransformHierarchy::Clear () {
+
+    m_slotNode.clear();
+    m_parentSlot.clear();
+    m_flags.clear();
+    m_posX.clear();
+    m_posY.clear();
+    m_rotation.clear();
+    m_scaleX.clear();
+    m_scaleY.clear();
+    m_localMtx.clear();
+    m_worldMtx.clear();
+    m_nodeSlot.clear();
+    m_freeNodes.clear();
+
+    m_orderDirty       = false;
+    m_lastUpdatedCount = 0;
+
+}
+
+//==============================================================================
+void TransformHierarchy::SetLocal (NodeId node, const Transform & local) {
+
+    const unsigned slot = SlotOf(node);
+    m_posX[slot]      = local.GetPosition().x;
+    m_posY[slot]      = local.GetPosition().y;
+    m_rotation[slot]  = local.GetRotation();
+    m_scaleX[slot]    = local.GetScale().x;
+    m_scaleY[slot]    = local.GetScale().y;
+    m_flags[slot]    |= NODE_FLAG_LOCAL_DIRTY;
+
+}
+
+//==============================================================================
+void TransformHierarchy::SetLocalPosition (NodeId node, float x, float y) {
+
+    const unsigned slot = SlotOf(node);
+    m_posX[slot]   = x;
+    m_posY[slot]   = y;
+    m_flags[slot] |= NODE_FLAG_LOCAL_DIRTY;
+
+}
+
+//==============================================================================
+void TransformHierarchy::SetLocalRotation (NodeId node, float rotation) {
+
+    const unsigned slot = SlotOf(node);
+    m_rotation[slot] = rotation;
+    m_flags[slot]   |= NODE_FLAG_LOCAL_DIRTY;
+
+}
+
+//==============================================================================
+void TransformHierarchy::SetLocalScale (NodeId node, float x, float y) {
+
+    const unsigned slot = SlotOf(node);
+    m_scaleX[slot] = x;
+    m_scaleY[slot] = y;
+    m_flags[slot] |= NODE_FLAG_LOCAL_DIRTY;
+
+}
+
+//==============================================================================
+void TransformHierarchy::Update () {
+
+    if (m_orderDirty)
+        Reorder();
+
+    BuildDirtyLocals();
+
+    // Parents precede children, so a parent's WORLD_CHANGED flag is already
+    // current for this pass when its children are visited.
+    m_lastUpdatedCount = 0;
+    const unsigned slotCount = unsigned(m_slotNode.size());
+    for (unsigned slot = 0; slot < slotCount; ++slot) {
+        const unsigned char flags      = m_flags[slot];
+        const unsigned      parentSlot = m_parentSlot[slot];
+
+        const bool parentChanged = parentSlot != s_invalidSlot && (m_flags[parentSlot] & NODE_FLAG_WORLD_CHANGED);
+        if (!parentChanged && !(flags & (NODE_FLAG_LOCAL_DIRTY | NODE_FLAG_WORLD_DIRTY))) {
+            m_flags[slot] = 0;
+            continue;
+        }
+
+        if (parentSlot == s_invalidSlot)
+            m_worldMtx[slot] = m_localMtx[slot];
+        else
+            MultiplyAffine2d(m_localMtx[slot], m_worldMtx[parentSlot], &m_worldMtx[slot]);
+
+        m_flags[slot] = NODE_FLAG_WORLD_CHANGED;
+        ++m_lastUpdatedCount;
+    }
+
+}
+
+//==============================================================================
+bool TransformHierarchy::IsValid (NodeId node) const {
+    return node < m_nodeSlot.size() && m_nodeSlot[node] != s_invalidSlot;
+}
+
+//==============================================================================
+TransformHierarchy::NodeId TransformHierarchy::GetParent (NodeId node) const {
+
+    const unsigned parentSlot = m_parentSlot[SlotOf(node)];
+    return parentSlot == s_invalidSlot ? s_invalidNode : m_slotNode[parentSlot];
+
+}
+
+//==============================================================================
+const Mtx44 & TransformHierarchy::GetWorldMtx (NodeId node) const {
+    return m_worldMtx[SlotOf(node)];
+}
+
+//==============================================================================
+bool TransformHierarchy::WorldChanged (NodeId node) const {
+    return (m_flags[SlotOf(node)] & NODE_FLAG_WORLD_CHANGED) != 0;
+}
@@ -0,0 +1,101 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Christopher Higgins Barrett
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+//==============================================================================
+// Parent/child 2D transforms with cached world matrices.
+//
+// Node data is kept structure-of-arrays in breadth-first order, so parents
+// always precede their children and Update() is one linear pass: a node's
+// world matrix is rebuilt only if its local transform changed or its parent's
+// world matrix changed this pass.  Still nodes cost a flag test.
+//
+// Node ids are stable; the slots behind them move when the tree is re-sorted
+// after SetParent/DestroyNode, which happens lazily at the next Update().
+// World matrices are valid after Update().
+class TransformHierarchy {
+public: // Types and Constants
+    typedef unsigned NodeId;
+    static const NodeId s_invalidNode = NodeId(-1);
+
+private: // Types and Constants
+    static const unsigned s_invalidSlot = unsigned(-1);
+
+    enum ENodeFlag : unsigned char {
+        NODE_FLAG_LOCAL_DIRTY   = 1 << 0, // Local matrix needs rebuilding
+        NODE_FLAG_WORLD_DIRTY   = 1 << 1, // World matrix needs rebuilding (reparented)
+        NODE_FLAG_WORLD_CHANGED = 1 << 2, // World matrix rebuilt by the last Update()
+        NODE_FLAG_DEAD          = 1 << 3, // Destroyed, awaiting compaction
+    };
+
+private: // Data
+    // Per slot, in breadth-first order
+    std::vector<NodeId>        m_slotNode;
+    std::vector<unsigned>      m_parentSlot;
+    std::vector<unsigned char> m_flags;
+    std::vector<float>         m_posX;
+    std::vector<float>         m_posY;
+    std::vector<float>         m_rotation;
+    std::vector<float>         m_scaleX;
+    std::vector<float>         m_scaleY;
+    std::vector<Mtx44>         m_localMtx;
+    std::vector<Mtx44>         m_worldMtx;
+
+    // Per node id
+    std::vector<unsigned>      m_nodeSlot;
+    std::vector<NodeId>        m_freeNodes;
+
+    bool                       m_orderDirty;
+    unsigned                   m_lastUpdatedCount;
+
+private: // Helpers
+    unsigned SlotOf (NodeId node) const;
+    void     Reorder ();
+    void     BuildDirtyLocals ();
+
+public:
+    TransformHierarchy ();
+
+    // Commands
+    NodeId CreateNode (NodeId parent = s_invalidNode);
+    void   DestroyNode (NodeId node); // And all of its descendants
+    void   SetParent (NodeId node, NodeId parent);
+    void   Clear ();
+
+    void   SetLocal (NodeId node, const Transform & local);
+    void   SetLocalPosition (NodeId node, float x, float y);
+    void   SetLocalRotation (NodeId node, float rotation);
+    void   SetLocalScale (NodeId node, float x, float y);
+
+    void   Update ();
+
+    // Queries
+    bool          IsValid (NodeId node) const;
+    NodeId        GetParent (NodeId node) const;
+    const Mtx44 & GetWorldMtx (NodeId node) const;
+    bool          WorldChanged (NodeId node) const; // Rebuilt by the last Update()
+    unsigned      GetNodeCount () const         { return unsigned(m_nodeSlot.size() - m_freeNodes.size()); }
+    unsigned      GetLastUpdatedCount () const  { return m_lastUpdatedCount; }
+};
@@ -35,4 +35,17 @@ std::uint32_t Djb2Hash (const char * str)
   return hash;
 }
 
+std::uint64_t Fnv1aHash64 (const void * data, size_t size)
+{
+  const unsigned char * bytes = static_cast<const unsigned char *>(data);
+
+  std::uint64_t hash = 14695981039346656037ull;
+  for (size_t i = 0; i < size; ++i) {
+    hash ^= bytes[i];
+    hash *= 1099511628211ull;
+  }
+
+  return hash;
+}
+
 } // namespace Core
@@ -24,6 +24,8 @@ SOFTWARE.
 
 #pragma once
 
+#include <cstdio>
+
 namespace Core {
 
 
@@ -31,6 +33,10 @@ namespace Core {
 //unsigned long Djb2Hash(unsigned char* str);
 std::uint32_t Djb2Hash(const char* str);
 
+// FNV-1a, 64-bit.  Not cryptographic; cooked files use it to notice edits to
+// their source datafiles.
+std::uint64_t Fnv1aHash64 (const void * data, size_t size);
+
 
 struct Uuid {
     std::uint64_t high;
@@ -39,6 +45,16 @@ struct Uuid {
 bool GenerateUuidV4 (Uuid * uuid);
 
 
+// High resolution monotonic clock (QueryPerformanceCounter/clock_gettime).
+std::uint64_t GetPerformanceCounter ();
+std::uint64_t GetPerformanceFrequency (); // Counts per second
+
+
+// fopen on every platform (fopen_s where the CRT deprecates fopen).  Returns
+// null on failure.
+FILE * OpenFile (const char * filepath, const char * mode);
+
+
 /* C++11 provides a static_assert
 //
 // static_assert()  (if it doesn't already exist)
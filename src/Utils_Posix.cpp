@@ -20,22 +20,37 @@ limitations under the License.
 
 #include "Utils.h"
 
-namespace codesaru {
-
 // thanks to
 //  http://publib.boulder.ibm.com/infocenter/zos/v1r12/index.jsp?topic=/com.ibm.zos.r12.bpxbd00/rtsys.htm
 //  for help with what to #include for sysconf()
-#define _POSIX_SOURCE
 #include <unistd.h>
+#include <time.h> // clock_gettime()
 
-namespace codesaru {
+namespace Core {
 
 // thanks to http://en.wikipedia.org/wiki/Page_(computer_memory)
 //  for C-based examples on how to do this
-int32_t GetSystemPageSize(void) {
-  return static_cast<int32_t>(sysconf(_SC_PAGESIZE));
+int GetSystemPageSize(void) {
+  return static_cast<int>(sysconf(_SC_PAGESIZE));
+}
+
+
+std::uint64_t GetPerformanceCounter () {
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return std::uint64_t(now.tv_sec) * 1000000000ull + std::uint64_t(now.tv_nsec);
+}
+
+
+std::uint64_t GetPerformanceFrequency () {
+    return 1000000000ull;
+}
+
+
+FILE * OpenFile (const char * filepath, const char * mode) {
+    return fopen(filepath, mode);
 }
 
-} // namespace codesaru
+} // namespace Core
 
 #endif
@@ -48,6 +48,28 @@ bool GenerateUuidV4 (Uuid * uuid) {
     return true;
 }
 
+
+std::uint64_t GetPerformanceCounter () {
+    LARGE_INTEGER count;
+    QueryPerformanceCounter(&count);
+    return std::uint64_t(count.QuadPart);
+}
+
+
+std::uint64_t GetPerformanceFrequency () {
+    LARGE_INTEGER frequency;
+    QueryPerformanceFrequency(&frequency);
+    return std::uint64_t(frequency.QuadPart);
+}
+
+
+FILE * OpenFile (const char * filepath, const char * mode) {
+    FILE * file;
+    if (fopen_s(&file, filepath, mode))
+        return nullptr;
+    return file;
+}
+
 } // namespace Core
 
 // clean up after ourselves
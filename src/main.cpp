@@ -2,6 +2,7 @@
 #define NOMINMAX
 #include <Windows.h>
 #include <memory> // std::auto_ptr<>
+#include <wchar.h> // wcsstr
 #include "Dx11DemoBase.hpp"
 
 //#include "BlankDemo.hpp"
@@ -13,7 +14,7 @@
 LRESULT CALLBACK WndProc(HWND hwnd, UINT message, WPARAM wParam, LPARAM lParam);
 
 
-int WINAPI wWinMain(HINSTANCE instance, HINSTANCE /*prev_instance*/, LPWSTR /*command_line*/, int command_show)
+int WINAPI wWinMain(HINSTANCE instance, HINSTANCE /*prev_instance*/, LPWSTR command_line, int command_show)
 {
   //
   // Windows window registration/creation
@@ -45,7 +46,9 @@ int WINAPI wWinMain(HINSTANCE instance, HINSTANCE /*prev_instance*/, LPWSTR /*co
   
   ShowWindow(hwnd, command_show);
   
-  std::auto_ptr<Dx11DemoBase> demo(new GameSpriteDemo());
+  // -threaded steps the simulation on its own thread (no hot reload there).
+  const bool threaded = command_line && wcsstr(command_line, L"-threaded") != NULL;
+  std::auto_ptr<Dx11DemoBase> demo(new GameSpriteDemo(threaded));
   
   // Demo Initialize
   bool result = demo->Initialize(instance, hwnd);
@@ -0,0 +1,150 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Christopher Higgins Barrett
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "GameObject.h"
+#include "GameObjectComponent.h"
+#include "Headless/HeadlessAgam.h"
+#include "Levels/LevelCollision.hpp"
+#include "ScratchComponents.h"
+#include "ActionGameAlgorithmManiaxComponents.h"
+
+#include <cmath>
+
+#include "TestCheck.h"
+#include "TestLevel.h"
+
+namespace {
+
+const char     s_levelPath[] = "AgamCollisionTests.json";
+const unsigned s_width       = 64;
+const unsigned s_height      = 16;
+
+// A one-row BottomHalf strip from s_stripColumn rightward; nothing else, so
+// whatever misses it falls forever.
+const unsigned s_stripRow    = 10;
+const unsigned s_stripColumn = 20;
+const float    s_stripTop    = float((s_stripRow - 1) * Test::s_tileSize) + 0.5f * Test::s_tileSize;
+const float    s_stripBottom = float((s_stripRow - 1) * Test::s_tileSize);
+
+//==============================================================================
+class HoldRightSource final : public IGamepadSource {
+public:
+    bool NextState (GamepadState * stateOut) override {
+        *stateOut            = GamepadState();
+        stateOut->leftStickX = 32767;
+        return true;
+    }
+};
+
+//==============================================================================
+bool BuildStripLevel (Level * levelOut) {
+
+    std::vector<Level::ETileCollision> collisions(2);
+    collisions[1] = Level::ETileCollision::BottomHalf;
+
+    std::vector<unsigned short> tiles(s_width * s_height, 0);
+    for (unsigned x = s_stripColumn; x < s_width; ++x)
+        tiles[s_stripRow * s_width + x] = 1;
+
+    return Test::BuildLevel(s_levelPath, s_width, s_height, collisions, tiles, levelOut);
+
+}
+
+//==============================================================================
+// Dashes a quarter-scale (8x12) sprite right at full speed off a ledge 46
+// units above the strip, ticking at 2 Hz.  In the first tick the dash covers
+// 150 units and falls 90 along its chord; the arc reaches the strip's edge
+// still above it, the chord already below.  Returns the final position.
+Vec3 DashOntoStrip (const LevelCollision & collision, unsigned substepBudget, unsigned tickCount) {
+
+    Spritesheet sheet;
+    BuildAgamSheet(&sheet);
+
+    HoldRightSource source;
+    GameObject      object;
+    GocGamepad      gamepad;
+    GocSprite       sprite;
+    GocLeverDashMan dash;
+    gamepad.SetSource(&source);
+    object.AddComponent(&gamepad);
+    object.AddComponent(&sprite);
+    object.AddComponent(&dash);
+    sprite.GetSprite().SetSheet(&sheet);
+    sprite.ClearAnimLookups();
+    dash.SetSubstepBudget(substepBudget);
+
+    const float boxHeight = 48.0f * 0.25f;
+    object.GetTransform().SetScale(Vec3(0.25f, 0.25f, 1.0f));
+    object.GetTransform().SetPosition(Vec3(190.0f, s_stripTop + 46.0f + boxHeight, 0.0f));
+    object.GetTransform().SetVelocity(5.0f, 0.0f);
+
+    LevelCollision::SetActive(&collision);
+    for (unsigned tick = 0; tick < tickCount; ++tick)
+        object.Update(0.5f);
+    LevelCollision::SetActive(nullptr);
+
+    const Vec3 pos = object.GetTransform().GetPosition();
+    object.RemoveComponent(&dash);
+    object.RemoveComponent(&sprite);
+    object.RemoveComponent(&gamepad);
+
+    return pos;
+
+}
+
+//==============================================================================
+void TestDashLandsOnStrip (const LevelCollision & collision) {
+
+    const float boxHeight = 48.0f * 0.25f;
+
+    // Sub-stepped, the sprite follows its arc onto the strip and runs along it.
+    const Vec3 landed = DashOntoStrip(collision, 8, 3);
+    CHECK(fabsf(landed.y - boxHeight - s_stripTop) < 1e-3f);
+    CHECK(landed.x > float(s_stripColumn * Test::s_tileSize));
+
+    // One sweep per tick follows the chord under the strip's edge.
+    const Vec3 tunneled = DashOntoStrip(collision, 1, 3);
+    CHECK(tunneled.y < s_stripBottom);
+
+}
+
+} // namespace
+
+//==============================================================================
+int main () {
+
+    Level level;
+    CHECK(BuildStripLevel(&level));
+
+    LevelCollision collision;
+    collision.Bind(level, Transform());
+    CHECK(collision.IsBound());
+    if (collision.IsBound())
+        TestDashLandsOnStrip(collision);
+
+    Test::RemoveLevel(s_levelPath);
+
+    return TEST_RESULT();
+
+}
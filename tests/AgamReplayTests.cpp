@@ -0,0 +1,203 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Christopher Higgins Barrett
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "GameObject.h"
+#include "GameObjectComponent.h"
+#include "Components/ComponentStore.h"
+#include "Headless/HeadlessAgam.h"
+#include "Levels/LevelCollision.hpp"
+#include "Simulation/FixedStepRunner.h"
+#include "Simulation/GameObjectSimulation.h"
+#include "ScratchComponents.h"
+#include "ActionGameAlgorithmManiaxComponents.h"
+
+#include <memory>
+
+#include "TestCheck.h"
+#include "TestLevel.h"
+
+namespace {
+
+const char     s_levelPath[] = "AgamReplayTests.json";
+const unsigned s_playerCount = 16;
+const unsigned s_stepCount   = 600;
+const unsigned s_levelWidth  = 64;
+const unsigned s_levelHeight = 16;
+
+//==============================================================================
+// A walled box for the players: a solid floor along row 1 (world y 0..16 in
+// level space), solid walls in the outer columns, and a few BottomHalf
+// ledges to land on.
+bool BuildArena (Level * levelOut) {
+
+    std::vector<Level::ETileCollision> collisions(3);
+    collisions[1] = Level::ETileCollision::Solid;
+    collisions[2] = Level::ETileCollision::BottomHalf;
+
+    std::vector<unsigned short> tiles(s_levelWidth * s_levelHeight, 0);
+    for (unsigned x = 0; x < s_levelWidth; ++x)
+        tiles[1 * s_levelWidth + x] = 1;
+    for (unsigned y = 1; y < s_levelHeight; ++y) {
+        tiles[y * s_levelWidth]                    = 1;
+        tiles[y * s_levelWidth + s_levelWidth - 1] = 1;
+    }
+    for (unsigned x = 8; x < s_levelWidth - 8; x += 12) {
+        for (unsigned i = 0; i < 4; ++i)
+            tiles[(3 + x % 3) * s_levelWidth + x + i] = 2;
+    }
+
+    return Test::BuildLevel(s_levelPath, s_levelWidth, s_levelHeight, collisions, tiles, levelOut);
+
+}
+
+//==============================================================================
+// Steps s_playerCount AGAM players from originX for s_stepCount ticks.  Each
+// player plays seeded synthetic input and records it into logs[i], or, with
+// replay set, plays logs[i] back.  With a collision they collide with its
+// level instead of the implicit floor.  Returns every body's GetStateHash.
+std::vector<unsigned> RunPlayers (
+    float                     originX,
+    const LevelCollision *    collision,
+    std::vector<GamepadLog> * logs,
+    bool                      replay
+) {
+
+    Spritesheet sheet;
+    BuildAgamSheet(&sheet);
+
+    std::vector<std::unique_ptr<IGamepadSource>> sources;
+    std::vector<GameObject>                      objects(s_playerCount);
+    ComponentStore                               store;
+    GameObjectSimulation                         simulation;
+
+    RegisterAgamPools(&store);
+    simulation.SetComponentStore(&store);
+
+    for (unsigned i = 0; i < s_playerCount; ++i) {
+        if (replay)
+            sources.emplace_back(new GamepadReplaySource(&(*logs)[i]));
+        else
+            sources.emplace_back(new SyntheticGamepadSource(i + 1));
+
+        GocGamepad * gamepad = CreateAgamPlayer(&store, &objects[i], &sheet, sources.back().get());
+        if (!replay)
+            gamepad->SetRecordLog(&(*logs)[i]);
+
+        const float startY = collision ? 80.0f : 0.0f;
+        objects[i].GetTransform().SetPosition(Vec3(originX + float(i * 40), startY + float(i % 5) * 16.0f, 0.0f));
+        objects[i].GetTransform().SetVelocity(float(i % 7) * 0.25f - 0.75f, 0.0f);
+    }
+
+    LevelCollision::SetActive(collision);
+    FixedStepRunner runner(&simulation, 1.0f / float(GocAgamBody::s_tickRate));
+    runner.RunSteps(s_stepCount);
+    LevelCollision::SetActive(nullptr);
+
+    // Every player is still inside the arena, standing on or above its floor.
+    if (collision) {
+        for (GameObject & object : objects) {
+            const Vec3 pos = object.GetTransform().GetPosition();
+            CHECK(pos.x > originX - 113.0f && pos.x < originX - 128.0f + float((s_levelWidth - 1) * Test::s_tileSize));
+            CHECK(pos.y > 16.0f + 48.0f - 0.1f);
+        }
+    }
+
+    std::vector<unsigned> hashes;
+    for (GameObject & object : objects)
+        hashes.push_back(object.GetComponent<GocAgamBody>()->GetStateHash());
+
+    return hashes;
+
+}
+
+//==============================================================================
+// Without a level this holds across builds too; with one, only on the same
+// build (see GocAgamBody).
+void TestReplayMatchesRecording (float originX, const LevelCollision * collision) {
+
+    std::vector<GamepadLog> logs(s_playerCount);
+    const std::vector<unsigned> recorded = RunPlayers(originX, collision, &logs, false);
+    const std::vector<unsigned> replayed = RunPlayers(originX, collision, &logs, true);
+
+    for (unsigned i = 0; i < s_playerCount; ++i) {
+        CHECK(logs[i].GetFrameCount() == s_stepCount);
+        CHECK(recorded[i] == replayed[i]);
+    }
+
+    // The synthetic players actually moved apart, so the hashes mean something.
+    bool anyDiffer = false;
+    for (unsigned i = 1; i < s_playerCount; ++i)
+        anyDiffer |= recorded[i] != recorded[0];
+    CHECK(anyDiffer);
+
+}
+
+//==============================================================================
+// Streamed levels run well past the 32768 units a 32-bit 16.16 value holds.
+void TestFixedRange () {
+
+    const Fixed16 far  = Fixed16::FromInt(100000);
+    const Fixed16 half = Fixed16::FromRatio(1, 2);
+
+    CHECK((far + half).ToFloat() == 100000.5f);
+    CHECK((far * 3).ToFloat() == 300000.0f);
+    CHECK((far * half).ToFloat() == 50000.0f);
+    CHECK((far / Fixed16::FromInt(4)).ToFloat() == 25000.0f);
+    CHECK(Fixed16::FromFloat(-70000.25f).ToFloat() == -70000.25f);
+    CHECK((-far).Abs() == far);
+
+    // Products floor, so a negative half step rounds down, not toward zero.
+    CHECK(Fixed16::FromRaw(-1) * half == Fixed16::FromRaw(-1));
+    CHECK(Fixed16::FromRaw(3) * half == Fixed16::FromRaw(1));
+    CHECK(Fixed16::FromRatio(-7, 2) * Fixed16::FromRatio(3, 2) == Fixed16::FromRatio(-21, 4));
+
+}
+
+} // namespace
+
+//==============================================================================
+int main () {
+
+    TestFixedRange();
+    TestReplayMatchesRecording(0.0f, nullptr);
+    TestReplayMatchesRecording(60000.0f, nullptr);
+
+    // The same arena placed under each origin's players
+    Level level;
+    CHECK(BuildArena(&level));
+    for (float originX : { 0.0f, 60000.0f }) {
+        Transform levelTransform;
+        levelTransform.SetPosition(Vec3(originX - 128.0f, 0.0f, 0.0f));
+
+        LevelCollision collision;
+        collision.Bind(level, levelTransform);
+        CHECK(collision.IsBound());
+        if (collision.IsBound())
+            TestReplayMatchesRecording(originX, &collision);
+    }
+    Test::RemoveLevel(s_levelPath);
+
+    return TEST_RESULT();
+
+}
@@ -0,0 +1,167 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Christopher Higgins Barrett
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Render/AtlasPacker.h"
+#include "Render/SpritesheetDesc.h"
+#include "Render/SpritesheetFile.h"
+
+#include "TestCheck.h"
+
+namespace {
+
+//==============================================================================
+SpritesheetDesc MakeSheet (const char * name, unsigned frameSize, unsigned frameCount) {
+
+    SpritesheetDesc desc;
+    desc.name      = name;
+    desc.imageFile = std::string(name) + ".png";
+    desc.animations.resize(1);
+    desc.animations[0].name = "idle";
+    for (unsigned f = 0; f < frameCount; ++f) {
+        const SpritesheetFrameDesc frame = { f * frameSize, 0, frameSize, frameSize, 100 };
+        desc.animations[0].frames.push_back(frame);
+    }
+
+    return desc;
+
+}
+
+//==============================================================================
+// Empty frames (markers, hidden holds) have nothing to pack and mustn't fail
+// the sheet.
+void TestZeroSizedFramesAreSkipped () {
+
+    AtlasPacker::Settings settings;
+    settings.pageWidth           = 64;
+    settings.pageHeight          = 64;
+    settings.keepSourcesTogether = true;
+
+    SpritesheetDesc descs[] = { MakeSheet("a", 16, 3), MakeSheet("b", 8, 2) };
+    const SpritesheetFrameDesc empty = { 40, 40, 0, 0, 100 };
+    descs[0].animations[0].frames.push_back(empty);
+
+    AtlasPacker                         packer(settings);
+    std::vector<AtlasPacker::Frame>     frames;
+    std::vector<AtlasPacker::Placement> placements;
+    CHECK(PackSpritesheetDescs(&packer, descs, arrsize(descs), "atlas", &frames, &placements) == 1);
+    CHECK(frames.size() == 6);
+    CHECK(placements[3].page == AtlasPacker::s_unplaced);
+
+    const SpritesheetFrameDesc & emptyOut = descs[0].animations[0].frames[3];
+    CHECK(emptyOut.x == 0 && emptyOut.y == 0 && emptyOut.width == 0);
+    CHECK(descs[0].imageFile == "atlas-0.png");
+    CHECK(descs[1].imageFile == "atlas-0.png");
+
+    // Placed frames don't overlap.
+    for (unsigned i = 0; i < frames.size(); ++i) {
+        for (unsigned j = i + 1; j < frames.size(); ++j) {
+            if (placements[i].page == AtlasPacker::s_unplaced || placements[j].page == AtlasPacker::s_unplaced)
+                continue;
+            const bool apart =
+                placements[i].x + frames[i].width  <= placements[j].x ||
+                placements[j].x + frames[j].width  <= placements[i].x ||
+                placements[i].y + frames[i].height <= placements[j].y ||
+                placements[j].y + frames[j].height <= placements[i].y;
+            CHECK(apart);
+        }
+    }
+
+}
+
+//==============================================================================
+void TestOversizedFramesFailThePack () {
+
+    AtlasPacker::Settings settings;
+    settings.pageWidth           = 32;
+    settings.pageHeight          = 32;
+    settings.keepSourcesTogether = true;
+
+    SpritesheetDesc descs[] = { MakeSheet("big", 40, 1) };
+
+    AtlasPacker                         packer(settings);
+    std::vector<AtlasPacker::Frame>     frames;
+    std::vector<AtlasPacker::Placement> placements;
+    CHECK(!PackSpritesheetDescs(&packer, descs, arrsize(descs), "atlas", &frames, &placements));
+    CHECK(descs[0].imageFile == "big.png");
+
+}
+
+//==============================================================================
+void TestCompositeCopiesPlacedFrames () {
+
+    std::uint32_t sourceTexels[4 * 2];
+    for (unsigned i = 0; i < arrsize(sourceTexels); ++i)
+        sourceTexels[i] = i + 1;
+
+    std::uint32_t pageTexels[8 * 8] = {};
+
+    const AtlasImage             source    = { sourceTexels, 4, 2, 4 };
+    AtlasImage                   page      = { pageTexels, 8, 8, 8 };
+    const AtlasPacker::Frame     frame     = { 0, 1, 0, 2, 2 };
+    const AtlasPacker::Placement placement = { 0, 5, 3 };
+    CompositeAtlasPage(0, &frame, &placement, 1, &source, &page);
+
+    CHECK(pageTexels[3 * 8 + 5] == 2);
+    CHECK(pageTexels[3 * 8 + 6] == 3);
+    CHECK(pageTexels[4 * 8 + 5] == 6);
+    CHECK(pageTexels[4 * 8 + 6] == 7);
+    CHECK(pageTexels[3 * 8 + 4] == 0);
+
+}
+
+//==============================================================================
+// Also leaves cooked sheets behind for the atlas-cook test (see
+// CMakeLists.txt).  The datafiles can't be parsed here, so LoadDesc reads
+// the cooked files.
+void TestLoadDescReadsCookedSheets () {
+
+    const char * const     paths[] = { "AtlasPackerTests-a.json", "AtlasPackerTests-b.json" };
+    const SpritesheetDesc  descs[] = { MakeSheet("a", 16, 3), MakeSheet("b", 24, 2) };
+    for (unsigned i = 0; i < arrsize(paths); ++i) {
+        CHECK(SpritesheetFile::Write(SpritesheetFile::GetCookedPath(paths[i]).c_str(), descs[i], 0));
+
+        SpritesheetDesc loaded;
+        CHECK(SpritesheetFile::LoadDesc(paths[i], &loaded));
+        CHECK(loaded.name == descs[i].name);
+        CHECK(loaded.GetFrameCount() == descs[i].GetFrameCount());
+    }
+
+    SpritesheetDesc missing;
+    CHECK(!SpritesheetFile::LoadDesc("AtlasPackerTests-missing.json", &missing));
+
+}
+
+} // namespace
+
+//==============================================================================
+int main () {
+
+    TestZeroSizedFramesAreSkipped();
+    TestOversizedFramesFailThePack();
+    TestCompositeCopiesPlacedFrames();
+    TestLoadDescReadsCookedSheets();
+
+    return TEST_RESULT();
+
+}
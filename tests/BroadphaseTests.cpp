@@ -0,0 +1,157 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Christopher Higgins Barrett
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Collision/Broadphase.h"
+
+#include "TestCheck.h"
+
+namespace {
+
+//==============================================================================
+WorldRect MakeRect (float minX, float minY, float size) {
+
+    const WorldRect rect = { minX, minY, minX + size, minY + size };
+    return rect;
+
+}
+
+//==============================================================================
+bool HasPair (const std::vector<Broadphase::Pair> & pairs, Broadphase::ProxyId a, Broadphase::ProxyId b) {
+
+    for (const Broadphase::Pair & pair : pairs) {
+        if (pair.a == MIN(a, b) && pair.b == MAX(a, b))
+            return true;
+    }
+
+    return false;
+
+}
+
+//==============================================================================
+bool HasProxy (const std::vector<Broadphase::ProxyId> & proxies, Broadphase::ProxyId proxy) {
+    return std::find(proxies.begin(), proxies.end(), proxy) != proxies.end();
+}
+
+//==============================================================================
+void TestPairsAcrossCells () {
+
+    Broadphase                    broadphase(64.0f);
+    std::vector<Broadphase::Pair> pairs;
+
+    // Overlap spans four cells; the pair must still come out once.
+    const Broadphase::ProxyId a = broadphase.CreateProxy(MakeRect(40.0f, 40.0f, 40.0f), nullptr);
+    const Broadphase::ProxyId b = broadphase.CreateProxy(MakeRect(50.0f, 50.0f, 40.0f), nullptr);
+    const Broadphase::ProxyId c = broadphase.CreateProxy(MakeRect(500.0f, 500.0f, 10.0f), nullptr);
+    broadphase.Rebuild();
+    broadphase.FindPairs(&pairs);
+
+    CHECK(pairs.size() == 1);
+    CHECK(HasPair(pairs, a, b));
+    CHECK(!HasPair(pairs, a, c));
+
+}
+
+//==============================================================================
+void TestMovedProxiesUseIndexedBounds () {
+
+    Broadphase                    broadphase(64.0f);
+    std::vector<Broadphase::Pair> pairs;
+
+    const Broadphase::ProxyId a = broadphase.CreateProxy(MakeRect(10.0f, 10.0f, 20.0f), nullptr);
+    const Broadphase::ProxyId b = broadphase.CreateProxy(MakeRect(20.0f, 20.0f, 20.0f), nullptr);
+    broadphase.Rebuild();
+
+    // Both move several cells without a Rebuild: the pair is still reported,
+    // as of where they were indexed.
+    broadphase.MoveProxy(a, MakeRect(310.0f, 310.0f, 20.0f));
+    broadphase.MoveProxy(b, MakeRect(320.0f, 320.0f, 20.0f));
+    broadphase.FindPairs(&pairs);
+    CHECK(pairs.size() == 1 && HasPair(pairs, a, b));
+
+    std::vector<Broadphase::ProxyId> proxies;
+    broadphase.QueryRegion(MakeRect(0.0f, 0.0f, 32.0f), &proxies);
+    CHECK(proxies.size() == 2);
+
+    broadphase.Rebuild();
+    broadphase.FindPairs(&pairs);
+    CHECK(pairs.size() == 1 && HasPair(pairs, a, b));
+
+    broadphase.QueryRegion(MakeRect(0.0f, 0.0f, 32.0f), &proxies);
+    CHECK(proxies.empty());
+    broadphase.QueryRegion(MakeRect(300.0f, 300.0f, 32.0f), &proxies);
+    CHECK(proxies.size() == 2);
+
+    // Moves within the listed cells skip re-indexing but are still seen.
+    broadphase.MoveProxy(b, MakeRect(345.0f, 345.0f, 20.0f));
+    broadphase.Rebuild();
+    broadphase.FindPairs(&pairs);
+    CHECK(pairs.empty());
+
+}
+
+//==============================================================================
+void TestCreateAndDestroyBetweenRebuilds () {
+
+    Broadphase                       broadphase(64.0f);
+    std::vector<Broadphase::Pair>    pairs;
+    std::vector<Broadphase::ProxyId> proxies;
+
+    const Broadphase::ProxyId a = broadphase.CreateProxy(MakeRect(10.0f, 10.0f, 20.0f), nullptr);
+    const Broadphase::ProxyId b = broadphase.CreateProxy(MakeRect(20.0f, 20.0f, 20.0f), nullptr);
+    broadphase.Rebuild();
+
+    // A destroyed proxy drops out at once, even if its slot is reused.
+    broadphase.DestroyProxy(b);
+    broadphase.FindPairs(&pairs);
+    CHECK(pairs.empty());
+
+    const Broadphase::ProxyId c = broadphase.CreateProxy(MakeRect(15.0f, 15.0f, 20.0f), nullptr);
+    broadphase.FindPairs(&pairs);
+    CHECK(pairs.empty());
+    broadphase.QueryRegion(MakeRect(0.0f, 0.0f, 64.0f), &proxies);
+    CHECK(proxies.size() == 1 && HasProxy(proxies, a));
+
+    // Wider than the index, so answered by brute force; same rules.
+    broadphase.QueryRegion(MakeRect(-10000.0f, -10000.0f, 20000.0f), &proxies);
+    CHECK(proxies.size() == 1 && HasProxy(proxies, a));
+
+    broadphase.Rebuild();
+    broadphase.FindPairs(&pairs);
+    CHECK(pairs.size() == 1 && HasPair(pairs, a, c));
+    CHECK(broadphase.GetProxyCount() == 2);
+
+}
+
+} // namespace
+
+//==============================================================================
+int main () {
+
+    TestPairsAcrossCells();
+    TestMovedProxiesUseIndexedBounds();
+    TestCreateAndDestroyBetweenRebuilds();
+
+    return TEST_RESULT();
+
+}
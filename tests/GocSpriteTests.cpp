@@ -0,0 +1,101 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Christopher Higgins Barrett
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "GameObject.h"
+#include "Render/SpritesheetDesc.h"
+#include "Render/SpritesheetFile.h"
+#include "ScratchComponents.h"
+
+#include "TestCheck.h"
+
+namespace {
+
+// This build can't parse the datafile, so sheets load from its cooked file.
+const char s_datafilePath[] = "GocSpriteTests.json";
+
+//==============================================================================
+bool WriteSheet (const char * const * animNames, unsigned animCount) {
+
+    SpritesheetDesc desc;
+    desc.name = "test";
+    desc.animations.resize(animCount);
+    for (unsigned a = 0; a < animCount; ++a) {
+        desc.animations[a].name = animNames[a];
+        const SpritesheetFrameDesc frame = { 0, a * 16, 16, 16, 100 };
+        desc.animations[a].frames.push_back(frame);
+    }
+
+    return SpritesheetFile::Write(SpritesheetFile::GetCookedPath(s_datafilePath).c_str(), desc, 0);
+
+}
+
+//==============================================================================
+// Both sprites share the cached sheet; reloading it through one must not
+// leave the other with the old animation indices.
+void TestReloadInvalidatesSharedLookups () {
+
+    const AnimName      idle("idle");
+    const AnimName      run("run");
+    const char * const  before[] = { "idle", "run" };
+    const char * const  after[]  = { "run", "jump", "idle" };
+    CHECK(WriteSheet(before, arrsize(before)));
+
+    GameObject objects[2];
+    GocSprite  sprites[2];
+    for (unsigned i = 0; i < 2; ++i) {
+        objects[i].AddComponent(&sprites[i]);
+        CHECK(sprites[i].BuildFromDatafile(s_datafilePath));
+        CHECK(sprites[i].TrySetAnim(run));
+        CHECK(sprites[i].GetSprite().GetAnimationIndex() == 1);
+    }
+    CHECK(sprites[0].GetSprite().GetSheet() == sprites[1].GetSprite().GetSheet());
+
+    CHECK(WriteSheet(after, arrsize(after)));
+    CHECK(sprites[0].RebuildFromDatafile());
+
+    CHECK(sprites[1].TrySetAnim(run));
+    CHECK(sprites[1].GetSprite().GetAnimationIndex() == 0);
+    CHECK(sprites[1].TrySetAnim(idle));
+    CHECK(sprites[1].GetSprite().GetAnimationIndex() == 2);
+    CHECK(sprites[0].TrySetAnim(idle));
+    CHECK(sprites[0].GetSprite().GetAnimationIndex() == 2);
+
+    for (unsigned i = 0; i < 2; ++i)
+        objects[i].RemoveComponent(&sprites[i]);
+    g_graphicsMgr->Shutdown();
+
+}
+
+} // namespace
+
+//==============================================================================
+int main () {
+
+    TestReloadInvalidatesSharedLookups();
+
+    remove(SpritesheetFile::GetCookedPath(s_datafilePath).c_str());
+
+    return TEST_RESULT();
+
+}
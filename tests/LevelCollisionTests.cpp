@@ -0,0 +1,292 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Christopher Higgins Barrett
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "GameObject.h"
+#include "GameObjectComponent.h"
+#include "Jobs/JobSystem.h"
+#include "Levels/LevelCollision.hpp"
+#include "ScratchComponents.h"
+
+#include <cmath>
+#include <cstdint>
+
+#include "TestCheck.h"
+#include "TestLevel.h"
+
+namespace {
+
+const char     s_levelPath[] = "LevelCollisionTests.json";
+const unsigned s_width       = 20;
+const unsigned s_height      = 8;
+
+// Legend keys
+const unsigned short s_empty = 0;
+const unsigned short s_solid = 1;
+const unsigned short s_half  = 2;
+
+//==============================================================================
+bool Near (float a, float b) {
+    return fabsf(a - b) < 1e-4f;
+}
+
+//==============================================================================
+// 16 unit tiles at the origin, so row y covers [16y-16, 16y):
+//   row 1         solid floor, top at 0..16
+//   column 10     solid wall over rows 2-5, x 160..176, y 16..80
+//   tile (4, 3)   BottomHalf, x 64..80, y 32..40
+bool BuildTestLevel (Level * levelOut) {
+
+    std::vector<Level::ETileCollision> collisions(3);
+    collisions[s_empty] = Level::ETileCollision::None;
+    collisions[s_solid] = Level::ETileCollision::Solid;
+    collisions[s_half]  = Level::ETileCollision::BottomHalf;
+
+    std::vector<unsigned short> tiles(s_width * s_height, s_empty);
+    for (unsigned x = 0; x < s_width; ++x)
+        tiles[1 * s_width + x] = s_solid;
+    for (unsigned y = 2; y <= 5; ++y)
+        tiles[y * s_width + 10] = s_solid;
+    tiles[3 * s_width + 4] = s_half;
+
+    return Test::BuildLevel(s_levelPath, s_width, s_height, collisions, tiles, levelOut);
+
+}
+
+//==============================================================================
+WorldRect MakeBox (float minX, float minY, float width, float height) {
+    const WorldRect box = { minX, minY, minX + width, minY + height };
+    return box;
+}
+
+//==============================================================================
+void TestPointAndRay (const LevelCollision & collision) {
+
+    CHECK(collision.QueryPoint(8.0f, 8.0f) == Level::ETileCollision::Solid);
+    CHECK(collision.QueryPoint(8.0f, 20.0f) == Level::ETileCollision::None);
+    CHECK(collision.QueryPoint(165.0f, 70.0f) == Level::ETileCollision::Solid);
+    CHECK(collision.QueryPoint(-5.0f, 8.0f) == Level::ETileCollision::None);
+
+    // Straight down onto the floor
+    LevelCollision::Hit hit;
+    CHECK(collision.Raycast(8.0f, 60.0f, 0.0f, -100.0f, &hit));
+    CHECK(Near(hit.time, 0.44f));
+    CHECK(hit.normalX == 0.0f && hit.normalY == 1.0f);
+    CHECK(hit.tileX == 0 && hit.tileY == 1);
+    CHECK(hit.collision == Level::ETileCollision::Solid);
+
+    // Right into the wall's face
+    CHECK(collision.Raycast(100.0f, 40.0f, 100.0f, 0.0f, &hit));
+    CHECK(Near(hit.time, 0.6f));
+    CHECK(hit.normalX == -1.0f && hit.normalY == 0.0f);
+    CHECK(hit.tileX == 10 && hit.tileY == 3);
+
+    // Short of the wall, and over the top of it
+    CHECK(!collision.Raycast(100.0f, 40.0f, 50.0f, 0.0f, &hit));
+    CHECK(hit.collision == Level::ETileCollision::None);
+    CHECK(!collision.Raycast(100.0f, 90.0f, 100.0f, 0.0f, &hit));
+
+}
+
+//==============================================================================
+// Only the lower half of a BottomHalf cell blocks.
+void TestBottomHalf (const LevelCollision & collision) {
+
+    CHECK(collision.QueryPoint(70.0f, 36.0f) == Level::ETileCollision::BottomHalf);
+    CHECK(collision.QueryPoint(70.0f, 44.0f) == Level::ETileCollision::None);
+
+    LevelCollision::Hit hit;
+    CHECK(collision.Raycast(72.0f, 60.0f, 0.0f, -40.0f, &hit));
+    CHECK(Near(hit.time, 0.5f));
+    CHECK(hit.normalY == 1.0f);
+    CHECK(hit.tileX == 4 && hit.tileY == 3);
+    CHECK(hit.collision == Level::ETileCollision::BottomHalf);
+
+    // A box over the half passes; one level with it stops at its side.
+    CHECK(!collision.SweepBox(MakeBox(50.0f, 41.0f, 8.0f, 6.0f), 40.0f, 0.0f, &hit));
+    CHECK(collision.SweepBox(MakeBox(50.0f, 33.0f, 8.0f, 6.0f), 40.0f, 0.0f, &hit));
+    CHECK(Near(hit.time, 0.15f));
+    CHECK(hit.normalX == -1.0f);
+    CHECK(hit.collision == Level::ETileCollision::BottomHalf);
+
+}
+
+//==============================================================================
+void TestMoveAndSlide (const LevelCollision & collision) {
+
+    // Diagonally into the wall: x stops at its face, y carries on up it.
+    LevelCollision::MoveResult move;
+    collision.MoveAndSlide(MakeBox(140.0f, 30.0f, 8.0f, 8.0f), 30.0f, 20.0f, &move);
+    CHECK(Near(move.dx, 12.0f));
+    CHECK(Near(move.dy, 20.0f));
+    CHECK(move.blockedX && !move.blockedY && !move.grounded);
+
+    // Diagonally onto the floor: lands, then slides along it.
+    collision.MoveAndSlide(MakeBox(20.0f, 20.0f, 8.0f, 8.0f), 10.0f, -40.0f, &move);
+    CHECK(Near(move.dx, 10.0f));
+    CHECK(Near(move.dy, -4.0f));
+    CHECK(!move.blockedX && move.blockedY && move.grounded);
+
+    // Resting on the floor and running into the wall's foot.
+    collision.MoveAndSlide(MakeBox(140.0f, 16.0f, 8.0f, 8.0f), 30.0f, 0.0f, &move);
+    CHECK(Near(move.dx, 12.0f));
+    CHECK(move.dy == 0.0f);
+    CHECK(move.blockedX && !move.grounded);
+
+    // Nothing in the way
+    collision.MoveAndSlide(MakeBox(20.0f, 60.0f, 8.0f, 8.0f), 30.0f, 5.0f, &move);
+    CHECK(move.dx == 30.0f && move.dy == 5.0f);
+    CHECK(!move.blockedX && !move.blockedY);
+
+}
+
+//==============================================================================
+void TestProbeGround (const LevelCollision & collision) {
+
+    float distance = -1.0f;
+    CHECK(collision.ProbeGround(MakeBox(20.0f, 19.0f, 8.0f, 8.0f), 5.0f, &distance));
+    CHECK(Near(distance, 3.0f));
+    CHECK(!collision.ProbeGround(MakeBox(20.0f, 19.0f, 8.0f, 8.0f), 2.0f, &distance));
+
+    CHECK(collision.ProbeGround(MakeBox(20.0f, 16.0f, 8.0f, 8.0f), 5.0f, &distance));
+    CHECK(distance == 0.0f);
+
+    CHECK(collision.ProbeGround(MakeBox(66.0f, 42.0f, 8.0f, 8.0f), 4.0f, &distance));
+    CHECK(Near(distance, 2.0f));
+
+    // Ceilings aren't ground.
+    CHECK(!collision.ProbeGround(MakeBox(20.0f, 100.0f, 8.0f, 8.0f), 5.0f, &distance));
+
+}
+
+//==============================================================================
+bool HitsEqual (const LevelCollision::Hit & a, const LevelCollision::Hit & b) {
+    return
+        a.time == b.time &&
+        a.normalX == b.normalX &&
+        a.normalY == b.normalY &&
+        a.tileX == b.tileX &&
+        a.tileY == b.tileY &&
+        a.collision == b.collision;
+}
+
+//==============================================================================
+// SweepBoxes and SweepBoxesParallel answer exactly what one SweepBox per box
+// would, whatever the batching.
+void TestBatchedSweepsMatchSingle (const LevelCollision & collision) {
+
+    const unsigned sweepCount = 1000;
+
+    std::vector<LevelCollision::BoxSweep> sweeps(sweepCount);
+    std::uint32_t                         seed = 12345;
+    for (LevelCollision::BoxSweep & sweep : sweeps) {
+        float values[6];
+        for (float & value : values) {
+            seed  = seed * 1664525u + 1013904223u;
+            value = float(seed >> 8) / float(1 << 24);
+        }
+        sweep.box = MakeBox(
+            values[0] * float(s_width * Test::s_tileSize),
+            values[1] * float(s_height * Test::s_tileSize),
+            1.0f + values[2] * 20.0f,
+            1.0f + values[3] * 20.0f
+        );
+        sweep.dx = (values[4] - 0.5f) * 120.0f;
+        sweep.dy = (values[5] - 0.5f) * 120.0f;
+    }
+
+    std::vector<LevelCollision::Hit> single(sweepCount);
+    unsigned                         hitCount = 0;
+    for (unsigned i = 0; i < sweepCount; ++i)
+        hitCount += collision.SweepBox(sweeps[i].box, sweeps[i].dx, sweeps[i].dy, &single[i]);
+    // Enough of both outcomes for the comparison to mean something.
+    CHECK(hitCount > sweepCount / 10 && hitCount < sweepCount / 2);
+
+    std::vector<LevelCollision::Hit> batched(sweepCount);
+    collision.SweepBoxes(sweeps.data(), sweepCount, batched.data());
+
+    JobSystem                        jobs(4);
+    std::vector<LevelCollision::Hit> parallel(sweepCount);
+    collision.SweepBoxesParallel(jobs, sweeps.data(), sweepCount, parallel.data(), 7);
+
+    for (unsigned i = 0; i < sweepCount; ++i) {
+        CHECK(HitsEqual(batched[i], single[i]));
+        CHECK(HitsEqual(parallel[i], single[i]));
+    }
+
+}
+
+//==============================================================================
+// GocLevel binds its collision as the active one while its level has a tile
+// size, and clears it when destroyed.
+void TestGocLevelSetsActiveCollision () {
+
+    CHECK(LevelCollision::GetActive() == nullptr);
+
+    {
+        GameObject object;
+        GocLevel   levelComp;
+        object.AddComponent(&levelComp);
+        object.GetTransform().SetPosition(Vec3(32.0f, 0.0f, 0.0f));
+        CHECK(levelComp.LoadLevel(s_levelPath));
+
+        object.Update(1.0f / 60.0f);
+        const LevelCollision * collision = LevelCollision::GetActive();
+        CHECK(collision == &levelComp.GetCollision());
+        CHECK(collision && collision->QueryPoint(40.0f, 8.0f) == Level::ETileCollision::Solid);
+        CHECK(collision && collision->QueryPoint(8.0f, 8.0f) == Level::ETileCollision::None);
+
+        object.RemoveComponent(&levelComp);
+    }
+
+    CHECK(LevelCollision::GetActive() == nullptr);
+
+}
+
+} // namespace
+
+//==============================================================================
+int main () {
+
+    Level level;
+    CHECK(BuildTestLevel(&level));
+
+    LevelCollision collision;
+    collision.Bind(level, Transform());
+    CHECK(collision.IsBound());
+    CHECK(collision.GetCellWidth() == 16.0f && collision.GetCellHeight() == 16.0f);
+
+    if (collision.IsBound()) {
+        TestPointAndRay(collision);
+        TestBottomHalf(collision);
+        TestMoveAndSlide(collision);
+        TestProbeGround(collision);
+        TestBatchedSweepsMatchSingle(collision);
+        TestGocLevelSetsActiveCollision();
+    }
+
+    Test::RemoveLevel(s_levelPath);
+
+    return TEST_RESULT();
+
+}
@@ -0,0 +1,296 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Christopher Higgins Barrett
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Levels/Level.hpp"
+#include "Levels/LevelFile.hpp"
+#include "MappedFile.h"
+#include "Render/SpritesheetFile.h"
+
+#include "TestCheck.h"
+
+#include <cstddef>
+
+namespace {
+
+const char s_datafilePath[] = "LevelFileTests.json";
+const char s_cookedPath[]   = "LevelFileTests.clvl";
+const char s_tilesetPath[]  = "LevelFileTests-tiles.json";
+
+const char s_cookDatafilePath[]  = "LevelFileTests-cook.json";
+const char s_corruptCookedPath[] = "LevelFileTests-corrupt.clvl";
+
+//==============================================================================
+// Legend entries without a sprite file load no graphics, so these levels
+// build headless.
+void MakeLevel (Level::Desc * descOut, std::vector<unsigned short> * tilesOut) {
+
+    descOut->name   = L"test";
+    descOut->width  = 40;
+    descOut->height = 3;
+    descOut->legend.resize(2);
+
+    tilesOut->assign(descOut->width * descOut->height, 0);
+    (*tilesOut)[2]  = 1;
+    (*tilesOut)[35] = 1;
+
+}
+
+//==============================================================================
+bool WriteDatafile (const char * contents) {
+
+    FILE * file = Core::OpenFile(s_datafilePath, "wb");
+    if (!file)
+        return false;
+    const size_t length = strlen(contents);
+    const bool   ok     = fwrite(contents, 1, length, file) == length;
+    fclose(file);
+    return ok;
+
+}
+
+//==============================================================================
+void TestContentHashRoundTrips () {
+
+    Level::Desc                 desc;
+    std::vector<unsigned short> tiles;
+    MakeLevel(&desc, &tiles);
+    CHECK(LevelFile::Write(s_cookedPath, desc, tiles, 0x0123456789ABCDEFull));
+
+    Core::MappedFile          cooked;
+    const LevelFile::Header * header = nullptr;
+    if (cooked.Open(s_cookedPath))
+        header = LevelFile::Validate(cooked.GetData(), cooked.GetSize());
+
+    CHECK(header && header->version == LevelFile::s_version);
+    CHECK(header && header->contentHash == 0x0123456789ABCDEFull);
+
+}
+
+//==============================================================================
+void TestCookSkipsOnlyUnchangedDatafiles () {
+
+    // This build can't parse JSON, so CookDatafile only succeeds when it
+    // doesn't need to: when the cooked file matches the datafile's bytes.
+    const char original[] = "{ \"level\": 1 }";
+    CHECK(WriteDatafile(original));
+
+    Level::Desc                 desc;
+    std::vector<unsigned short> tiles;
+    MakeLevel(&desc, &tiles);
+    CHECK(LevelFile::Write(s_cookedPath, desc, tiles, Core::Fnv1aHash64(original, strlen(original))));
+    CHECK(Level::CookDatafile(s_datafilePath, s_cookedPath));
+
+    CHECK(WriteDatafile("{ \"level\": 2 }"));
+    CHECK(!Level::CookDatafile(s_datafilePath, s_cookedPath));
+
+}
+
+//==============================================================================
+void TestOutOfRangeLegendIndicesReadAsZero () {
+
+    Level::Desc                 desc;
+    std::vector<unsigned short> tiles;
+    MakeLevel(&desc, &tiles);
+    tiles[1]  = 7;
+    tiles[41] = 0xFFFF;
+    CHECK(LevelFile::Write(s_cookedPath, desc, tiles, 0));
+
+    Level level;
+    CHECK(level.BuildFromCookedFile(s_cookedPath));
+    CHECK(level.GetTileLegendIndex(1, 0) == 0);
+    CHECK(level.GetTileLegendIndex(1, 1) == 0);
+    CHECK(level.GetTileLegendIndex(2, 0) == 1);
+    CHECK(level.GetTileLegendIndex(35, 0) == 1);
+    CHECK(level.GetTileCollision(1, 1) == Level::ETileCollision::None);
+
+}
+
+//==============================================================================
+// Validates a copy of a good file with one header field overwritten.
+bool ValidatesWith (const std::vector<std::uint64_t> & file, size_t size, size_t fieldOffset, std::uint32_t value) {
+
+    std::vector<std::uint64_t> copy = file;
+    memcpy(reinterpret_cast<char *>(&copy[0]) + fieldOffset, &value, sizeof(value));
+    return LevelFile::Validate(&copy[0], size) != nullptr;
+
+}
+
+//==============================================================================
+// Every table is read in place, so an offset that's out of bounds, inside the
+// header or off its alignment must fail validation rather than be read.
+void TestCorruptHeadersAreRejected () {
+
+    Level::Desc                 desc;
+    std::vector<unsigned short> tiles;
+    MakeLevel(&desc, &tiles);
+    CHECK(LevelFile::Write(s_cookedPath, desc, tiles, 0));
+
+    // Copied into 8-byte-aligned storage so only the edits can misalign it.
+    std::vector<std::uint64_t> file;
+    size_t                     size = 0;
+    {
+        Core::MappedFile cooked;
+        CHECK(cooked.Open(s_cookedPath));
+        size = cooked.GetSize();
+        file.resize((size + 7) / 8);
+        if (size && size <= file.size() * sizeof(std::uint64_t))
+            memcpy(&file[0], cooked.GetData(), size);
+    }
+
+    const LevelFile::Header * header = LevelFile::Validate(file.empty() ? nullptr : &file[0], size);
+    CHECK(header != nullptr);
+    if (!header)
+        return;
+    const LevelFile::Header original = *header;
+
+    CHECK(!LevelFile::Validate(&file[0], sizeof(LevelFile::Header) - 1));
+    CHECK(!LevelFile::Validate(&file[0], original.stringTableOffset + original.stringTableSize - 1));
+
+    struct Case {
+        size_t        fieldOffset;
+        std::uint32_t value;
+    };
+    const Case cases[] = {
+        { offsetof(LevelFile::Header, magic),             0 },
+        { offsetof(LevelFile::Header, version),           LevelFile::s_version + 1 },
+        { offsetof(LevelFile::Header, chunksWide),        original.chunksWide + 1 },
+        { offsetof(LevelFile::Header, legendOffset),      original.legendOffset + 2 },      // Misaligned
+        { offsetof(LevelFile::Header, legendOffset),      0 },                              // Over the header
+        { offsetof(LevelFile::Header, legendOffset),      std::uint32_t(size) },            // Past the end
+        { offsetof(LevelFile::Header, chunkTableOffset),  original.chunkTableOffset + 2 },  // Misaligned
+        { offsetof(LevelFile::Header, chunkTableOffset),  4 },                              // Over the header
+        { offsetof(LevelFile::Header, chunkDataOffset),   original.chunkDataOffset + 8 },   // Off 16
+        { offsetof(LevelFile::Header, chunkDataCount),    0x10000000 },
+        { offsetof(LevelFile::Header, stringTableOffset), 0 },
+        { offsetof(LevelFile::Header, stringTableSize),   0 },
+        { offsetof(LevelFile::Header, nameString),        original.stringTableSize },
+    };
+    for (unsigned i = 0; i < arrsize(cases); ++i)
+        CHECK(!ValidatesWith(file, size, cases[i].fieldOffset, cases[i].value));
+
+    // Untouched, the copy still validates, and a corrupt file on disk
+    // doesn't build.
+    CHECK(ValidatesWith(file, size, offsetof(LevelFile::Header, legendOffset), original.legendOffset));
+
+    FILE * out = Core::OpenFile(s_cookedPath, "r+b");
+    CHECK(out != nullptr);
+    if (out) {
+        const std::uint32_t misaligned = original.chunkTableOffset + 2;
+        fseek(out, long(offsetof(LevelFile::Header, chunkTableOffset)), SEEK_SET);
+        fwrite(&misaligned, sizeof(misaligned), 1, out);
+        fclose(out);
+    }
+
+    Level level;
+    CHECK(!level.BuildFromCookedFile(s_cookedPath));
+
+}
+
+//==============================================================================
+// The tileset's datafile can't be parsed here, so both the sheet and the
+// legend's animation come from its cooked file.
+void TestLegendsResolveThroughCookedSheets () {
+
+    SpritesheetDesc tileset;
+    tileset.name = "tiles";
+    const char * const animNames[] = { "dirt", "grass", "stone" };
+    for (const char * animName : animNames) {
+        SpritesheetAnimDesc anim;
+        anim.name = animName;
+        const SpritesheetFrameDesc frame = { 0, 0, 16, 16, 0 };
+        anim.frames.push_back(frame);
+        tileset.animations.push_back(anim);
+    }
+    CHECK(SpritesheetFile::Write(SpritesheetFile::GetCookedPath(s_tilesetPath).c_str(), tileset, 0));
+
+    Level::Desc                 desc;
+    std::vector<unsigned short> tiles;
+    MakeLevel(&desc, &tiles);
+    for (unsigned i = 0; i < 2; ++i) {
+        desc.legend[i].spriteFile = s_tilesetPath;
+        desc.legend[i].anim       = i ? L"stone" : L"grass";
+    }
+    CHECK(LevelFile::Write(s_cookedPath, desc, tiles, 0));
+
+    Level level;
+    CHECK(level.BuildFromCookedFile(s_cookedPath));
+    CHECK(level.GetLegend(0).sprite.GetAnimationIndex() == 1);
+    CHECK(level.GetLegend(1).sprite.GetAnimationIndex() == 2);
+
+    float tileWidth  = 0.0f;
+    float tileHeight = 0.0f;
+    CHECK(level.GetTileSize(&tileWidth, &tileHeight) && tileWidth == 16.0f && tileHeight == 16.0f);
+
+    remove(SpritesheetFile::GetCookedPath(s_tilesetPath).c_str());
+
+}
+
+//==============================================================================
+// Leaves a datafile with a current cooked file, and a cooked file with a
+// misaligned chunk table, for the level-cook tests (see CMakeLists.txt).
+void LeaveLevelCookInputs () {
+
+    const char datafile[] = "{ \"level\": \"cook\" }";
+    FILE *     file       = Core::OpenFile(s_cookDatafilePath, "wb");
+    CHECK(file != nullptr);
+    if (!file)
+        return;
+    CHECK(fwrite(datafile, 1, strlen(datafile), file) == strlen(datafile));
+    fclose(file);
+
+    Level::Desc                 desc;
+    std::vector<unsigned short> tiles;
+    MakeLevel(&desc, &tiles);
+    CHECK(LevelFile::Write(LevelFile::GetCookedPath(s_cookDatafilePath).c_str(), desc, tiles, Core::Fnv1aHash64(datafile, strlen(datafile))));
+    CHECK(LevelFile::Write(s_corruptCookedPath, desc, tiles, 0));
+
+    file = Core::OpenFile(s_corruptCookedPath, "r+b");
+    CHECK(file != nullptr);
+    if (!file)
+        return;
+    const std::uint32_t misaligned = sizeof(LevelFile::Header) + 2;
+    fseek(file, long(offsetof(LevelFile::Header, chunkTableOffset)), SEEK_SET);
+    fwrite(&misaligned, sizeof(misaligned), 1, file);
+    fclose(file);
+
+}
+
+} // namespace
+
+//==============================================================================
+int main () {
+
+    TestContentHashRoundTrips();
+    TestCookSkipsOnlyUnchangedDatafiles();
+    TestOutOfRangeLegendIndicesReadAsZero();
+    TestCorruptHeadersAreRejected();
+    TestLegendsResolveThroughCookedSheets();
+
+    remove(s_datafilePath);
+    remove(s_cookedPath);
+    LeaveLevelCookInputs();
+
+    return TEST_RESULT();
+
+}
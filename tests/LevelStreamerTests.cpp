@@ -0,0 +1,310 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Christopher Higgins Barrett
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Levels/Level.hpp"
+#include "Levels/LevelStreamer.hpp"
+
+#include "TestCheck.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace {
+
+std::atomic<bool> s_releaseOpen(false);
+std::atomic<bool> s_sourceDeleted(false);
+
+//==============================================================================
+// A grid of legend indices, x + y * 7 mod 3, with Open optionally held until
+// s_releaseOpen, standing in for a long parse.
+class TestChunkSource : public ILevelChunkSource {
+private: // Data
+    bool m_blockOpen;
+
+public:
+    static const unsigned s_width  = 100;
+    static const unsigned s_height = 70;
+
+    static unsigned short TileAt (unsigned x, unsigned y) { return (unsigned short)((x + y * 7) % 3); }
+
+    explicit TestChunkSource (bool blockOpen) : m_blockOpen(blockOpen) {}
+    ~TestChunkSource () { s_sourceDeleted = true; }
+
+    bool Open (Level::Desc * descOut) override {
+        while (m_blockOpen && !s_releaseOpen)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+        descOut->width  = s_width;
+        descOut->height = s_height;
+        descOut->legend.resize(3);
+        return true;
+    }
+
+    bool ReadChunk (unsigned chunkX, unsigned chunkY, Level::TileChunk * chunkOut) override {
+        memset(chunkOut, 0, sizeof(Level::TileChunk));
+        for (unsigned y = 0; y < Level::s_chunkTiles; ++y) {
+            for (unsigned x = 0; x < Level::s_chunkTiles; ++x) {
+                const unsigned levelX = chunkX * Level::s_chunkTiles + x;
+                const unsigned levelY = chunkY * Level::s_chunkTiles + y;
+                if (levelX < s_width && levelY < s_height)
+                    chunkOut->legendIndices[y * Level::s_chunkTiles + x] = TileAt(levelX, levelY);
+            }
+        }
+        return true;
+    }
+};
+
+//==============================================================================
+// TestChunkSource, but reads of one chunk fail while failuresLeft lasts, and
+// Open can fail outright.
+class FailingChunkSource : public TestChunkSource {
+private: // Data
+    bool     m_openOk;
+    unsigned m_failChunkX;
+    unsigned m_failChunkY;
+
+public:
+    std::atomic<unsigned> failuresLeft;
+    std::atomic<unsigned> failedReads;
+
+    FailingChunkSource (bool openOk, unsigned failChunkX, unsigned failChunkY, unsigned failures) :
+        TestChunkSource(false),
+        m_openOk(openOk),
+        m_failChunkX(failChunkX),
+        m_failChunkY(failChunkY),
+        failuresLeft(failures),
+        failedReads(0)
+    {}
+
+    bool Open (Level::Desc * descOut) override {
+        return m_openOk && TestChunkSource::Open(descOut);
+    }
+
+    bool ReadChunk (unsigned chunkX, unsigned chunkY, Level::TileChunk * chunkOut) override {
+        if (chunkX == m_failChunkX && chunkY == m_failChunkY && failuresLeft) {
+            --failuresLeft;
+            ++failedReads;
+            return false;
+        }
+        return TestChunkSource::ReadChunk(chunkX, chunkY, chunkOut);
+    }
+};
+
+//==============================================================================
+bool WaitFor (const std::atomic<bool> & flag) {
+
+    for (unsigned i = 0; i < 5000 && !flag; ++i)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    return flag;
+
+}
+
+//==============================================================================
+bool AllChunksResident (const Level & level) {
+
+    if (!level.GetChunksWide())
+        return false;
+
+    for (unsigned chunkY = 0; chunkY < level.GetChunksHigh(); ++chunkY) {
+        for (unsigned chunkX = 0; chunkX < level.GetChunksWide(); ++chunkX) {
+            if (!level.IsChunkResident(chunkX, chunkY))
+                return false;
+        }
+    }
+
+    return true;
+
+}
+
+//==============================================================================
+void TestStreamsEveryChunk () {
+
+    s_sourceDeleted = false;
+
+    Level *   level = new Level;
+    Transform transform;
+    level->BeginStreaming(new TestChunkSource(false), LevelStreamSettings());
+
+    for (unsigned i = 0; i < 5000 && !AllChunksResident(*level); ++i) {
+        level->UpdateStreaming(transform, nullptr);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    CHECK(level->GetWidth() == TestChunkSource::s_width && level->GetHeight() == TestChunkSource::s_height);
+    CHECK(level->GetChunksWide() == 4 && level->GetChunksHigh() == 3);
+
+    bool allMatch = true;
+    for (unsigned y = 0; y < level->GetHeight(); ++y) {
+        for (unsigned x = 0; x < level->GetWidth(); ++x)
+            allMatch = allMatch && level->GetTileLegendIndex(x, y) == TestChunkSource::TileAt(x, y);
+    }
+    CHECK(allMatch);
+
+    // The streaming thread lets go of the source shortly after.
+    delete level;
+    CHECK(WaitFor(s_sourceDeleted));
+
+}
+
+//==============================================================================
+void TestResetDoesNotWaitForOpen () {
+
+    s_releaseOpen   = false;
+    s_sourceDeleted = false;
+
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    {
+        Level level;
+        level.BeginStreaming(new TestChunkSource(true), LevelStreamSettings());
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    const std::chrono::steady_clock::duration elapsed = std::chrono::steady_clock::now() - start;
+
+    // The level is gone; the source lives on until Open returns.
+    CHECK(elapsed < std::chrono::seconds(1));
+    CHECK(!s_sourceDeleted);
+
+    s_releaseOpen = true;
+    CHECK(WaitFor(s_sourceDeleted));
+
+}
+
+//==============================================================================
+// Pumps until every chunk but (1, 1) is resident and (1, 1) has settled.
+void PumpUntilSettled (Level * level) {
+
+    const Transform transform;
+    for (unsigned i = 0; i < 5000; ++i) {
+        level->UpdateStreaming(transform, nullptr);
+        const LevelStreamer * streamer = level->GetStreamer();
+        if (streamer->IsReady() && streamer->GetResidentChunkCount() + streamer->GetFailedChunkCount() == 12)
+            return;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+}
+
+//==============================================================================
+// A chunk that won't read is tried s_maxChunkReadAttempts times and then left
+// alone, rather than requested every frame; the rest of the level streams.
+void TestFailedChunkGivesUp () {
+
+    const unsigned  chunkIndex = 1 * 4 + 1;
+    const Transform transform;
+
+    Level                level;
+    FailingChunkSource * source = new FailingChunkSource(true, 1, 1, unsigned(-1));
+    level.BeginStreaming(source, LevelStreamSettings());
+    PumpUntilSettled(&level);
+
+    const LevelStreamer * streamer = level.GetStreamer();
+    CHECK(streamer->IsChunkFailed(chunkIndex));
+    CHECK(!streamer->IsChunkResident(chunkIndex));
+    CHECK(streamer->GetFailedChunkCount() == 1);
+    CHECK(streamer->GetResidentChunkCount() == 11);
+    CHECK(source->failedReads == LevelStreamer::s_maxChunkReadAttempts);
+
+    // Later pumps don't ask again, and the stream as a whole is fine.
+    bool pumped = true;
+    for (unsigned i = 0; i < 20; ++i) {
+        pumped = pumped && level.UpdateStreaming(transform, nullptr);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    CHECK(pumped);
+    CHECK(source->failedReads == LevelStreamer::s_maxChunkReadAttempts);
+    CHECK(streamer->GetStatus() == LevelStreamer::STREAM_STATUS_READY);
+
+    // Once the source recovers, a retry brings the chunk in.
+    source->failuresLeft = 0;
+    level.GetStreamer()->RetryFailedChunks();
+    CHECK(streamer->GetFailedChunkCount() == 0);
+    for (unsigned i = 0; i < 5000 && !AllChunksResident(level); ++i) {
+        level.UpdateStreaming(transform, nullptr);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    CHECK(AllChunksResident(level));
+    CHECK(level.GetTileLegendIndex(40, 40) == TestChunkSource::TileAt(40, 40));
+
+}
+
+//==============================================================================
+// Failures short of the limit are just retried.
+void TestFlakyChunkRecovers () {
+
+    const Transform transform;
+
+    Level                level;
+    FailingChunkSource * source = new FailingChunkSource(true, 1, 1, LevelStreamer::s_maxChunkReadAttempts - 1);
+    level.BeginStreaming(source, LevelStreamSettings());
+    for (unsigned i = 0; i < 5000 && !AllChunksResident(level); ++i) {
+        level.UpdateStreaming(transform, nullptr);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    CHECK(AllChunksResident(level));
+    CHECK(source->failedReads == LevelStreamer::s_maxChunkReadAttempts - 1);
+    CHECK(level.GetStreamer()->GetFailedChunkCount() == 0);
+
+}
+
+//==============================================================================
+// A source that can't be opened fails the stream, visibly, once.
+void TestOpenFailureIsReported () {
+
+    const Transform transform;
+
+    Level level;
+    level.BeginStreaming(new FailingChunkSource(false, 0, 0, 0), LevelStreamSettings());
+
+    bool failed = false;
+    for (unsigned i = 0; i < 5000 && !failed; ++i) {
+        failed = !level.UpdateStreaming(transform, nullptr);
+        if (!failed)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    CHECK(failed);
+    CHECK(level.GetStreamer()->HasFailed());
+    CHECK(level.GetStreamer()->GetStatus() == LevelStreamer::STREAM_STATUS_OPEN_FAILED);
+    CHECK(!level.GetStreamer()->IsReady());
+    CHECK(!level.UpdateStreaming(transform, nullptr));
+    CHECK(level.GetWidth() == 0 && level.GetChunksWide() == 0);
+
+}
+
+} // namespace
+
+//==============================================================================
+int main () {
+
+    TestStreamsEveryChunk();
+    TestResetDoesNotWaitForOpen();
+    TestFailedChunkGivesUp();
+    TestFlakyChunkRecovers();
+    TestOpenFailureIsReported();
+
+    return TEST_RESULT();
+
+}
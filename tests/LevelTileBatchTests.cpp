@@ -0,0 +1,205 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Christopher Higgins Barrett
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Transform.h"
+#include "Levels/Level.hpp"
+
+#include "TestCheck.h"
+#include "TestLevel.h"
+
+namespace {
+
+const char     s_levelPath[] = "LevelTileBatchTests.json";
+const unsigned s_levelSize   = 70; // 3x3 chunks, the last row and column partial
+
+//==============================================================================
+bool BuildTestLevel (Level * levelOut) {
+
+    std::vector<Level::ETileCollision> collisions;
+    collisions.push_back(Level::ETileCollision::None);
+    collisions.push_back(Level::ETileCollision::Solid);
+
+    const std::vector<unsigned short> tiles(s_levelSize * s_levelSize, 0);
+    return Test::BuildLevel(s_levelPath, s_levelSize, s_levelSize, collisions, tiles, levelOut);
+
+}
+
+//==============================================================================
+void GetBakeStamps (const LevelTileBatch & batch, std::vector<unsigned> * stampsOut) {
+
+    stampsOut->clear();
+    for (unsigned chunkY = 0; chunkY < batch.GetChunksHigh(); ++chunkY) {
+        for (unsigned chunkX = 0; chunkX < batch.GetChunksWide(); ++chunkX)
+            stampsOut->push_back(batch.GetChunk(chunkX, chunkY).bakeStamp);
+    }
+
+}
+
+//==============================================================================
+// An edit rebakes the chunk holding the tile and leaves every other chunk's
+// records alone, including the neighbours of a tile on a chunk's corner.
+void TestSingleTileEditRebakesOneChunk () {
+
+    Level level;
+    CHECK(BuildTestLevel(&level));
+
+    const Transform        levelTransform;
+    const LevelTileBatch & batch = level.GetTileBatch();
+    level.Render(levelTransform);
+    CHECK(batch.GetLastRebuiltChunkCount() == 9);
+    CHECK(batch.GetResidentChunkCount() == 9);
+
+    struct Edit {
+        unsigned x;
+        unsigned y;
+        unsigned chunkX;
+        unsigned chunkY;
+    };
+    const Edit edits[] = {
+        { 40,  5, 1, 0 },
+        { 31, 31, 0, 0 }, // Corner of chunk (0, 0)
+        { 32, 32, 1, 1 }, // Corner of chunk (1, 1)
+        { 69, 69, 2, 2 }, // Last tile of the partial chunk
+    };
+
+    std::vector<unsigned> before;
+    std::vector<unsigned> after;
+    for (unsigned i = 0; i < arrsize(edits); ++i) {
+        const Edit & edit = edits[i];
+        GetBakeStamps(batch, &before);
+
+        level.SetTile(edit.x, edit.y, 1);
+        level.Render(levelTransform);
+        CHECK(batch.GetLastRebuiltChunkCount() == 1);
+
+        GetBakeStamps(batch, &after);
+        const unsigned editedIndex = edit.chunkY * batch.GetChunksWide() + edit.chunkX;
+        for (unsigned chunkIndex = 0; chunkIndex < after.size(); ++chunkIndex)
+            CHECK((after[chunkIndex] != before[chunkIndex]) == (chunkIndex == editedIndex));
+
+        // The rebaked record carries the new legend.
+        const LevelTileBatch::Chunk & chunk  = batch.GetChunk(edit.chunkX, edit.chunkY);
+        const unsigned                chunkW = MIN(LevelTileBatch::s_chunkTiles, s_levelSize - edit.chunkX * LevelTileBatch::s_chunkTiles);
+        const unsigned                offset = (edit.y % LevelTileBatch::s_chunkTiles) * chunkW + edit.x % LevelTileBatch::s_chunkTiles;
+        CHECK(offset < chunk.instances.size() && chunk.instances[offset].legendIndex == 1);
+        CHECK(level.GetTileLegendIndex(edit.x, edit.y) == 1);
+    }
+
+    // Rewriting a tile's own legend isn't an edit, and a still level with no
+    // edits rebakes nothing.
+    level.SetTile(40, 5, 1);
+    level.Render(levelTransform);
+    CHECK(batch.GetLastRebuiltChunkCount() == 0);
+
+    // Undoing the edits rebakes just the chunks they touched.
+    level.RevertEditsTo(level.GetOldestEditSequence());
+    level.Render(levelTransform);
+    CHECK(batch.GetLastRebuiltChunkCount() == arrsize(edits));
+    CHECK(batch.GetChunk(1, 0).instances[5 * LevelTileBatch::s_chunkTiles + 8].legendIndex == 0);
+
+    Test::RemoveLevel(s_levelPath);
+
+}
+
+//==============================================================================
+bool RangeIs (const LevelChunkRange & range, unsigned beginX, unsigned beginY, unsigned endX, unsigned endY) {
+    return range.beginX == beginX && range.beginY == beginY && range.endX == endX && range.endY == endY;
+}
+
+//==============================================================================
+// Chunks are 512 units square at 16-unit tiles, and the range is padded by a
+// tile each way for the sprite's pivot, so a view reaches into the next
+// chunk once it comes within a tile of it.  The level spans [0, 1120).
+void TestVisibleChunks () {
+
+    Level level;
+    CHECK(BuildTestLevel(&level));
+
+    struct Case {
+        WorldRect view;
+        unsigned  beginX;
+        unsigned  beginY;
+        unsigned  endX;
+        unsigned  endY;
+    };
+    const Case cases[] = {
+        { {   600.0f,   600.0f,   700.0f,   700.0f }, 1, 1, 2, 2 }, // Inside chunk (1, 1)
+        { {  1000.0f,   100.0f,  1040.0f,   120.0f }, 1, 0, 3, 1 }, // Straddles the x edge at 1024
+        { {   100.0f,   490.0f,   200.0f,   530.0f }, 0, 0, 1, 2 }, // Straddles the y edge at 512
+        { {   520.0f,   520.0f,   530.0f,   530.0f }, 0, 0, 2, 2 }, // Within a tile of (0, 0)
+        { {   540.0f,   540.0f,   550.0f,   550.0f }, 1, 1, 2, 2 }, // Just past that tile
+        { {   -50.0f,   200.0f,    10.0f,   300.0f }, 0, 0, 1, 1 }, // Over the left border
+        { {   900.0f,   900.0f,  5000.0f,  5000.0f }, 1, 1, 3, 3 }, // Past the far corner
+        { {  -100.0f,  -100.0f,  5000.0f,  5000.0f }, 0, 0, 3, 3 }, // The whole level
+        { { -1000.0f, -1000.0f,  -600.0f,  -600.0f }, 0, 0, 0, 0 }, // Below and left
+        { {  2000.0f,   100.0f,  2100.0f,   200.0f }, 3, 0, 3, 1 }, // Right of the level
+    };
+
+    const Transform identity;
+    for (unsigned i = 0; i < arrsize(cases); ++i) {
+        const Case &          c     = cases[i];
+        const LevelChunkRange range = level.GetVisibleChunks(identity.GetWorldFromModelMtx(), c.view);
+        CHECK(RangeIs(range, c.beginX, c.beginY, c.endX, c.endY));
+    }
+
+    // Moving the level moves the range with it.
+    Transform moved;
+    moved.SetPosition(Vec3(-512.0f, 0.0f, 0.0f));
+    const WorldRect movedView = { 100.0f, 100.0f, 200.0f, 200.0f };
+    CHECK(RangeIs(level.GetVisibleChunks(moved.GetWorldFromModelMtx(), movedView), 1, 0, 2, 1));
+
+    // A quarter turn maps level (x, y) to world (-y, x).
+    Transform turned;
+    turned.SetRotation(1.5707963f);
+    const WorldRect turnedView = { -1040.0f, 100.0f, -1000.0f, 120.0f };
+    CHECK(RangeIs(level.GetVisibleChunks(turned.GetWorldFromModelMtx(), turnedView), 0, 1, 1, 3));
+
+    // Rendering a view keeps exactly that range resident.
+    const WorldRect edgeView = { 1000.0f, 100.0f, 1040.0f, 120.0f };
+    level.Render(identity, &edgeView);
+    CHECK(level.GetTileBatch().GetResidentChunkCount() == 2);
+    CHECK(!level.GetTileBatch().GetChunk(1, 0).instances.empty());
+    CHECK(!level.GetTileBatch().GetChunk(2, 0).instances.empty());
+    CHECK(level.GetTileBatch().GetChunk(0, 0).instances.empty());
+
+    // Nothing in view: everything released.
+    const WorldRect emptyView = { -1000.0f, -1000.0f, -600.0f, -600.0f };
+    level.Render(identity, &emptyView);
+    CHECK(level.GetTileBatch().GetResidentChunkCount() == 0);
+
+    Test::RemoveLevel(s_levelPath);
+
+}
+
+} // namespace
+
+//==============================================================================
+int main () {
+
+    TestSingleTileEditRebakesOneChunk();
+    TestVisibleChunks();
+
+    return TEST_RESULT();
+
+}
@@ -0,0 +1,279 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Christopher Higgins Barrett
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Collections/ObjectCollection.h"
+
+#include <algorithm>
+
+#include "TestCheck.h"
+
+namespace {
+
+//==============================================================================
+// Counts constructions and logs destructions, so tests can tell which object
+// a Remove actually destroyed.
+struct Counted {
+    static unsigned              s_constructed;
+    static std::vector<unsigned> s_destroyed; // Tags, in destruction order
+
+    unsigned tag;
+
+    explicit Counted (unsigned tag) : tag(tag) { ++s_constructed; }
+    ~Counted () { s_destroyed.push_back(tag); }
+
+    static void ResetCounts () {
+        s_constructed = 0;
+        s_destroyed.clear();
+    }
+};
+
+unsigned              Counted::s_constructed = 0;
+std::vector<unsigned> Counted::s_destroyed;
+
+typedef CSaru::CObjectCollection<Counted, 16>       Collection;
+typedef CSaru::CInPlaceObjectCollection<Counted, 8> InPlaceCollection;
+typedef CSaru::IObjectCollection::Handle            Handle;
+
+//==============================================================================
+template <typename T_Collection>
+std::vector<unsigned> DenseTags (T_Collection & collection) {
+
+    std::vector<unsigned> tags;
+    for (Counted & object : collection)
+        tags.push_back(object.tag);
+    return tags;
+
+}
+
+//==============================================================================
+// Remove(Handle) used to take the handle's entry index for a dense position.
+// Once a removal has moved the tail, the two differ, and it destroyed the
+// wrong object.
+void TestRemoveByHandleDestroysItsObject () {
+
+    Counted::ResetCounts();
+    {
+        Collection   collection;
+        const Handle a = collection.Add(new Counted(0));
+        const Handle b = collection.Add(new Counted(1));
+        const Handle c = collection.Add(new Counted(2));
+
+        // c moves into a's dense slot: entry 2 now sits at dense position 0.
+        collection.Remove(a);
+        CHECK(DenseTags(collection) == std::vector<unsigned>({ 2, 1 }));
+
+        collection.Remove(c);
+        CHECK(Counted::s_destroyed == std::vector<unsigned>({ 0, 2 }));
+        CHECK(collection.Count() == 1);
+        CHECK(!collection.Get(c));
+        CHECK(collection.Get(b) && collection.Get(b)->tag == 1);
+        CHECK(DenseTags(collection) == std::vector<unsigned>({ 1 }));
+    }
+    CHECK(Counted::s_destroyed == std::vector<unsigned>({ 0, 2, 1 }));
+
+}
+
+//==============================================================================
+void TestStaleHandlesAfterReuse () {
+
+    Counted::ResetCounts();
+    Collection   collection;
+    const Handle first = collection.Add(new Counted(0));
+    collection.Remove(first);
+    CHECK(!collection.Get(first));
+
+    // The freed entry comes back first, under a new generation.
+    const Handle second = collection.Add(new Counted(1));
+    CHECK(second.index == first.index && second.generation != first.generation);
+    CHECK(!collection.Get(first));
+    CHECK(collection.Get(second) && collection.Get(second)->tag == 1);
+
+    // Nothing done through the stale handle reaches the new object.
+    collection.Remove(first);
+    collection.DeferRemove(first);
+    CHECK(!collection.IsRemovePending(first) && !collection.IsRemovePending(second));
+    collection.FlushDeferredRemoves();
+    CHECK(collection.Count() == 1 && collection.Get(second));
+    CHECK(Counted::s_destroyed == std::vector<unsigned>({ 0 }));
+
+    // A default handle is never valid.
+    CHECK(!collection.Get(Handle()));
+
+}
+
+//==============================================================================
+// Removing while iterating is deferred: every object is still visited, the
+// doomed ones stay valid until the flush, and asking twice removes once.
+void TestRemovalDuringIteration () {
+
+    Counted::ResetCounts();
+    Collection          collection;
+    std::vector<Handle> handles;
+    for (unsigned i = 0; i < 10; ++i)
+        handles.push_back(collection.Add(new Counted(i)));
+
+    unsigned visited = 0;
+    for (unsigned i = 0; i < collection.Count(); ++i) {
+        const Handle handle = collection.GetHandleAt(i);
+        const unsigned tag  = collection.GetAt(i)->tag;
+        if (tag & 1) {
+            collection.DeferRemove(handle);
+            collection.DeferRemove(handle);
+        }
+        ++visited;
+    }
+    CHECK(visited == 10);
+    CHECK(collection.Count() == 10);
+    CHECK(Counted::s_destroyed.empty());
+    CHECK(collection.IsRemovePending(handles[3]) && !collection.IsRemovePending(handles[4]));
+    CHECK(collection.Get(handles[3]) && collection.Get(handles[3])->tag == 3);
+
+    // ForEach walks the same objects, pending or not.
+    unsigned tagSum = 0;
+    collection.ForEach([&tagSum] (Counted & object) { tagSum += object.tag; });
+    CHECK(tagSum == 45);
+
+    collection.FlushDeferredRemoves();
+    CHECK(collection.Count() == 5);
+    CHECK(Counted::s_destroyed == std::vector<unsigned>({ 1, 3, 5, 7, 9 }));
+    for (unsigned i = 0; i < 10; ++i)
+        CHECK((collection.Get(handles[i]) != nullptr) == !(i & 1));
+
+    // Flushing again has nothing left to do.
+    collection.FlushDeferredRemoves();
+    CHECK(Counted::s_destroyed.size() == 5);
+
+}
+
+//==============================================================================
+// Deferred removes apply in the order they were queued, each moving the tail
+// into the hole it leaves, so the dense order after a flush is fixed.
+void TestDeferredFlushOrder () {
+
+    Counted::ResetCounts();
+    Collection          collection;
+    std::vector<Handle> handles;
+    for (unsigned i = 0; i < 5; ++i)
+        handles.push_back(collection.Add(new Counted(i)));
+
+    collection.DeferRemove(handles[1]);
+    collection.DeferRemove(handles[4]);
+    collection.DeferRemove(handles[0]);
+    collection.FlushDeferredRemoves();
+
+    // [0 1 2 3 4] -> [0 4 2 3] -> [0 3 2] -> [2 3]
+    CHECK(Counted::s_destroyed == std::vector<unsigned>({ 1, 4, 0 }));
+    CHECK(DenseTags(collection) == std::vector<unsigned>({ 2, 3 }));
+
+    // An object removed outright after being queued isn't removed twice, and
+    // the entry's next object isn't left marked pending.
+    collection.DeferRemove(handles[2]);
+    collection.Remove(handles[2]);
+    const Handle reused = collection.Add(new Counted(5));
+    CHECK(reused.index == handles[2].index);
+    CHECK(!collection.IsRemovePending(reused));
+    collection.DeferRemove(reused);
+    CHECK(collection.IsRemovePending(reused));
+
+    collection.FlushDeferredRemoves();
+    CHECK(Counted::s_destroyed == std::vector<unsigned>({ 1, 4, 0, 2, 5 }));
+    CHECK(DenseTags(collection) == std::vector<unsigned>({ 3 }));
+
+}
+
+//==============================================================================
+// In-place objects are built by Emplace and destroyed exactly once, by
+// Remove, flush or the collection itself; a full collection builds nothing.
+void TestInPlaceDestructorCounts () {
+
+    Counted::ResetCounts();
+    {
+        InPlaceCollection   collection;
+        std::vector<Handle> handles;
+        for (unsigned i = 0; i < 8; ++i)
+            handles.push_back(collection.Emplace(i));
+        CHECK(Counted::s_constructed == 8);
+
+        const Handle overflow = collection.Emplace(100u);
+        CHECK(!collection.Get(overflow));
+        CHECK(Counted::s_constructed == 8);
+
+        // Objects sit inside the collection, not on the heap.
+        const char * first = reinterpret_cast<const char *>(&collection);
+        const char * last  = first + sizeof(collection);
+        for (const Handle & handle : handles) {
+            const char * object = reinterpret_cast<const char *>(collection.Get(handle));
+            CHECK(object >= first && object < last);
+        }
+
+        collection.Remove(handles[2]);
+        collection.DeferRemove(handles[5]);
+        collection.FlushDeferredRemoves();
+        CHECK(Counted::s_destroyed == std::vector<unsigned>({ 2, 5 }));
+
+        // Freed slots are built into again.
+        const Handle reused = collection.Emplace(8u);
+        CHECK(collection.Get(reused) && collection.Get(reused)->tag == 8);
+        CHECK(!collection.Get(handles[2]) && !collection.Get(handles[5]));
+        CHECK(Counted::s_constructed == 9);
+        CHECK(collection.Count() == 7);
+    }
+    CHECK(Counted::s_destroyed.size() == Counted::s_constructed);
+
+    std::vector<unsigned> sorted = Counted::s_destroyed;
+    std::sort(sorted.begin(), sorted.end());
+    CHECK(sorted == std::vector<unsigned>({ 0, 1, 2, 3, 4, 5, 6, 7, 8 }));
+
+}
+
+//==============================================================================
+void TestChunkRangesCoverEverything () {
+
+    Counted::ResetCounts();
+    Collection collection;
+    for (unsigned i = 0; i < 13; ++i)
+        collection.Add(new Counted(i));
+
+    std::vector<unsigned> seen(13, 0);
+    for (unsigned chunk = 0; chunk < 4; ++chunk)
+        collection.ForEachInChunk(chunk, 4, [&seen] (Counted & object) { ++seen[object.tag]; });
+    CHECK(seen == std::vector<unsigned>(13, 1));
+
+}
+
+} // namespace
+
+//==============================================================================
+int main () {
+
+    TestRemoveByHandleDestroysItsObject();
+    TestStaleHandlesAfterReuse();
+    TestRemovalDuringIteration();
+    TestDeferredFlushOrder();
+    TestInPlaceDestructorCounts();
+    TestChunkRangesCoverEverything();
+
+    return TEST_RESULT();
+
+}
@@ -0,0 +1,135 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Christopher Higgins Barrett
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Collections/PagedObjectCollection.h"
+
+#include "TestCheck.h"
+
+#include <thread>
+
+namespace {
+
+struct Tagged {
+    unsigned owner;
+    unsigned sequence;
+};
+
+typedef CSaru::CPagedObjectCollection<Tagged, 16, 64> Collection;
+typedef CSaru::IObjectCollection::Handle             Handle;
+
+//==============================================================================
+void TestStaleHandles () {
+
+    Collection collection;
+
+    Tagged *     first  = new Tagged();
+    const Handle handle = collection.Add(first);
+    CHECK(collection.Get(handle) == first);
+    CHECK(collection.Remove(handle));
+    CHECK(!collection.Remove(handle));
+    CHECK(!collection.Get(handle));
+
+    // The freed entry is reused first; the old handle must not see its new object.
+    Tagged *     second = new Tagged();
+    const Handle reused = collection.Add(second);
+    CHECK(reused.index == handle.index);
+    CHECK(reused.generation != handle.generation);
+    CHECK(!collection.Get(handle));
+    CHECK(collection.Get(reused) == second);
+    CHECK(collection.Count() == 1);
+
+}
+
+//==============================================================================
+void TestGrowthKeepsPointers () {
+
+    Collection            collection;
+    std::vector<Handle>   handles;
+    std::vector<Tagged *> objects;
+
+    for (unsigned i = 0; i < 40; ++i) {
+        objects.push_back(new Tagged());
+        objects.back()->sequence = i;
+        handles.push_back(collection.Add(objects.back()));
+    }
+
+    CHECK(collection.Count() == 40);
+    CHECK(collection.Capacity() == 48);
+    for (unsigned i = 0; i < 40; ++i)
+        CHECK(collection.Get(handles[i]) == objects[i] && objects[i]->sequence == i);
+
+}
+
+//==============================================================================
+// Every thread churns entries that the others keep reusing.  A handle must
+// keep finding its own object until it's removed and nothing after that.
+void TestConcurrentChurn () {
+
+    const unsigned threadCount = 4;
+    const unsigned iterations  = 20000;
+
+    Collection                collection;
+    std::vector<unsigned>     failures(threadCount, 0);
+    std::vector<std::thread>  threads;
+
+    for (unsigned t = 0; t < threadCount; ++t) {
+        threads.push_back(std::thread([&collection, &failures, t, iterations] {
+            for (unsigned i = 0; i < iterations; ++i) {
+                Tagged * object = new Tagged();
+                object->owner    = t;
+                object->sequence = i;
+
+                const Handle handle = collection.Add(object);
+                const Tagged * found = collection.Get(handle);
+                if (!found || found->owner != t || found->sequence != i)
+                    ++failures[t];
+                if (!collection.Remove(handle))
+                    ++failures[t];
+                if (collection.Get(handle))
+                    ++failures[t];
+            }
+        }));
+    }
+
+    for (std::thread & thread : threads)
+        thread.join();
+
+    for (unsigned t = 0; t < threadCount; ++t)
+        CHECK(failures[t] == 0);
+    CHECK(collection.Count() == 0);
+
+}
+
+} // namespace
+
+//==============================================================================
+int main () {
+
+    TestStaleHandles();
+    TestGrowthKeepsPointers();
+    TestConcurrentChurn();
+
+    return TEST_RESULT();
+
+}
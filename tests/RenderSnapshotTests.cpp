@@ -0,0 +1,180 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Christopher Higgins Barrett
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Render/SpriteBatcher.h"
+#include "Render/RenderSnapshot.h"
+
+#include <thread>
+
+#include "TestCheck.h"
+
+namespace {
+
+const unsigned s_publishCount = 20000;
+
+// Sheets are only compared by address.
+char                      s_sheetStorage;
+const Spritesheet * const s_sheet = reinterpret_cast<const Spritesheet *>(&s_sheetStorage);
+
+//==============================================================================
+// One sprite and a camera, both placed at the tick, so a reader can tell a
+// torn or mislabelled snapshot from a whole one.
+void CaptureTick (SpriteBatcher * batcher, unsigned tick, RenderSnapshot * snapshot) {
+
+    SpriteInstance instance = SpriteInstance();
+    instance.origin[0]  = float(tick);
+    instance.texRect[2] = 16.0f;
+    instance.texRect[3] = 16.0f;
+
+    batcher->Begin();
+    batcher->Add(s_sheet, 0, 0.0f, instance);
+
+    const Vec3 cameraPosition(float(tick), 0.0f, 0.0f);
+    snapshot->Capture(*batcher, &cameraPosition, tick);
+
+}
+
+//==============================================================================
+bool IsWhole (const RenderSnapshot & snapshot) {
+
+    return snapshot.GetInstances().size() == 1
+        && snapshot.GetInstances()[0].origin[0] == float(snapshot.GetTick())
+        && snapshot.HasCamera()
+        && snapshot.GetCameraPosition().x == float(snapshot.GetTick());
+
+}
+
+//==============================================================================
+// The simulation thread publishes as fast as it can while the render thread
+// acquires, blends and draws.  The reader may skip ticks, but never sees one
+// go backwards, a half-written slot, or a previous that isn't the snapshot it
+// had current before.
+void TestProducerConsumer () {
+
+    RenderSnapshotExchange exchange;
+
+    std::thread producer([&exchange] () {
+        SpriteBatcher batcher;
+        for (unsigned tick = 1; tick <= s_publishCount; ++tick) {
+            CaptureTick(&batcher, tick, &exchange.GetWriteSlot());
+            exchange.Publish();
+        }
+    });
+
+    SnapshotRenderer      renderer;
+    CountingRenderBackend backend;
+    unsigned              currentTick = 0;
+    unsigned              acquires    = 0;
+    bool                  ok          = true;
+    while (currentTick < s_publishCount) {
+        if (!exchange.Acquire()) {
+            std::this_thread::yield();
+            continue;
+        }
+        ++acquires;
+
+        const RenderSnapshot * current  = exchange.GetCurrent();
+        const RenderSnapshot * previous = exchange.GetPrevious();
+        ok = ok && current && IsWhole(*current) && current->GetTick() > currentTick;
+        ok = ok && (acquires == 1 ? !previous : previous && previous->GetTick() == currentTick && IsWhole(*previous));
+        if (!ok)
+            break;
+        currentTick = current->GetTick();
+
+        const float alpha = SnapshotRenderer::ComputeAlpha(previous, *current, Core::GetPerformanceCounter());
+        ok = ok && alpha >= 0.0f && alpha <= 1.0f;
+
+        // The blended camera sits between the two ticks.
+        renderer.Prepare(previous, *current, alpha);
+        renderer.Submit(&backend);
+        const float cameraX = renderer.GetCameraPosition().x;
+        ok = ok && cameraX <= float(currentTick) && (!previous || cameraX >= float(previous->GetTick()));
+        ok = ok && backend.GetLastFrame().instances == 1;
+    }
+
+    producer.join();
+    CHECK(ok);
+    CHECK(currentTick == s_publishCount);
+    CHECK(acquires >= 1);
+
+}
+
+//==============================================================================
+void TestComputeAlpha () {
+
+    RenderSnapshotExchange exchange;
+    SpriteBatcher          batcher;
+
+    // Nothing to blend from: draw the current snapshot as is.
+    CaptureTick(&batcher, 1, &exchange.GetWriteSlot());
+    exchange.Publish();
+    CHECK(exchange.Acquire());
+    CHECK(!exchange.Acquire());
+    const RenderSnapshot & first = *exchange.GetCurrent();
+    CHECK(SnapshotRenderer::ComputeAlpha(nullptr, first, first.GetPublishCount() + 1000) == 1.0f);
+
+    // Make sure the two publishes are at least a few counts apart.
+    const std::uint64_t firstCount = first.GetPublishCount();
+    while (Core::GetPerformanceCounter() < firstCount + 16)
+        std::this_thread::yield();
+
+    CaptureTick(&batcher, 2, &exchange.GetWriteSlot());
+    exchange.Publish();
+    CHECK(exchange.Acquire());
+
+    const RenderSnapshot & current  = *exchange.GetCurrent();
+    const RenderSnapshot * previous = exchange.GetPrevious();
+    CHECK(previous && previous->GetTick() == 1 && current.GetTick() == 2);
+    if (!previous)
+        return;
+
+    const std::uint64_t publishCount = current.GetPublishCount();
+    const std::uint64_t interval     = publishCount - previous->GetPublishCount();
+    CHECK(interval >= 16);
+
+    // Clamped at both ends; linear in between.
+    CHECK(SnapshotRenderer::ComputeAlpha(previous, current, publishCount - 5) == 0.0f);
+    CHECK(SnapshotRenderer::ComputeAlpha(previous, current, publishCount) == 0.0f);
+    CHECK(SnapshotRenderer::ComputeAlpha(previous, current, publishCount + interval) == 1.0f);
+    CHECK(SnapshotRenderer::ComputeAlpha(previous, current, publishCount + interval * 10) == 1.0f);
+
+    const float half = SnapshotRenderer::ComputeAlpha(previous, current, publishCount + interval / 2);
+    CHECK(half > 0.4f && half < 0.6f);
+
+    // Out-of-order counts never blend backwards.
+    CHECK(SnapshotRenderer::ComputeAlpha(&current, *previous, publishCount + interval) == 0.0f);
+
+}
+
+} // namespace
+
+//==============================================================================
+int main () {
+
+    TestComputeAlpha();
+    TestProducerConsumer();
+
+    return TEST_RESULT();
+
+}
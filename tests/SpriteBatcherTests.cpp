@@ -0,0 +1,244 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Christopher Higgins Barrett
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Render/SpriteBatcher.h"
+#include "Render/RenderBackend.h"
+
+#include <cmath>
+
+#include "TestCheck.h"
+
+namespace {
+
+// Sheets are only compared by address.
+char                      s_sheetStorage[3];
+const Spritesheet * const s_sheetA = reinterpret_cast<const Spritesheet *>(&s_sheetStorage[0]);
+const Spritesheet * const s_sheetB = reinterpret_cast<const Spritesheet *>(&s_sheetStorage[1]);
+const Spritesheet * const s_sheetC = reinterpret_cast<const Spritesheet *>(&s_sheetStorage[2]);
+
+//==============================================================================
+// Tags the instance so its submission order can be read back after sorting.
+SpriteInstance MakeInstance (unsigned tag) {
+
+    SpriteInstance instance = SpriteInstance();
+    instance.texRect[0] = float(tag);
+    return instance;
+
+}
+
+//==============================================================================
+unsigned TagOf (const SpriteInstance & instance) {
+    return unsigned(instance.texRect[0]);
+}
+
+//==============================================================================
+void TestEqualKeysKeepSubmissionOrder () {
+
+    SpriteBatcher batcher;
+    batcher.Begin();
+    for (unsigned i = 0; i < 300; ++i)
+        batcher.Add(s_sheetA, 0, 0.0f, MakeInstance(i));
+    batcher.Finish();
+
+    const std::vector<SpriteInstance> & packed = batcher.GetPackedInstances();
+    CHECK(packed.size() == 300);
+    for (unsigned i = 0; i < packed.size(); ++i)
+        CHECK(TagOf(packed[i]) == i);
+
+    CHECK(batcher.GetBatches().size() == 1);
+
+}
+
+//==============================================================================
+void TestLayerSortsBeforeSheet () {
+
+    // Sheet ids come from first use, so A gets the lower id; layer must still win.
+    SpriteBatcher batcher;
+    batcher.Begin();
+    batcher.Add(s_sheetA, 2, 0.0f, MakeInstance(0));
+    batcher.Add(s_sheetB, 1, 0.0f, MakeInstance(1));
+    batcher.Add(s_sheetA, 1, 0.0f, MakeInstance(2));
+    batcher.Add(s_sheetB, 0, 0.0f, MakeInstance(3));
+    batcher.Add(s_sheetA, 2, 0.0f, MakeInstance(4));
+    batcher.Finish();
+
+    const std::vector<SpriteBatch> & batches = batcher.GetBatches();
+    CHECK(batches.size() == 4);
+    if (batches.size() != 4)
+        return;
+
+    CHECK(batches[0].layer == 0 && batches[0].sheet == s_sheetB && batches[0].instanceCount == 1);
+    CHECK(batches[1].layer == 1 && batches[1].sheet == s_sheetA && batches[1].instanceCount == 1);
+    CHECK(batches[2].layer == 1 && batches[2].sheet == s_sheetB && batches[2].instanceCount == 1);
+    CHECK(batches[3].layer == 2 && batches[3].sheet == s_sheetA && batches[3].instanceCount == 2);
+
+    const std::vector<SpriteInstance> & packed = batcher.GetPackedInstances();
+    const unsigned                      order[] = { 3, 2, 1, 0, 4 };
+    for (unsigned i = 0; i < arrsize(order); ++i)
+        CHECK(TagOf(packed[i]) == order[i]);
+
+}
+
+//==============================================================================
+void TestDepthOrdersWithinBatch () {
+
+    SpriteBatcher batcher;
+    batcher.Begin();
+    batcher.Add(s_sheetA, 0,  5.0f, MakeInstance(0));
+    batcher.Add(s_sheetA, 0, -2.5f, MakeInstance(1));
+    batcher.Add(s_sheetA, 0,  0.0f, MakeInstance(2));
+    batcher.Add(s_sheetA, 0, -7.0f, MakeInstance(3));
+    batcher.Add(s_sheetA, 0,  0.0f, MakeInstance(4));
+    batcher.Finish();
+
+    const std::vector<SpriteInstance> & packed = batcher.GetPackedInstances();
+    const unsigned                      order[] = { 3, 1, 2, 4, 0 };
+    for (unsigned i = 0; i < arrsize(order); ++i)
+        CHECK(TagOf(packed[i]) == order[i]);
+
+    CHECK(batcher.GetBatches().size() == 1);
+
+}
+
+//==============================================================================
+void TestBatchesCutAtMaxInstances () {
+
+    SpriteBatcher batcher(4);
+    batcher.Begin();
+    for (unsigned i = 0; i < 10; ++i)
+        batcher.Add(s_sheetA, 0, 0.0f, MakeInstance(i));
+    for (unsigned i = 10; i < 13; ++i)
+        batcher.Add(s_sheetC, 0, 0.0f, MakeInstance(i));
+    batcher.Finish();
+
+    const std::vector<SpriteBatch> & batches = batcher.GetBatches();
+    const unsigned                   sizes[] = { 4, 4, 2, 3 };
+    CHECK(batches.size() == arrsize(sizes));
+    if (batches.size() != arrsize(sizes))
+        return;
+
+    unsigned first = 0;
+    for (unsigned i = 0; i < arrsize(sizes); ++i) {
+        CHECK(batches[i].firstInstance == first);
+        CHECK(batches[i].instanceCount == sizes[i]);
+        CHECK(batches[i].sheet == (i < 3 ? s_sheetA : s_sheetC));
+        first += sizes[i];
+    }
+
+}
+
+//==============================================================================
+void TestSubmitCounts () {
+
+    SpriteBatcher         batcher(4);
+    CountingRenderBackend backend;
+
+    batcher.Begin();
+    for (unsigned i = 0; i < 6; ++i)
+        batcher.Add(i & 1 ? s_sheetA : s_sheetB, 0, 0.0f, MakeInstance(i));
+
+    backend.BeginFrame();
+    batcher.Submit(&backend);
+    backend.EndFrame();
+
+    const RenderStats & frame = backend.GetLastFrame();
+    CHECK(frame.instances == 6);
+    CHECK(frame.batches == 2);
+    CHECK(frame.sheetBinds == 2);
+    CHECK(frame.uploadBytes == 6 * sizeof(SpriteInstance));
+
+    // Begin starts over; nothing from the last frame is left.
+    batcher.Begin();
+    batcher.Finish();
+    CHECK(batcher.GetInstanceCount() == 0);
+    CHECK(batcher.GetBatches().empty());
+
+}
+
+//==============================================================================
+// Sprites added by transform come out as if added by their world matrix, in
+// submission order with the rest, across several batched matrix builds.
+void TestTransformAddMatchesMatrixAdd () {
+
+    const unsigned         count = 150;
+    std::vector<Transform> transforms(count);
+    for (unsigned i = 0; i < count; ++i) {
+        transforms[i].SetPosition(Vec3(float(i) * 3.0f, float(i % 7) * -5.0f, 0.0f));
+        transforms[i].SetRotation(float(i) * 0.1f);
+        transforms[i].SetScale(Vec3(1.0f + float(i % 3), 0.5f, 1.0f));
+    }
+
+    SpritesheetFrame frame = SpritesheetFrame();
+    frame.x      = 32;
+    frame.width  = 16;
+    frame.height = 24;
+
+    SpriteBatcher byTransform;
+    SpriteBatcher byMatrix;
+    byTransform.Begin();
+    byMatrix.Begin();
+    for (unsigned i = 0; i < count; ++i) {
+        const Spritesheet * sheet = i & 1 ? s_sheetA : s_sheetB;
+        if (i % 5 == 4) {
+            byTransform.Add(sheet, 0, 0.0f, MakeInstance(i));
+            byMatrix.Add(sheet, 0, 0.0f, MakeInstance(i));
+            continue;
+        }
+
+        byTransform.Add(sheet, 0, 0.0f, transforms[i], frame);
+        byMatrix.Add(sheet, 0, 0.0f, transforms[i].GetWorldFromModelMtx(), frame);
+    }
+    byTransform.Finish();
+    byMatrix.Finish();
+
+    const std::vector<SpriteInstance> & a = byTransform.GetPackedInstances();
+    const std::vector<SpriteInstance> & b = byMatrix.GetPackedInstances();
+    CHECK(a.size() == count && b.size() == count);
+
+    bool same = true;
+    for (unsigned i = 0; i < a.size() && i < b.size(); ++i) {
+        const float * fa = reinterpret_cast<const float *>(&a[i]);
+        const float * fb = reinterpret_cast<const float *>(&b[i]);
+        for (unsigned f = 0; f < sizeof(SpriteInstance) / sizeof(float); ++f)
+            same = same && fabsf(fa[f] - fb[f]) <= 1e-3f * MAX(1.0f, fabsf(fb[f]));
+    }
+    CHECK(same);
+
+}
+
+} // namespace
+
+//==============================================================================
+int main () {
+
+    TestEqualKeysKeepSubmissionOrder();
+    TestLayerSortsBeforeSheet();
+    TestDepthOrdersWithinBatch();
+    TestBatchesCutAtMaxInstances();
+    TestSubmitCounts();
+    TestTransformAddMatchesMatrixAdd();
+
+    return TEST_RESULT();
+
+}
@@ -0,0 +1,110 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Christopher Higgins Barrett
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+// Levels for the test executables that need tile collision.  A level only
+// has a tile size once its legends resolve to sprites, so these write a
+// cooked 16x16 tileset alongside the cooked level.
+#pragma once
+
+#include "Levels/Level.hpp"
+#include "Levels/LevelFile.hpp"
+#include "Render/SpritesheetDesc.h"
+#include "Render/SpritesheetFile.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace Test {
+
+const unsigned s_tileSize = 16;
+
+inline std::string GetTilesetPath (const char * levelDatafilePath) {
+    return std::string(levelDatafilePath) + "-tiles.json";
+}
+
+//==============================================================================
+// Writes the cooked files GocLevel::LoadLevel(levelDatafilePath) would load.
+// Legend i collides as collisions[i]; tiles are row-major, bottom row first.
+inline bool WriteLevel (
+    const char *                               levelDatafilePath,
+    unsigned                                   width,
+    unsigned                                   height,
+    const std::vector<Level::ETileCollision> & collisions,
+    const std::vector<unsigned short> &        tiles
+) {
+
+    const std::string tilesetPath = GetTilesetPath(levelDatafilePath);
+
+    const SpritesheetFrameDesc frame = { 0, 0, s_tileSize, s_tileSize, 0 };
+    SpritesheetAnimDesc        anim;
+    anim.name = "tile";
+    anim.frames.push_back(frame);
+
+    SpritesheetDesc tileset;
+    tileset.name = "tiles";
+    tileset.animations.push_back(anim);
+    if (!SpritesheetFile::Write(SpritesheetFile::GetCookedPath(tilesetPath.c_str()).c_str(), tileset, 0))
+        return false;
+
+    Level::Desc desc;
+    desc.name   = L"test";
+    desc.width  = width;
+    desc.height = height;
+    desc.legend.resize(collisions.size());
+    for (unsigned i = 0; i < collisions.size(); ++i) {
+        desc.legend[i].collision  = collisions[i];
+        desc.legend[i].spriteFile = tilesetPath;
+        desc.legend[i].anim       = L"tile";
+    }
+
+    return LevelFile::Write(LevelFile::GetCookedPath(levelDatafilePath).c_str(), desc, tiles, 0);
+
+}
+
+//==============================================================================
+inline bool BuildLevel (
+    const char *                               levelDatafilePath,
+    unsigned                                   width,
+    unsigned                                   height,
+    const std::vector<Level::ETileCollision> & collisions,
+    const std::vector<unsigned short> &        tiles,
+    Level *                                    levelOut
+) {
+
+    return
+        WriteLevel(levelDatafilePath, width, height, collisions, tiles) &&
+        levelOut->BuildFromCookedFile(LevelFile::GetCookedPath(levelDatafilePath).c_str());
+
+}
+
+//==============================================================================
+inline void RemoveLevel (const char * levelDatafilePath) {
+
+    remove(LevelFile::GetCookedPath(levelDatafilePath).c_str());
+    remove(SpritesheetFile::GetCookedPath(GetTilesetPath(levelDatafilePath).c_str()).c_str());
+
+}
+
+} // namespace Test
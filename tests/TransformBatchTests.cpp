@@ -0,0 +1,193 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Christopher Higgins Barrett
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Transform.h"
+#include "TransformBatch.h"
+
+#include <cmath>
+
+#include "TestCheck.h"
+
+namespace {
+
+const unsigned      s_maxCount = 17;
+const unsigned char s_guard = 0xCD;
+
+//==============================================================================
+// Small LCG so the inputs are the same on every platform.
+float NextFloat (unsigned * state, float minValue, float maxValue) {
+
+    *state = *state * 1664525u + 1013904223u;
+    return minValue + (maxValue - minValue) * float(*state >> 8) / float(1u << 24);
+
+}
+
+//==============================================================================
+bool MatricesNear (const Mtx44 & a, const Mtx44 & b) {
+
+    const float * fa = reinterpret_cast<const float *>(&a);
+    const float * fb = reinterpret_cast<const float *>(&b);
+    for (unsigned i = 0; i < 16; ++i) {
+        if (fabsf(fa[i] - fb[i]) > 1e-4f * MAX(1.0f, fabsf(fb[i])))
+            return false;
+    }
+
+    return true;
+
+}
+
+//==============================================================================
+// The general product the closed form replaces.
+Mtx44 ReferenceMtx (const Transform & transform) {
+
+    Mtx44 translation;
+    Mtx44 rotationZ;
+    Mtx44 scale;
+    Mtx44::BuildTranslate(transform.GetPosition().x, transform.GetPosition().y, 0.0f, &translation);
+    Mtx44::BuildRotateZ(transform.GetRotation(), &rotationZ);
+    Mtx44::BuildScale(transform.GetScale().x, transform.GetScale().y, 1.0f, &scale);
+
+    return scale * rotationZ * translation;
+
+}
+
+//==============================================================================
+void FillGuard (Mtx44 (&matrices)[s_maxCount + 1]) {
+    memset(static_cast<void *>(matrices), s_guard, sizeof(matrices));
+}
+
+//==============================================================================
+// Nothing past count may be written: the SSE path's tail handles the last
+// partial group of four on its own.
+bool GuardIntact (const Mtx44 * matrices, unsigned count) {
+
+    const unsigned char * bytes = reinterpret_cast<const unsigned char *>(matrices + count);
+    for (unsigned i = 0; i < (s_maxCount + 1 - count) * sizeof(Mtx44); ++i) {
+        if (bytes[i] != s_guard)
+            return false;
+    }
+
+    return true;
+
+}
+
+//==============================================================================
+void TestCount (unsigned count, unsigned seed) {
+
+    float     posX[s_maxCount];
+    float     posY[s_maxCount];
+    float     rotation[s_maxCount];
+    float     scaleX[s_maxCount];
+    float     scaleY[s_maxCount];
+    Transform transforms[s_maxCount];
+
+    const Transform * transformPtrs[s_maxCount];
+    for (unsigned i = 0; i < count; ++i) {
+        posX[i]     = NextFloat(&seed, -5000.0f, 5000.0f);
+        posY[i]     = NextFloat(&seed, -5000.0f, 5000.0f);
+        rotation[i] = NextFloat(&seed, -7.0f, 7.0f);
+        scaleX[i]   = NextFloat(&seed, -3.0f, 3.0f);
+        scaleY[i]   = NextFloat(&seed, 0.1f, 3.0f);
+
+        transforms[i].SetPosition(Vec3(posX[i], posY[i], 0.0f));
+        transforms[i].SetRotation(rotation[i]);
+        transforms[i].SetScale(Vec3(scaleX[i], scaleY[i], 1.0f));
+        transformPtrs[i] = &transforms[i];
+    }
+
+    const Affine2dBatch batch = { posX, posY, rotation, scaleX, scaleY };
+
+    // One spare slot past the largest count holds the guard.
+    Mtx44 simd[s_maxCount + 1];
+    Mtx44 scalar[s_maxCount + 1];
+    Mtx44 fromTransforms[s_maxCount + 1];
+    Mtx44 fromPointers[s_maxCount + 1];
+    FillGuard(simd);
+    FillGuard(scalar);
+    FillGuard(fromTransforms);
+    FillGuard(fromPointers);
+
+    BuildAffine2dMatrices(batch, count, simd);
+    BuildAffine2dMatricesScalar(batch, count, scalar);
+    Transform::BuildWorldFromModelMtxBatch(transforms, count, fromTransforms);
+    Transform::BuildWorldFromModelMtxBatch(transformPtrs, count, fromPointers);
+
+    CHECK(GuardIntact(simd, count));
+    CHECK(GuardIntact(scalar, count));
+    CHECK(GuardIntact(fromTransforms, count));
+    CHECK(GuardIntact(fromPointers, count));
+
+    for (unsigned i = 0; i < count; ++i) {
+        const Mtx44 reference = ReferenceMtx(transforms[i]);
+        CHECK(MatricesNear(simd[i], reference));
+        CHECK(MatricesNear(scalar[i], reference));
+        CHECK(MatricesNear(simd[i], scalar[i]));
+        CHECK(MatricesNear(fromTransforms[i], reference));
+        CHECK(memcmp(&fromTransforms[i], &fromPointers[i], sizeof(Mtx44)) == 0);
+        CHECK(MatricesNear(transforms[i].GetWorldFromModelMtx(), reference));
+    }
+
+}
+
+//==============================================================================
+// Counts either side of the four-wide SSE groups, and a run with a tail.
+void TestMatchesReference () {
+
+    const unsigned counts[] = { 0, 1, 3, 4, 5, 17 };
+    for (unsigned i = 0; i < arrsize(counts); ++i)
+        TestCount(counts[i], 12345u + i);
+
+}
+
+//==============================================================================
+// Batches longer than Transform's gather buffer are built in pieces.
+void TestLongBatch () {
+
+    const unsigned         count = 200;
+    std::vector<Transform> transforms(count);
+    unsigned               seed  = 777u;
+    for (Transform & transform : transforms) {
+        transform.SetPosition(Vec3(NextFloat(&seed, -100.0f, 100.0f), NextFloat(&seed, -100.0f, 100.0f), 0.0f));
+        transform.SetRotation(NextFloat(&seed, -3.2f, 3.2f));
+        transform.SetScale(Vec3(NextFloat(&seed, 0.5f, 2.0f), NextFloat(&seed, 0.5f, 2.0f), 1.0f));
+    }
+
+    std::vector<Mtx44> matrices(count);
+    Transform::BuildWorldFromModelMtxBatch(transforms.data(), count, matrices.data());
+    for (unsigned i = 0; i < count; ++i)
+        CHECK(MatricesNear(matrices[i], ReferenceMtx(transforms[i])));
+
+}
+
+} // namespace
+
+//==============================================================================
+int main () {
+
+    TestMatchesReference();
+    TestLongBatch();
+
+    return TEST_RESULT();
+
+}
@@ -0,0 +1,207 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Christopher Higgins Barrett
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Transform.h"
+#include "TransformBatch.h"
+#include "TransformHierarchy.h"
+#include "Levels/Level.hpp"
+
+#include <cmath>
+
+#include "TestCheck.h"
+#include "TestLevel.h"
+
+namespace {
+
+const char s_levelPath[] = "TransformHierarchyTests.json";
+
+//==============================================================================
+bool MatricesNear (const Mtx44 & a, const Mtx44 & b) {
+
+    const float * fa = reinterpret_cast<const float *>(&a);
+    const float * fb = reinterpret_cast<const float *>(&b);
+    for (unsigned i = 0; i < 16; ++i) {
+        if (fabsf(fa[i] - fb[i]) > 1e-3f * MAX(1.0f, fabsf(fb[i])))
+            return false;
+    }
+
+    return true;
+
+}
+
+//==============================================================================
+Transform MakeTransform (float x, float y, float rotation, float scaleX, float scaleY) {
+
+    Transform transform;
+    transform.SetPosition(Vec3(x, y, 0.0f));
+    transform.SetRotation(rotation);
+    transform.SetScale(Vec3(scaleX, scaleY, 1.0f));
+    return transform;
+
+}
+
+//==============================================================================
+// World matrices are the row-vector products of the locals, child first, and
+// only nodes under a change are rebuilt.
+void TestPropagation () {
+
+    const Transform rootLocal  = MakeTransform(100.0f, 50.0f, 0.5f, 2.0f, 2.0f);
+    const Transform childLocal = MakeTransform(10.0f, 0.0f, -0.25f, 1.0f, 0.5f);
+    const Transform leafLocal  = MakeTransform(0.0f, 8.0f, 1.0f, 1.0f, 1.0f);
+
+    TransformHierarchy               hierarchy;
+    const TransformHierarchy::NodeId root  = hierarchy.CreateNode();
+    const TransformHierarchy::NodeId child = hierarchy.CreateNode(root);
+    const TransformHierarchy::NodeId leaf  = hierarchy.CreateNode(child);
+    const TransformHierarchy::NodeId other = hierarchy.CreateNode();
+    hierarchy.SetLocal(root, rootLocal);
+    hierarchy.SetLocal(child, childLocal);
+    hierarchy.SetLocal(leaf, leafLocal);
+    hierarchy.Update();
+
+    CHECK(hierarchy.GetNodeCount() == 4);
+    CHECK(hierarchy.GetLastUpdatedCount() == 4);
+    CHECK(hierarchy.GetParent(leaf) == child);
+    CHECK(MatricesNear(hierarchy.GetWorldMtx(root), rootLocal.GetWorldFromModelMtx()));
+    CHECK(MatricesNear(hierarchy.GetWorldMtx(child), childLocal.GetWorldFromModelMtx() * rootLocal.GetWorldFromModelMtx()));
+    CHECK(MatricesNear(
+        hierarchy.GetWorldMtx(leaf),
+        leafLocal.GetWorldFromModelMtx() * childLocal.GetWorldFromModelMtx() * rootLocal.GetWorldFromModelMtx()
+    ));
+
+    // Still: nothing rebuilt
+    hierarchy.Update();
+    CHECK(hierarchy.GetLastUpdatedCount() == 0);
+    CHECK(!hierarchy.WorldChanged(root) && !hierarchy.WorldChanged(leaf));
+
+    // Moving the root carries its subtree, and only its subtree.
+    const Transform movedRoot = MakeTransform(-30.0f, 5.0f, 0.5f, 2.0f, 2.0f);
+    hierarchy.SetLocal(root, movedRoot);
+    hierarchy.Update();
+    CHECK(hierarchy.GetLastUpdatedCount() == 3);
+    CHECK(hierarchy.WorldChanged(leaf) && !hierarchy.WorldChanged(other));
+    CHECK(MatricesNear(
+        hierarchy.GetWorldMtx(leaf),
+        leafLocal.GetWorldFromModelMtx() * childLocal.GetWorldFromModelMtx() * movedRoot.GetWorldFromModelMtx()
+    ));
+
+    // Moving a leaf rebuilds just the leaf.
+    hierarchy.SetLocalPosition(leaf, 0.0f, 16.0f);
+    hierarchy.Update();
+    CHECK(hierarchy.GetLastUpdatedCount() == 1);
+    CHECK(hierarchy.WorldChanged(leaf) && !hierarchy.WorldChanged(child));
+
+}
+
+//==============================================================================
+void TestReparentAndDestroy () {
+
+    const Transform offset = MakeTransform(5.0f, 0.0f, 0.0f, 1.0f, 1.0f);
+
+    TransformHierarchy               hierarchy;
+    const TransformHierarchy::NodeId a     = hierarchy.CreateNode();
+    const TransformHierarchy::NodeId b     = hierarchy.CreateNode();
+    const TransformHierarchy::NodeId child = hierarchy.CreateNode(a);
+    const TransformHierarchy::NodeId leaf  = hierarchy.CreateNode(child);
+    hierarchy.SetLocalPosition(a, 100.0f, 0.0f);
+    hierarchy.SetLocalPosition(b, 0.0f, 200.0f);
+    hierarchy.SetLocal(child, offset);
+    hierarchy.Update();
+
+    const float * m = reinterpret_cast<const float *>(&hierarchy.GetWorldMtx(leaf));
+    CHECK(m[12] == 105.0f && m[13] == 0.0f);
+
+    // Reparenting moves the subtree to the new parent on the next Update.
+    hierarchy.SetParent(child, b);
+    hierarchy.Update();
+    CHECK(hierarchy.GetParent(child) == b);
+    m = reinterpret_cast<const float *>(&hierarchy.GetWorldMtx(leaf));
+    CHECK(m[12] == 5.0f && m[13] == 200.0f);
+
+    // Destroying a node takes its descendants; their ids are reused.
+    hierarchy.DestroyNode(child);
+    CHECK(!hierarchy.IsValid(child) && !hierarchy.IsValid(leaf));
+    CHECK(hierarchy.IsValid(a) && hierarchy.IsValid(b));
+    CHECK(hierarchy.GetNodeCount() == 2);
+
+    const TransformHierarchy::NodeId reused = hierarchy.CreateNode(a);
+    CHECK(reused == child || reused == leaf);
+    hierarchy.Update();
+    m = reinterpret_cast<const float *>(&hierarchy.GetWorldMtx(reused));
+    CHECK(m[12] == 100.0f && m[13] == 0.0f);
+
+}
+
+//==============================================================================
+// Level tiles hang off chunk nodes under the level's node: each tile's matrix
+// is its offset applied before the level's, and a still level rebakes nothing.
+void TestLevelTilesFollowLevel () {
+
+    // 40x40 tiles: 2x2 chunks, the last row and column partial
+    const unsigned              size = 40;
+    std::vector<unsigned short> tiles(size * size, 0);
+    Level                       level;
+    CHECK(Test::BuildLevel(s_levelPath, size, size, std::vector<Level::ETileCollision>(1), tiles, &level));
+
+    Transform levelTransform = MakeTransform(64.0f, -32.0f, 0.3f, 1.5f, 1.5f);
+    level.Render(levelTransform);
+
+    const LevelTileBatch & batch = level.GetTileBatch();
+    CHECK(batch.GetLastRebuiltChunkCount() == 4);
+
+    // Tile (35, 33) lives in chunk (1, 1) at offset (3, 1)
+    const LevelTileBatch::Chunk & chunk = batch.GetChunk(1, 1);
+    CHECK(chunk.instances.size() == 8 * 8);
+
+    Mtx44 expected;
+    TranslateAffine2d(35.0f * Test::s_tileSize, 33.0f * Test::s_tileSize, levelTransform.GetWorldFromModelMtx(), &expected);
+    CHECK(chunk.instances.size() > 1 * 8 + 3 && MatricesNear(chunk.instances[1 * 8 + 3].worldFromModelMtx, expected));
+
+    level.Render(levelTransform);
+    CHECK(batch.GetLastRebuiltChunkCount() == 0);
+
+    // Moving the level rebakes every chunk at the new placement.
+    levelTransform.SetPosition(Vec3(-500.0f, 20.0f, 0.0f));
+    level.Render(levelTransform);
+    CHECK(batch.GetLastRebuiltChunkCount() == 4);
+
+    TranslateAffine2d(35.0f * Test::s_tileSize, 33.0f * Test::s_tileSize, levelTransform.GetWorldFromModelMtx(), &expected);
+    CHECK(MatricesNear(batch.GetChunk(1, 1).instances[1 * 8 + 3].worldFromModelMtx, expected));
+
+    Test::RemoveLevel(s_levelPath);
+
+}
+
+} // namespace
+
+//==============================================================================
+int main () {
+
+    TestPropagation();
+    TestReparentAndDestroy();
+    TestLevelTilesFollowLevel();
+
+    return TEST_RESULT();
+
+}
@@ -0,0 +1,238 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Christopher Higgins Barrett
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "GameObject.h"
+#include "GameObjectComponent.h"
+#include "Components/ComponentStore.h"
+#include "Headless/HeadlessAgam.h"
+#include "Levels/Level.hpp"
+#include "Levels/LevelFile.hpp"
+#include "Simulation/GameObjectSimulation.h"
+#include "Simulation/WorldSnapshot.h"
+#include "ScratchComponents.h"
+#include "ActionGameAlgorithmManiaxComponents.h"
+
+#include <cstring>
+#include <memory>
+
+#include "TestCheck.h"
+
+namespace {
+
+const char     s_levelPath[]  = "WorldSnapshotTests.clvl";
+const unsigned s_playerCount  = 64;
+const unsigned s_ringFrames   = 60;
+const unsigned s_frameCount   = 150;
+const unsigned s_rewindFrames = 50;
+
+//==============================================================================
+// Plays pre-generated input, so a rewind can rewind the input too.
+class ScriptedGamepadSource final : public IGamepadSource {
+private: // Data
+    std::vector<GamepadState> m_states;
+    unsigned                  m_frame;
+
+public:
+    ScriptedGamepadSource (std::uint32_t seed, unsigned frameCount) :
+        m_frame(0)
+    {
+        SyntheticGamepadSource synthetic(seed);
+        m_states.resize(frameCount);
+        for (GamepadState & state : m_states)
+            synthetic.NextState(&state);
+    }
+
+    void SetFrame (unsigned frame) { m_frame = frame; }
+
+    bool NextState (GamepadState * stateOut) override {
+        *stateOut = m_frame < m_states.size() ? m_states[m_frame++] : GamepadState();
+        return true;
+    }
+};
+
+//==============================================================================
+// Stamps the tile under its owner every step, alternating legends, so the
+// level's edit log grows every frame.
+class GocTilePainter final : public GameObjectComponent {
+private: // Data
+    Level *       m_level;
+    std::uint32_t m_strokes;
+
+public:
+    explicit GocTilePainter (Level * level) :
+        GameObjectComponent(0xFFFF, 3),
+        m_level(level),
+        m_strokes(0)
+    {}
+
+    void Update (float dt) override {
+        ref(dt);
+        const Vec3     pos = m_owner->GetTransform().GetPosition();
+        const unsigned x   = unsigned(int(pos.x) / 16 % int(m_level->GetWidth()) + int(m_level->GetWidth())) % m_level->GetWidth();
+        const unsigned y   = m_strokes % m_level->GetHeight();
+        m_level->SetTile(x, y, ++m_strokes & 1);
+    }
+
+    unsigned GetStateSize () const override         { return sizeof(m_strokes); }
+    void     SaveState (void * state) const override { memcpy(state, &m_strokes, sizeof(m_strokes)); }
+    void     LoadState (const void * state) override { memcpy(&m_strokes, state, sizeof(m_strokes)); }
+};
+
+//==============================================================================
+// Legend entries without a sprite file load no graphics, so the level builds
+// headless.
+bool BuildLevel (Level * levelOut) {
+
+    Level::Desc desc;
+    desc.name   = L"test";
+    desc.width  = 40;
+    desc.height = 3;
+    desc.legend.resize(2);
+
+    const std::vector<unsigned short> tiles(desc.width * desc.height, 0);
+    return LevelFile::Write(s_levelPath, desc, tiles, 0) && levelOut->BuildFromCookedFile(s_levelPath);
+
+}
+
+//==============================================================================
+unsigned HashWorld (const WorldSnapshot & snapshot, const Level & level) {
+
+    unsigned hash = Core::Fnv1aHash64(snapshot.GetWords(), snapshot.GetByteSize()) & 0xFFFFFFFF;
+    for (unsigned y = 0; y < level.GetHeight(); ++y) {
+        for (unsigned x = 0; x < level.GetWidth(); ++x)
+            hash = (hash ^ level.GetTileLegendIndex(x, y)) * 16777619u;
+    }
+
+    return hash;
+
+}
+
+//==============================================================================
+// Runs AGAM players that paint the level, rewinds s_rewindFrames through the
+// ring and resimulates; every resimulated frame must match the original.
+void TestRewindAndResimulate () {
+
+    Spritesheet sheet;
+    BuildAgamSheet(&sheet);
+
+    Level level;
+    CHECK(BuildLevel(&level));
+
+    std::vector<std::unique_ptr<ScriptedGamepadSource>> sources;
+    std::vector<GameObject>                             objects(s_playerCount);
+    std::vector<GameObject *>                           objectPtrs;
+    ComponentStore                                      store;
+    GameObjectSimulation                                simulation;
+
+    RegisterAgamPools(&store);
+    store.RegisterPool<GocTilePainter>();
+    simulation.SetComponentStore(&store);
+
+    for (unsigned i = 0; i < s_playerCount; ++i) {
+        sources.emplace_back(new ScriptedGamepadSource(i + 1, s_frameCount));
+        CreateAgamPlayer(&store, &objects[i], &sheet, sources.back().get());
+        store.Create<GocTilePainter>(&objects[i], &level);
+
+        objects[i].GetTransform().SetPosition(Vec3(float(i * 10), float(i % 5) * 16.0f, 0.0f));
+        objectPtrs.push_back(&objects[i]);
+    }
+
+    const float           dt = 1.0f / float(GocAgamBody::s_tickRate);
+    SnapshotRing          ring(s_ringFrames);
+    WorldSnapshot         snapshot;
+    WorldSnapshot         firstFrame;
+    std::vector<unsigned> hashes(s_frameCount + 1);
+    std::vector<unsigned> editSequences(s_frameCount + 1);
+    for (unsigned frame = 1; frame <= s_frameCount; ++frame) {
+        simulation.Step(dt);
+        snapshot.Capture(objectPtrs.data(), s_playerCount, &level);
+        ring.Push(snapshot, frame, &level);
+        if (frame == 1)
+            firstFrame.CopyFrom(snapshot);
+        hashes[frame]        = HashWorld(snapshot, level);
+        editSequences[frame] = level.GetEditSequence();
+    }
+
+    // The level only keeps the edits the ring's frames can revert.
+    CHECK(ring.GetFrameCount() == s_ringFrames);
+    CHECK(ring.GetOldestFrame() == s_frameCount - s_ringFrames + 1);
+    CHECK(level.GetOldestEditSequence() == editSequences[ring.GetOldestFrame()]);
+    CHECK(level.GetOldestEditSequence() > 0);
+    CHECK(!firstFrame.Restore(objectPtrs.data(), s_playerCount, &level));
+
+    const unsigned rewindFrame = s_frameCount - s_rewindFrames;
+    CHECK(ring.Rewind(rewindFrame, &snapshot));
+    CHECK(snapshot.Restore(objectPtrs.data(), s_playerCount, &level));
+    CHECK(level.GetEditSequence() == editSequences[rewindFrame]);
+    CHECK(HashWorld(snapshot, level) == hashes[rewindFrame]);
+
+    for (auto & source : sources)
+        source->SetFrame(rewindFrame);
+
+    for (unsigned frame = rewindFrame + 1; frame <= s_frameCount; ++frame) {
+        simulation.Step(dt);
+        snapshot.Capture(objectPtrs.data(), s_playerCount, &level);
+        ring.Push(snapshot, frame, &level);
+        CHECK(HashWorld(snapshot, level) == hashes[frame]);
+    }
+
+    CHECK(ring.GetNewestFrame() == s_frameCount);
+
+}
+
+//==============================================================================
+void TestSnapshotsWithoutLevelKeepEdits () {
+
+    Level level;
+    CHECK(BuildLevel(&level));
+    level.SetTile(0, 0, 1);
+    level.SetTile(1, 0, 1);
+
+    GameObject    object;
+    GameObject *  objects[] = { &object };
+    WorldSnapshot snapshot;
+    SnapshotRing  ring(2);
+    for (unsigned frame = 0; frame < 4; ++frame) {
+        snapshot.Capture(objects, 1, nullptr);
+        ring.Push(snapshot, frame, &level);
+    }
+
+    CHECK(level.GetOldestEditSequence() == 0);
+    CHECK(level.GetEditSequence() == 2);
+
+}
+
+} // namespace
+
+//==============================================================================
+int main () {
+
+    TestRewindAndResimulate();
+    TestSnapshotsWithoutLevelKeepEdits();
+
+    remove(s_levelPath);
+
+    return TEST_RESULT();
+
+}